@@ -29,14 +29,15 @@
 #include <boost/asio/buffer.hpp> // boost::asio::const_buffer
 #include <boost/asio/read_until.hpp> // boost::asio::async_read_until
 #include <boost/asio/streambuf.hpp> // boost::asio::streambuf::const_buffers_type
+#include <boost/asio/completion_condition.hpp> // boost::asio::transfer_exactly
+#include <boost/asio/buffers_iterator.hpp> // boost::asio::buffers_begin
 #include <boost/system/error_code.hpp> // boost::system::error_code
 #include <boost/system/system_error.hpp> // boost::system::system_error
 #include <boost/tuple/tuple.hpp> // boost::tuple, boost::tie, boost::tuples::ignore
 #include <boost/logic/tribool.hpp> // boost::tribool
 
 /* My Unicode utilities library */
-#include "vuu/UTF8Validator.hpp" // vuu::UTF8Validator, to ensure that an std::string is valid UTF-8 text
-#include "vuu/CodepointFinder.hpp" // vuu::CodepointFinder, to find a list of code-points in the UTF-8 string
+#include "vuu/Codepoints.hpp" // vuu::countCodepoints, to ensure that an std::string is valid UTF-8 text, and vuu::Codepoints, to walk through its code-points without copying them
 #include "vuu/CodepointsInRange.hpp" // vuu::CodepointsInRange, to determine whether all code-points in the list are in the valid range for Malayalam
 
 /* MPP library */
@@ -75,6 +76,7 @@ ioc (), // Use io_context's default ctor
 signals (ioc, SIGHUP, SIGINT, SIGQUIT), // Construct signal set using io_context, and add 3 signals (the max)
 resolver(ioc), // Construct the TCP/IP resolver we'll use
 sock (ioc), // Construct the socket we'll use
+reusedSock(false),
 sigMsgs { // Construct the map of signal values to strings
 	{SIGHUP, "SIGHUP"},
 	{SIGINT, "SIGINT"},
@@ -310,7 +312,8 @@ std::string Client::getInput() const
 **/
 bool Client::isInputValidUTF8() const
 {
-	return std::all_of(input.cbegin(), input.cend(), vuu::UTF8Validator());
+	std::size_t nCodepoints;
+	return vuu::countCodepoints(input.data(), input.size(), nCodepoints);
 }
 
 /**
@@ -319,8 +322,8 @@ bool Client::isInputValidUTF8() const
 **/
 bool Client::isInputValidMalayalam() const
 {
-	vuu::CodepointFinder vcf = std::for_each(input.cbegin(), input.cend(), vuu::CodepointFinder()); // Find a list of code-points in the string
-	return std::all_of(vcf.cbegin(), vcf.cend(), vuu::CodepointsInRange(0x0D00, 0x0D7F)); // Ensure that all code-points are in the valid range for Malayalam
+	vuu::Codepoints cps(input.data(), input.size()); // Decodes each code-point as all_of reaches it
+	return std::all_of(cps.begin(), cps.end(), vuu::CodepointsInRange(0x0D00, 0x0D7F)); // Ensure that all code-points are in the valid range for Malayalam
 }
 
 /**
@@ -346,32 +349,7 @@ void Client::isSingular(std::function<void(bool, std::string)> issingCallback)
 	}
 	#endif
 
-	boost::asio::async_connect(sock, resolveResults, [this](const boost::system::error_code& acErr, const boost::asio::ip::tcp::endpoint& ep)
-		{
-			if (!acErr) // No error
-			{
-				#ifdef DEBUG
-				std::cout << "Client::isSingular::lambda async_connect succeeded." << std::endl
-				<< "\tEndpoint address: " << ep.address().to_string() << std::endl
-				<< "\tEndpoint capacity: " << ep.capacity() << std::endl
-				<< "\tEndpoint port: " << ep.port() << std::endl
-				<< "\tEndpoint size: " << ep.size() << std::endl;
-				#endif
-				sendSingReq(); // Send the ISSING request to the server
-			}
-
-			else // Error occurred
-			{
-				std::cerr << "Client::isSingular::async_connect lambda: a system error occurred" << std::endl
-				<< "\tValue = " << acErr.value() << std::endl
-				<< "\tMessage = " << std::quoted(acErr.message()) << std::endl
-				<< "\tThe operation " << (acErr.failed() ? "failed" : "didn't fail") << std::endl
-				<< "\tAddress: " << ep.address().to_string() << std::endl
-				<< "\tCapacity: " << ep.capacity() << std::endl
-				<< "\tPort: " << ep.port() << std::endl;
-			}
-		}
-	);
+	sendOnSocket([this]() { sendSingReq(); }); // Send the ISSING request to the server
 
 	#ifdef DEBUG
 	std::cout << "Client::isSingular ending" << std::endl;
@@ -417,6 +395,84 @@ Client::~Client()
 	#endif
 }
 
+/**
+* @desc Sends a request over our socket. The socket is kept open between requests, so this only connects to the server if it isn't already connected.
+* @param sendReq Sends the request once the socket is connected.
+**/
+void Client::sendOnSocket(std::function<void()> sendReq)
+{
+	reusedSock = sock.is_open();
+
+	if (reusedSock) // Still connected from the last request
+	{
+		#ifdef DEBUG
+		std::cout << "Client::sendOnSocket: reusing the open connection." << std::endl;
+		#endif
+		sendReq();
+		return;
+	}
+
+	boost::asio::async_connect(sock, resolveResults, [this, sendReq](const boost::system::error_code& acErr, const boost::asio::ip::tcp::endpoint& ep)
+		{
+			if (!acErr) // No error
+			{
+				#ifdef DEBUG
+				std::cout << "Client::sendOnSocket::lambda async_connect succeeded." << std::endl
+				<< "\tEndpoint address: " << ep.address().to_string() << std::endl
+				<< "\tEndpoint capacity: " << ep.capacity() << std::endl
+				<< "\tEndpoint port: " << ep.port() << std::endl
+				<< "\tEndpoint size: " << ep.size() << std::endl;
+				#endif
+				sendReq();
+			}
+
+			else // Error occurred
+			{
+				std::cerr << "Client::sendOnSocket::async_connect lambda: a system error occurred" << std::endl
+				<< "\tValue = " << acErr.value() << std::endl
+				<< "\tMessage = " << std::quoted(acErr.message()) << std::endl
+				<< "\tThe operation " << (acErr.failed() ? "failed" : "didn't fail") << std::endl
+				<< "\tAddress: " << ep.address().to_string() << std::endl
+				<< "\tCapacity: " << ep.capacity() << std::endl
+				<< "\tPort: " << ep.port() << std::endl;
+			}
+		}
+	);
+}
+
+/**
+* @desc Starts the current request again on a new connection, if it failed on one that was reused. The server may have closed the connection while it was idle.
+* @return True if the request was restarted, false if it had already been sent on a new connection.
+**/
+bool Client::retryOnNewSocket()
+{
+	if (!reusedSock)
+	{
+		return false;
+	}
+
+	#ifdef DEBUG
+	std::cout << "Client::retryOnNewSocket: the server closed the reused connection. Reconnecting." << std::endl;
+	#endif
+
+	resetVars(true);
+	sendOnSocket([this]()
+		{
+			if (curReq.GETCOM_FUNC() == mpp::Request::FOF)
+			{
+				sendFofReq();
+			}
+
+			else
+			{
+				sendSingReq();
+			}
+		}
+	);
+
+	return true;
+}
+
 /**
 * @desc A callback that handles a successful connection to the server for an ISSING request by sending that request.
 **/
@@ -476,15 +532,15 @@ void Client::sendSingReq()
 				else
 				{
 					#ifdef DEBUG
-					std::cout << "Client::sendSingReq::lambda: calling readSingRepStatus" << std::endl;
+					std::cout << "Client::sendSingReq::lambda: calling readRepStatus" << std::endl;
 					#endif
 
 					/* We pass the command because each type of request elicits different possible responses */
-					readSingRepStatus();
+					readRepStatus();
 				}
 			}
 
-			else // An error occurred
+			else if (!retryOnNewSocket()) // An error occurred, and it wasn't because the server closed an idle connection
 			{
 				std::cerr << "Client::sendSingReq::lambda: an error occurred while sending the request to the server." << std::endl
 				<< "\tError value = " << ec.value() << std::endl
@@ -496,13 +552,13 @@ void Client::sendSingReq()
 }
 
 /**
-* @desc Called after the ISSING request has been sent.
+* @desc Called after an ISSING or FOF request has been sent.
 *	It reads the status line, and then decides how to proceed.
 **/
-void Client::readSingRepStatus()
+void Client::readRepStatus()
 {
 	#ifdef DEBUG
-	std::cout << "Client::readSingRepStatus running." << std::endl;
+	std::cout << "Client::readRepStatus running." << std::endl;
 	#endif
 	boost::asio::async_read_until(sock, repBuf, "\r\n", [this](const boost::system::error_code& ec, std::size_t bytesTrans)
 		{
@@ -519,7 +575,7 @@ void Client::readSingRepStatus()
 				{
 					const char* curBufDat = static_cast<const char*>(buf.data()); // Fetch the data as a C string
 					#ifdef DEBUG
-					std::cout << "Client::readSingRepStatus::lambda: # of bytes inserted @ beginning of for = " << bytesInserted << std::endl
+					std::cout << "Client::readRepStatus::lambda: # of bytes inserted @ beginning of for = " << bytesInserted << std::endl
 					<< "\tCurrent buffer's contents are: \"";
 					#endif
 					std::size_t curBufSiz = buf.size();
@@ -545,7 +601,7 @@ void Client::readSingRepStatus()
 
 					#ifdef DEBUG
 					std::cout << "\"" << std::endl
-					<< "Client::readSingRepStatus::lambda: no error: buf-reading for loop: # of bytes inserted = " << bytesInserted << std::endl;
+					<< "Client::readRepStatus::lambda: no error: buf-reading for loop: # of bytes inserted = " << bytesInserted << std::endl;
 					++bufNum;
 					#endif
 				}
@@ -553,46 +609,52 @@ void Client::readSingRepStatus()
 				std::string data = dataSS.str();
 
 				#ifdef DEBUG
-				std::cout << "Client::readSingRepStatus::lambda: successfully read " << bytesTrans << " bytes of data" << std::endl
+				std::cout << "Client::readRepStatus::lambda: successfully read " << bytesTrans << " bytes of data" << std::endl
 				<< "dataSS contents = " << std::quoted(dataSS.str()) << std::endl;
 				#endif
 	
 				/* Parse the status line */
 				boost::tribool parseRes;
 				repParser.reset(); // Start the parser in its initial state
+				rep.clearHeaders(); // Forget the last reply on this connection
+				rep.setContent("");
 				#ifdef DEBUG
-				std::cout << "Client::readSingRepStatus::lambda: data to parse: " << data << std::endl;
+				std::cout << "Client::readRepStatus::lambda: data to parse: " << data << std::endl;
 				#endif
 				boost::tie(parseRes, boost::tuples::ignore) = repParser.parse(rep, data.cbegin(), data.cend()); // Parse the data in the buffer, but only up to the number of bytes transferred
 
 				if (parseRes) // Entire request parsed - how?!
 				{
 					#ifdef DEBUG
-					std::cout << "Client::readSingRepStatus::lambda: reply parser claims to have parsed an entire response! How?!" << std::endl;
+					std::cout << "Client::readRepStatus::lambda: reply parser claims to have parsed an entire response! How?!" << std::endl;
 					#endif
 				}
 
 				else if (!parseRes) // Invalid status line - possible
 				{
-					std::cerr << "Client::readSingRepStatus::lambda: invalid status line found!" << std::endl;
+					std::cerr << "Client::readRepStatus::lambda: invalid status line found!" << std::endl;
 
 					#ifdef DEBUG
 					mpp::RepParser::State parserStat = repParser.getState(); // To find out where the error occurred
 					std::cerr << "\tStatus: " << repParser.getStateName(parserStat) << std::endl;
 					#endif
+					resetVars(true); // We can't tell where the rest of the reply ends, so don't reuse the connection
 				}
 
 				else // Indeterminate - what should happen
 				{
 					#ifdef DEBUG
-					std::cout << "Client::readSingRepStatus::lambda: need to read more data to finish parsing the reply, as expected" << std::endl;
+					std::cout << "Client::readRepStatus::lambda: need to read more data to finish parsing the reply, as expected" << std::endl;
 					#endif
 
 					mpp::Reply::Status repStat = rep.getStatus(); // Check the parsed status
 
-					if (repStat != mpp::Reply::singular && repStat != mpp::Reply::plural) // Not a valid response to an ISSING request
+					bool isFof = (curReq.GETCOM_FUNC() == mpp::Request::FOF);
+
+					if (isFof ? (repStat < mpp::Reply::pluralForm || repStat > mpp::Reply::noSingular) : (repStat != mpp::Reply::singular && repStat != mpp::Reply::plural)) // Not a valid response to the request
 					{
-						std::cerr << "Client::readSingRepStatus::lambda: error: response is not for an ISSING request." << std::endl;
+						std::cerr << "Client::readRepStatus::lambda: error: response is not for " << (isFof ? "a FOF" : "an ISSING") << " request." << std::endl;
+						resetVars(true); // The rest of the reply hasn't been read, so the connection can't be reused
 						handleReply(); // Cleanup
 					}
 
@@ -606,9 +668,9 @@ void Client::readSingRepStatus()
 				}
 			}
 
-			else // An error occurred
+			else if (!retryOnNewSocket()) // An error occurred, and it wasn't because the server closed an idle connection
 			{
-				std::cerr << "Client::readSingRepStatus::lambda: an error occurred while reading the server's response." << std::endl
+				std::cerr << "Client::readRepStatus::lambda: an error occurred while reading the server's response." << std::endl
 				<< "\tError value = " << ec.value() << std::endl
 				<< "\tError message = " << std::quoted(ec.message()) << std::endl
 				<< "\tThe operation " << (ec.failed() ? "failed" : "didn't fail") << std::endl;
@@ -616,7 +678,7 @@ void Client::readSingRepStatus()
 		}
 	);
 	#ifdef DEBUG
-	std::cout << "Client::readSingRepStatus finished." << std::endl;
+	std::cout << "Client::readRepStatus finished." << std::endl;
 	#endif
 }
 
@@ -670,7 +732,7 @@ void Client::readHeader()
 
 					#ifdef DEBUG
 					std::cout << "\"" << std::endl
-					<< "Client::readSingRepStatus::lambda: no error: buf-reading for loop: # of bytes inserted = " << bytesInserted << std::endl;
+					<< "Client::readRepStatus::lambda: no error: buf-reading for loop: # of bytes inserted = " << bytesInserted << std::endl;
 					++bufNum;
 					#endif
 				}
@@ -683,8 +745,9 @@ void Client::readHeader()
 
 				if (data == "\r\n") // No more headers, only content
 				{
-					std::cout << "Client::readHeader: found '\\r\\n' while parsing headers, handling reply." << std::endl;
-					handleReply();
+					std::cout << "Client::readHeader: found '\\r\\n' while parsing headers, reading content." << std::endl;
+					repBuf.consume(bytesTrans);
+					readContent();
 				}
 
 				else
@@ -739,14 +802,62 @@ void Client::readHeader()
 	#endif
 }
 
+/**
+* @desc Reads the reply's content, whose length is given by its Content-Length header, and then handles the reply.
+**/
+void Client::readContent()
+{
+	std::size_t len = rep.getContentLength();
+
+	if (repBuf.size() >= len) // Already read along with the headers
+	{
+		storeContent(len);
+	}
+
+	else
+	{
+		boost::asio::async_read(sock, repBuf, boost::asio::transfer_exactly(len - repBuf.size()), [this, len](const boost::system::error_code& ec, std::size_t bytesTrans)
+			{
+				if (!ec) // No error
+				{
+					#ifdef DEBUG
+					std::cout << "Client::readContent::lambda: read " << bytesTrans << " bytes of content" << std::endl;
+					#endif
+					storeContent(len);
+				}
+
+				else // An error occurred
+				{
+					std::cerr << "Client::readContent::lambda: an error occurred while reading the server's response." << std::endl
+					<< "\tError value = " << ec.value() << std::endl
+					<< "\tError message = " << std::quoted(ec.message()) << std::endl
+					<< "\tThe operation " << (ec.failed() ? "failed" : "didn't fail") << std::endl;
+					resetVars(true);
+				}
+			}
+		);
+	}
+}
+
+/**
+* @desc Moves the content out of the reply buffer and into the reply, and then handles the reply.
+* @param len The content's length in bytes. The reply buffer must hold at least this many.
+**/
+void Client::storeContent(std::size_t len)
+{
+	typename boost::asio::streambuf::const_buffers_type datBufs = repBuf.data();
+	rep.setContent(std::string(boost::asio::buffers_begin(datBufs), boost::asio::buffers_begin(datBufs) + len));
+	repBuf.consume(len); // Leave nothing behind for the next reply on this connection
+	handleReply();
+}
+
 /**
 * Handles the reply from the server.
 **/
 void Client::handleReply()
 {
-	resetVars(); // For the next chain of sends/receives
-
 	mpp::Reply::Status repStat = rep.getStatus();
+	resetVars(repStat >= mpp::Reply::badReq || repStat == mpp::Reply::invalid); // For the next chain of sends/receives. The server closes the connection after an error, so we do too.
 
 	switch (repStat)
 	{
@@ -763,6 +874,26 @@ void Client::handleReply()
 			break;
 		}
 
+		/* Reply to a FOF request */
+		case mpp::Reply::pluralForm:
+		case mpp::Reply::singularForm:
+		{
+			fofCB(rep.getContent());
+			break;
+		}
+
+		case mpp::Reply::noPlural:
+		{
+			std::cout << "The noun " << std::quoted(input) << " has no plural form." << std::endl;
+			break;
+		}
+
+		case mpp::Reply::noSingular:
+		{
+			std::cout << "The noun " << std::quoted(input) << " has no singular form." << std::endl;
+			break;
+		}
+
 		/* Handle client errors */
 		case mpp::Reply::badReq:
 		{
@@ -851,32 +982,7 @@ void Client::findOppositeForm(std::function<void(std::string)> fofCallback)
 	}
 	#endif
 
-	boost::asio::async_connect(sock, resolveResults, [this](const boost::system::error_code& acErr, const boost::asio::ip::tcp::endpoint& ep)
-		{
-			if (!acErr) // No error
-			{
-				#ifdef DEBUG
-				std::cout << "Client::findOppositeForm::lambda async_connect succeeded." << std::endl
-				<< "\tEndpoint address: " << ep.address().to_string() << std::endl
-				<< "\tEndpoint capacity: " << ep.capacity() << std::endl
-				<< "\tEndpoint port: " << ep.port() << std::endl
-				<< "\tEndpoint size: " << ep.size() << std::endl;
-				#endif
-				sendFofReq(); // Send the FOF request to the server
-			}
-
-			else // Error occurred
-			{
-				std::cerr << "Client::findOppositeForm::async_connect lambda: a system error occurred" << std::endl
-				<< "\tValue = " << acErr.value() << std::endl
-				<< "\tMessage = " << std::quoted(acErr.message()) << std::endl
-				<< "\tThe operation " << (acErr.failed() ? "failed" : "didn't fail") << std::endl
-				<< "\tAddress: " << ep.address().to_string() << std::endl
-				<< "\tCapacity: " << ep.capacity() << std::endl
-				<< "\tPort: " << ep.port() << std::endl;
-			}
-		}
-	);
+	sendOnSocket([this]() { sendFofReq(); }); // Send the FOF request to the server
 
 	#ifdef DEBUG
 	std::cout << "Client::findOppositeForm ending" << std::endl;
@@ -944,10 +1050,11 @@ void Client::sendFofReq()
 					#ifdef DEBUG
 					std::cout << "Client::sendFofReq::lambda: sent request." << std::endl;
 					#endif
+					readRepStatus(); // The reply must be read in full, or the next request on this socket would read it instead of its own
 				}
 			}
 
-			else // An error occurred
+			else if (!retryOnNewSocket()) // An error occurred, and it wasn't because the server closed an idle connection
 			{
 				std::cerr << "Client::sendFofReq::lambda: an error occurred while sending the request to the server." << std::endl
 				<< "\tError value = " << ec.value() << std::endl
@@ -959,19 +1066,16 @@ void Client::sendFofReq()
 }
 
 /**
-* @desc Resets our socket and reply buffer. Called at the end of each request and on destruction.
+* @desc Resets our reply buffer, and our socket if asked to. Called at the end of each request.
+* @param closeSock Whether or not to close the socket. It's left open otherwise, so that the next request can reuse the connection.
 **/
-void Client::resetVars()
+void Client::resetVars(bool closeSock)
 {
-	try
-	{
-		sock.close(); // Close the socket
-		sock.shutdown(boost::asio::ip::tcp::socket::shutdown_both); // Shutdown any pending sends or receives
-	}
-
-	catch (boost::system::system_error& bsse) // Error while resetting socket
+	if (closeSock && sock.is_open())
 	{
-		std::cerr << "Error while resetting socket: " << bsse.what()  << std::endl;
+		boost::system::error_code ignoredEc; // The server may already have closed its end
+		sock.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignoredEc); // Shutdown any pending sends or receives
+		sock.close(ignoredEc); // Close the socket
 	}
 
        	repBuf.consume(repBuf.size()); // Clear all data read from the previous response. Doesn't throw, according to docs.
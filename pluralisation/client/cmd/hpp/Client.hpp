@@ -126,6 +126,18 @@ class Client
 		**/
 		std::string toLower(const std::string toChange) const;
 
+		/**
+		* @desc Sends a request over our socket. The socket is kept open between requests, so this only connects to the server if it isn't already connected.
+		* @param sendReq Sends the request once the socket is connected.
+		**/
+		void sendOnSocket(std::function<void()> sendReq);
+
+		/**
+		* @desc Starts the current request again on a new connection, if it failed on one that was reused. The server may have closed the connection while it was idle.
+		* @return True if the request was restarted, false if it had already been sent on a new connection.
+		**/
+		bool retryOnNewSocket();
+
 		/**
 		* @desc A callback that handles a successful connection to the server.
 		*	As its name implies, it sends the ISSING request to the server.
@@ -133,16 +145,27 @@ class Client
 		void sendSingReq();
 
 		/**
-		* @desc Called after the ISSING request has been sent.
+		* @desc Called after an ISSING or FOF request has been sent.
 		*	It reads the status line, and then decides how to proceed.
 		**/
-		void readSingRepStatus();
+		void readRepStatus();
 
 		/**
 		* @desc Reads a header from the socket and stores it in the reply.
 		**/
 		void readHeader();
 
+		/**
+		* @desc Reads the reply's content, whose length is given by its Content-Length header, and then handles the reply.
+		**/
+		void readContent();
+
+		/**
+		* @desc Moves the content out of the reply buffer and into the reply, and then handles the reply.
+		* @param len The content's length in bytes. The reply buffer must hold at least this many.
+		**/
+		void storeContent(std::size_t len);
+
 		/**
 		* Handles the reply from the server.
 		**/
@@ -154,9 +177,10 @@ class Client
 		void sendFofReq();
 
 		/**
-		* @desc Resets our socket and reply buffer. Called at the end of each request and on destruction.
+		* @desc Resets our reply buffer, and our socket if asked to. Called at the end of each request.
+		* @param closeSock Whether or not to close the socket. It's left open otherwise, so that the next request can reuse the connection.
 		**/
-		void resetVars();
+		void resetVars(bool closeSock);
 
 		/*** Properties ***/
 
@@ -165,7 +189,8 @@ class Client
 		boost::asio::io_context ioc; // Needed by Boost.Asio to talk to the OS
 		boost::asio::signal_set signals; // Used to catch signals that indicate that we should quit.
 		boost::asio::ip::tcp::resolver resolver; // Used to resolve the server's address
-		boost::asio::ip::tcp::socket sock; // The socket which we'll use to communicate
+		boost::asio::ip::tcp::socket sock; // The socket which we'll use to communicate. Kept open between requests, since the server keeps connections alive.
+		bool reusedSock; // Whether or not the current request was sent on a connection that an earlier request opened
 		std::unique_ptr<THREAD_CLASS> workerThread; // The thread which keeps our I/O context running
 		std::map<int, std::string> sigMsgs; // Stores messages to be printed upon catching a particular signal
 		typename boost::asio::ip::tcp::resolver::results_type resolveResults; // Stores the results of the async_resolve operation
@@ -0,0 +1,120 @@
+/* STL */
+#include <iostream> // std::cout, std::cerr
+#include <string> // std::string
+#include <exception> // std::exception
+
+/* Boost */
+#include <boost/program_options/options_description.hpp> // boost::program_options::options_description
+#include <boost/program_options/positional_options.hpp> // boost::program_options::positional_options_description
+#include <boost/program_options/value_semantic.hpp> // boost::program_options::value
+#include <boost/program_options/variables_map.hpp> // boost::program_options::variables_map, boost::program_options::store
+#include <boost/program_options/parsers.hpp> // boost::program_options::command_line_parser
+#include <boost/filesystem/path.hpp> // boost::filesystem::path
+
+/* Our headers */
+#include "bosmacros/filesystem.hpp" // FILESYSTEM_PATH macro
+#include "mpp/data/DBInfo.hpp" // Needed to read the noun tables
+#include "mpp/data/Lexicon.hpp" // What we compile
+
+enum ExitCode
+{
+	NORMAL = 0,
+	HELP,
+	INVALID_OPTION_VALUE,
+	UNKNOWN_OPTION,
+	AMBIG_OPT,
+	NO_OUTPUT,
+	COMPILE_FAILED,
+	VERIFY_FAILED
+};
+
+/**
+* Reads the noun tables from the DB and writes them to a lexicon file, which mpp-server can map with --lexiconfile.
+**/
+int main(int argc, char* argv[])
+{
+	/* Initial setup */
+	boost::filesystem::path ourPath(argv[0]); // Convert program name to a path
+	std::string ourName = ourPath.filename().string(); // Fetch our name
+
+	/* Option handling */
+	boost::program_options::options_description opts("Options");
+	boost::program_options::positional_options_description posOpts;
+	boost::program_options::variables_map vm;
+	std::string dbConfigFilePath;
+	std::string outPath; // Where to write the lexicon
+
+	opts.add_options()
+		("help,h", "Print this help message")
+		("dbconfigfilepath,d", boost::program_options::value<std::string>(&dbConfigFilePath)->default_value("/home/victor/info/pluraliser.dbinfo"), "The path to the file containing DB config info")
+		("output,o", boost::program_options::value<std::string>(&outPath), "The lexicon file to write. Replaced atomically if it already exists.");
+	posOpts.add("output", 1);
+
+	try
+	{
+		boost::program_options::store(
+			boost::program_options::command_line_parser(argc, argv).options(opts).positional(posOpts).run(),
+			vm
+		);
+		boost::program_options::notify(vm);
+	}
+
+	catch (boost::program_options::invalid_option_value& bpoiov)
+	{
+		std::cerr << ourName << ": invalid value given for option: " << bpoiov.what() << std::endl;
+		return INVALID_OPTION_VALUE;
+	}
+
+	catch (boost::program_options::unknown_option& bpouo)
+	{
+		std::cerr << ourName << ": received unknown option: " << bpouo.what() << std::endl;
+		return UNKNOWN_OPTION;
+	}
+
+	catch (boost::program_options::ambiguous_option& bpoao)
+	{
+		std::cerr << ourName << ": ambiguous option argument: " << bpoao.what() << std::endl;
+		return AMBIG_OPT;
+	}
+
+	if (vm.count("help"))
+	{
+		std::cout << "Usage: " << ourName << " [options] <output file>" << std::endl
+		<< std::endl
+		<< opts;
+		return HELP;
+	}
+
+	if (outPath.empty())
+	{
+		std::cerr << ourName << ": no output file given. Run " << ourName << " --help for usage." << std::endl;
+		return NO_OUTPUT;
+	}
+
+	try
+	{
+		mpp::data::Lexicon lex {mpp::data::DBInfo(dbConfigFilePath)};
+		lex.save(FILESYSTEM_PATH(outPath));
+		std::cout << ourName << ": wrote " << lex.size() << " nouns to " << outPath << std::endl;
+	}
+
+	catch (std::exception& e)
+	{
+		std::cerr << ourName << ": couldn't compile the lexicon: " << e.what() << std::endl;
+		return COMPILE_FAILED;
+	}
+
+	try // Map the file back, exactly as the server will, so that a bad file is caught here rather than at startup
+	{
+		mpp::data::Lexicon mapped {FILESYSTEM_PATH(outPath)};
+		std::cout << ourName << ": verified " << mapped.size() << " nouns in " << outPath << std::endl;
+	}
+
+	catch (std::exception& e)
+	{
+		std::cerr << ourName << ": the lexicon file doesn't verify: " << e.what() << std::endl;
+		return VERIFY_FAILED;
+	}
+
+	return NORMAL;
+}
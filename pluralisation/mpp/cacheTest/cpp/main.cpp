@@ -0,0 +1,106 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <cstdlib> // EXIT_SUCCESS, EXIT_FAILURE
+
+/* Standard C++ */
+#include <iostream> // std::cout
+#include <string> // std::string, std::to_string
+
+/* Our headers */
+#include "mpp/Request.hpp" // mpp::Request::Command
+#include "mpp/ReplyCache.hpp" // The cache under test
+#include "mpp/MalNoun.hpp" // The compact nouns that Connection looks replies up by
+
+#define CAPACITY 1000 // # of replies that the cache holds
+#define NHOT 500 // # of nouns that are asked for over and over
+#define NCOLD 20000 // # of nouns in the scan, each asked for once
+
+/**
+* @desc Asks the cache for a noun's reply, and stores a made-up one if it isn't there, as Connection does.
+* @param cache The cache.
+* @param noun The noun.
+* @param nWrong Incremented if the cache returns a reply for a different noun.
+* @return True if the reply was cached.
+**/
+bool lookup(mpp::ReplyCache& cache, const std::string& noun, std::size_t& nWrong)
+{
+	std::string reply = "reply to " + noun;
+	const std::string* cached = cache.find(mpp::Request::FOF, noun);
+
+	if (cached)
+	{
+		if (*cached != reply)
+		{
+			++nWrong;
+		}
+
+		return true;
+	}
+
+	cache.insert(mpp::Request::FOF, noun, reply, cache.getGeneration());
+	return false;
+}
+
+int main()
+{
+	mpp::ReplyCache cache(CAPACITY);
+	std::size_t nWrong = 0; // # of replies that belonged to another noun
+	std::size_t nOver = 0; // # of times that the cache held more than its capacity
+	std::size_t nFinds = 0; // # of lookups
+
+	/* Warm up: the hot nouns are asked for several times each */
+	for (std::size_t round = 0; round < 5; round++)
+	{
+		for (std::size_t i = 0; i < NHOT; i++, nFinds++)
+		{
+			lookup(cache, "hot" + std::to_string(i), nWrong);
+		}
+	}
+
+	/* A scan of rare nouns, twenty times the size of the cache */
+	for (std::size_t i = 0; i < NCOLD; i++, nFinds++)
+	{
+		lookup(cache, "cold" + std::to_string(i), nWrong);
+		nOver += (cache.size() > CAPACITY);
+	}
+
+	/* The hot set should have survived the scan */
+	std::size_t nHotHits = 0;
+
+	for (std::size_t i = 0; i < NHOT; i++, nFinds++)
+	{
+		nHotHits += lookup(cache, "hot" + std::to_string(i), nWrong);
+	}
+
+	/* The same noun with another verb is a different entry */
+	bool verbsKeptApart = (cache.find(mpp::Request::ISSING, "hot0") == nullptr);
+	++nFinds;
+
+	/* A Malayalam noun is the same entry whether it's given as UTF-8 or in compact form, and a noun that isn't Malayalam can't be mistaken for one whose compact form has the same bytes */
+	const std::string malUtf8 = u8"\u0d15\u0d3e\u0d30\u0d7b";
+	const mpp::MalNoun mal(malUtf8);
+	cache.insert(mpp::Request::FOF, malUtf8, "reply to " + malUtf8, cache.getGeneration());
+	const std::string* byCompact = cache.find(mpp::Request::FOF, mal);
+	cache.insert(mpp::Request::FOF, std::string(mal.offsets()), "reply to its offsets", cache.getGeneration());
+	const std::string* byUtf8 = cache.find(mpp::Request::FOF, malUtf8);
+	bool formsAgree = (byCompact && *byCompact == "reply to " + malUtf8 && byUtf8 && *byUtf8 == "reply to " + malUtf8);
+	nFinds += 2;
+
+	/* A reply whose facts were looked up before the noun was invalidated isn't stored */
+	std::uint64_t before = cache.getGeneration();
+	cache.invalidate("stale");
+	cache.insert(mpp::Request::FOF, "stale", "reply from before the change", before);
+	bool staleSkipped = (cache.find(mpp::Request::FOF, "stale") == nullptr);
+	++nFinds;
+
+	const mpp::ReplyCache::Stats& stats = cache.getStats();
+	bool statsAddUp = (stats.hits + stats.misses == nFinds);
+
+	std::cout << "Hot nouns still cached after the scan: " << nHotHits << "/" << NHOT << std::endl
+	<< "Hits: " << stats.hits << ", misses: " << stats.misses << ", evictions: " << stats.evictions << ", rejections: " << stats.rejections << std::endl
+	<< "Wrong replies: " << nWrong << ", times over capacity: " << nOver << std::endl
+	<< "Verbs kept apart: " << (verbsKeptApart ? "yes" : "no") << ", UTF-8 and compact nouns agree: " << (formsAgree ? "yes" : "no") << ", stale inserts skipped: " << (staleSkipped ? "yes" : "no") << ", stats add up: " << (statsAddUp ? "yes" : "no") << std::endl;
+
+	return ((nHotHits >= NHOT * 95 / 100 && nWrong == 0 && nOver == 0 && verbsKeptApart && formsAgree && staleSkipped && statsAddUp) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
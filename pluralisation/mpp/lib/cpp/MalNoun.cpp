@@ -0,0 +1,216 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcmp, std::memcpy
+
+/* Standard C++ */
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <functional> // std::hash
+#include <utility> // std::move
+#include <sstream> // std::ostringstream
+#include <stdexcept> // std::invalid_argument
+
+/* Our headers */
+#include "mpp/MalNoun.hpp" // Class def'n
+
+/**
+* @desc Constructor. Makes an empty noun.
+**/
+mpp::MalNoun::MalNoun() : len(0), h(std::hash<std::string_view>()(std::string_view())), small()
+{
+}
+
+/**
+* @desc Constructor. Converts a noun from UTF-8.
+* @param utf8 The noun. UTF-8 encoded Malayalam text.
+* @throws std::invalid_argument If the noun isn't valid UTF-8, or has a code point outside the Malayalam block.
+**/
+mpp::MalNoun::MalNoun(std::string_view utf8) : MalNoun()
+{
+	if (!encode(utf8, *this))
+	{
+		std::ostringstream ess;
+		ess << "mpp::MalNoun::MalNoun: \"" << utf8 << "\" isn't made of Malayalam code points.";
+		throw std::invalid_argument(ess.str());
+	}
+}
+
+/**
+* @desc Converts a noun from UTF-8, if it can be.
+* @param utf8 The noun.
+* @param out Set to the noun, if it could be converted. Left alone otherwise.
+* @return True if the noun is valid UTF-8 and only has code points from the Malayalam block.
+**/
+bool mpp::MalNoun::encode(std::string_view utf8, MalNoun& out)
+{
+	/* U+0D00-U+0D7F are exactly the code points whose UTF-8 is E0 B4 xx or E0 B5 xx, so the offset is the low bit of the second byte and the low 6 of the third */
+	if (utf8.size() % 3 != 0)
+	{
+		return false;
+	}
+
+	std::size_t n = utf8.size() / 3;
+	char shortBuf[MALNOUNINLINE]; // Filled in first, so that out is only changed if the whole noun converts
+	std::string longBuf;
+	char* dest = shortBuf;
+
+	if (n > MALNOUNINLINE)
+	{
+		longBuf.resize(n);
+		dest = &longBuf[0];
+	}
+
+	for (std::size_t i = 0; i < n; i++)
+	{
+		unsigned char lead = static_cast<unsigned char>(utf8[3 * i]);
+		unsigned char mid = static_cast<unsigned char>(utf8[3 * i + 1]);
+		unsigned char last = static_cast<unsigned char>(utf8[3 * i + 2]);
+
+		if (lead != 0xE0 || (mid & 0xFE) != 0xB4 || (last & 0xC0) != 0x80)
+		{
+			return false;
+		}
+
+		dest[i] = static_cast<char>(((mid & 0x01) << 6) | (last & 0x3F));
+	}
+
+	if (n > MALNOUNINLINE)
+	{
+		out.large = std::move(longBuf);
+	}
+
+	else
+	{
+		std::memcpy(out.small, shortBuf, n);
+		out.large.clear();
+	}
+
+	out.len = n;
+	out.h = std::hash<std::string_view>()(out.offsets());
+	return true;
+}
+
+/**
+* @desc Fetches the # of code points in the noun.
+* @return The # of code points.
+**/
+std::size_t mpp::MalNoun::size() const
+{
+	return len;
+}
+
+/**
+* @desc Checks whether or not the noun is empty.
+* @return True if it has no code points.
+**/
+bool mpp::MalNoun::empty() const
+{
+	return len == 0;
+}
+
+/**
+* @desc Fetches one of the noun's code points.
+* @param i The code point's index. Must be less than size().
+* @return The code point.
+**/
+char32_t mpp::MalNoun::operator[](std::size_t i) const
+{
+	return MALAYALAMBASE + static_cast<unsigned char>(data()[i]);
+}
+
+/**
+* @desc Fetches the noun's compact form.
+* @return One byte per code point, each the code point's offset from U+0D00. Valid as long as the noun is, and isn't changed.
+**/
+std::string_view mpp::MalNoun::offsets() const
+{
+	return std::string_view(data(), len);
+}
+
+/**
+* @desc Fetches the noun's hash, which was computed when it was made.
+* @return The hash of offsets().
+**/
+std::size_t mpp::MalNoun::hash() const
+{
+	return h;
+}
+
+/**
+* @desc Checks whether or not the noun ends in a suffix.
+* @param suffix The suffix.
+* @return True if the noun's last code points are the suffix's.
+**/
+bool mpp::MalNoun::endsWith(const MalNoun& suffix) const
+{
+	return suffix.len <= len && std::memcmp(data() + len - suffix.len, suffix.data(), suffix.len) == 0;
+}
+
+/**
+* @desc Converts the noun to UTF-8.
+* @return The noun's UTF-8.
+**/
+std::string mpp::MalNoun::toUtf8() const
+{
+	std::string toReturn;
+	appendUtf8(toReturn);
+	return toReturn;
+}
+
+/**
+* @desc Converts the noun to UTF-8, appending it to a string.
+* @param out The string.
+**/
+void mpp::MalNoun::appendUtf8(std::string& out) const
+{
+	std::size_t start = out.size();
+	out.resize(start + 3 * len);
+	const char* src = data();
+
+	for (std::size_t i = 0; i < len; i++)
+	{
+		unsigned char off = static_cast<unsigned char>(src[i]);
+		out[start + 3 * i] = static_cast<char>(0xE0);
+		out[start + 3 * i + 1] = static_cast<char>(0xB4 | (off >> 6));
+		out[start + 3 * i + 2] = static_cast<char>(0x80 | (off & 0x3F));
+	}
+}
+
+/**
+* @desc Compares two nouns.
+* @param other The other noun.
+* @return True if they have the same code points.
+**/
+bool mpp::MalNoun::operator==(const MalNoun& other) const
+{
+	return h == other.h && offsets() == other.offsets();
+}
+
+/**
+* @desc Compares two nouns.
+* @param other The other noun.
+* @return True if their code points differ.
+**/
+bool mpp::MalNoun::operator!=(const MalNoun& other) const
+{
+	return !(*this == other);
+}
+
+/**
+* @desc Orders two nouns by code point, which is also the order of their UTF-8.
+* @param other The other noun.
+* @return True if this noun comes first.
+**/
+bool mpp::MalNoun::operator<(const MalNoun& other) const
+{
+	return offsets() < other.offsets();
+}
+
+/**
+* @desc Fetches the noun's bytes, wherever they're held.
+* @return The bytes.
+**/
+const char* mpp::MalNoun::data() const
+{
+	return (len > MALNOUNINLINE ? large.data() : small);
+}
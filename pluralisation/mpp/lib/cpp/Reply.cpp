@@ -7,6 +7,7 @@
 #include <utility> // std::exchange, std::move, std::swap, std::pair
 #include <stdexcept> // std::out_of_range
 #include <algorithm> // std::find_if
+#include <map> // std::map
 #ifdef DEBUG
 #include <iostream> // std::cout
 #include <iomanip> // std::quoted
@@ -22,41 +23,79 @@
 #include "mpp/Header.hpp" // Header class
 #include "mpp/Reply.hpp" // Class def'n
 
+namespace
+{
+	/**
+	* @desc The status text and prebuilt replies that every Reply shares. Built once, on first use, and never changed after that.
+	**/
+	struct StatusTable
+	{
+		/**
+		* @desc Constructor. Formats every status line and fixed reply.
+		**/
+		StatusTable()
+		{
+			std::ostringstream verSS; // Used to build version string
+			verSS << "MPP/" << mpp::VER_MAJOR << "." << mpp::VER_MINOR << "." << mpp::VER_PATCH << " ";
+
+			/* Set up OK (2xx) responses */
+			text[mpp::Reply::singular] = verSS.str() + "200 Singular";
+			text[mpp::Reply::plural] = verSS.str() + "201 Plural";
+			text[mpp::Reply::pluralForm] = verSS.str() + "202 Plural Form";
+			text[mpp::Reply::singularForm] = verSS.str() + "203 Singular Form";
+			text[mpp::Reply::noPlural] = verSS.str() + "204 No Plural Form";
+			text[mpp::Reply::noSingular] = verSS.str() + "205 No Singular Form";
+
+			/* Set up error (4xx) responses */
+			text[mpp::Reply::badReq] = verSS.str() + "400 Bad Request";
+			text[mpp::Reply::badMajor] = verSS.str() + "401 Unrecognised Protocol Major Version Number";
+			text[mpp::Reply::badMinor] = verSS.str() + "402 Unrecognised Protocol Minor Version Number";
+			text[mpp::Reply::badPatch] = verSS.str() + "403 Unrecognised Protocol Patch Number";
+			text[mpp::Reply::unknownVerb] = verSS.str() + "404 Unrecognised Verb";
+			text[mpp::Reply::invUTF8] = verSS.str() + "405 Malformed UTF-8 Input";
+
+			/* Set up invalid status text */
+			text[mpp::Reply::invalid] = "Error: invalid Reply object!";
+
+			/* The replies with no content. The headers are in the order that toBuffers() would write them after ReqHandler or stockReply() added them. */
+			for (mpp::Reply::Status s : {mpp::Reply::singular, mpp::Reply::plural, mpp::Reply::noPlural, mpp::Reply::noSingular})
+			{
+				wire[s] = text[s] + "\r\nContent-Length: 0\r\nContent-Type: text/utf-8\r\n\r\n";
+			}
+
+			for (mpp::Reply::Status s : {mpp::Reply::badReq, mpp::Reply::badMajor, mpp::Reply::badMinor, mpp::Reply::badPatch, mpp::Reply::unknownVerb, mpp::Reply::invUTF8})
+			{
+				wire[s] = text[s] + "\r\nContent-Length: 0\r\nContent-Type: text/plain\r\n\r\n";
+			}
+		}
+
+		std::map<mpp::Reply::Status, std::string> text; // Status line for each status, without the CRLF
+		std::map<mpp::Reply::Status, std::string> wire; // The whole reply, for each status whose reply never changes
+	};
+
+	/**
+	* @desc Fetches the shared status table, building it on the first call.
+	* @return The table.
+	**/
+	const StatusTable& statusTable()
+	{
+		static const StatusTable table; // Initialisation is thread-safe, so concurrent first calls build it only once
+		return table;
+	}
+};
+
 /**
 * @name Default constructor.
-* @desc Constructs an invalid reply and sets up the status text map.
+* @desc Constructs an invalid reply.
 **/
 mpp::Reply::Reply() :
 	stat(invalid),
 	headers{},
-	statText{},
 	content(""),
 	crlf {'\r', '\n'},
-	nameValSep {':', ' '}
+	nameValSep {':', ' '},
+	wire(nullptr)
 {
-	std::ostringstream verSS; // Used to build version string
-	verSS << "MPP/" << mpp::VER_MAJOR << "." << mpp::VER_MINOR << "." << mpp::VER_PATCH << " ";
-
-	/** Set up status text map **/
-
-	/* Set up OK (2xx) responses */
-	statText[singular] = verSS.str() + "200 Singular";
-	statText[plural] = verSS.str() + "201 Plural";
-	statText[pluralForm] = verSS.str() + "202 Plural Form";
-	statText[singularForm] = verSS.str() + "203 Singular Form";
-	statText[noPlural] = verSS.str() + "204 No Plural Form";
-	statText[noSingular] = verSS.str() + "205 No Singular Form";
-
-	/* Set up error (4xx) responses */
-	statText[badReq] = verSS.str() + "400 Bad Request";
-	statText[badMajor] = verSS.str() + "401 Unrecognised Protocol Major Version Number";
-	statText[badMinor] = verSS.str() + "402 Unrecognised Protocol Minor Version Number";
-	statText[badPatch] = verSS.str() + "403 Unrecognised Protocol Patch Number";
-	statText[unknownVerb] = verSS.str() + "404 Unrecognised Verb";
-	statText[invUTF8] = verSS.str() + "405 Malformed UTF-8 Input";
-
-	/* Set up invalid status text */
-	statText[invalid] = "Error: invalid Reply object!";
 }
 
 /**
@@ -65,17 +104,47 @@ mpp::Reply::Reply() :
 void mpp::Reply::setStatus(mpp::Reply::Status s)
 {
 	stat = s;
+	wire = nullptr;
+}
+
+/**
+* @desc Turns this into one of the replies whose bytes never change: the answers to ISSING, FOF's "no such form" answers, and every error.
+*	Those replies are formatted once per process, and toBuffers() returns the prebuilt bytes instead of formatting headers.
+*	The reply's headers are part of the prebuilt bytes, so it has none of its own. Adding a header, setting content or changing the status makes it an ordinary reply again.
+* @param s The status. If it doesn't have a fixed reply, this is the same as setStatus(s).
+**/
+void mpp::Reply::setFixed(mpp::Reply::Status s)
+{
+	const std::map<Status, std::string>& fixedReplies = statusTable().wire;
+	auto it = fixedReplies.find(s);
+	headers.clear();
+	content.clear();
+	setStatus(s);
+
+	if (it != fixedReplies.cend())
+	{
+		wire = &it->second;
+	}
 }
 
 /**
 * @desc Converts the Reply into a vector of buffers that Boost.Asio can send over the network.
 *	The buffers don't own the underlying memory blocks. Therefore, the Reply object
 *	must remain valid and unchanged until the write operation has completed.
+*	A fixed reply is a single buffer that points at the shared prebuilt bytes, which live until the program exits.
+* @return The buffers. They're held by the Reply, and are replaced by the next call.
 **/
-std::vector<boost::asio::const_buffer> mpp::Reply::toBuffers()
+const std::vector<boost::asio::const_buffer>& mpp::Reply::toBuffers()
 {
 	repBufs.clear();
 	repBufConts.clear();
+
+	if (wire) // Nothing to format
+	{
+		repBufs.push_back(boost::asio::buffer(*wire));
+		return repBufs;
+	}
+
 	#ifdef DEBUG
 	std::cout << "mpp::Reply::toBuffers: buffers @ begin are: " << std::endl;
 	printRepBufs(); // Make a copy just to avoid having the string being destroyed
@@ -83,7 +152,7 @@ std::vector<boost::asio::const_buffer> mpp::Reply::toBuffers()
 	printRepBufConts();
 	#endif
 
-	repBufs.push_back(boost::asio::buffer(statText[stat])); // Add the status text first
+	repBufs.push_back(boost::asio::buffer(statusTable().text.at(stat))); // Add the status text first
 	#ifdef DEBUG
 	std::cout << "mpp::Reply::toBuffers: buffers after pushing status text are: " << std::endl;
 	printRepBufs();
@@ -121,9 +190,7 @@ std::vector<boost::asio::const_buffer> mpp::Reply::toBuffers()
 			try
 			{
 				length = ANY_CAST<lengthType>(h.getValue()); // Fetch the length
-				std::ostringstream convSS; // Used to convert int to str
-				convSS << length;
-				val = convSS.str();
+				val = std::to_string(length); // Short enough to fit in val without allocating
 			}
 	
 			catch (BAD_ANY_CAST& stdbace) // Rethrow it as a library error
@@ -191,6 +258,7 @@ std::vector<boost::asio::const_buffer> mpp::Reply::toBuffers()
 **/
 void mpp::Reply::addHeader(mpp::Header toAdd)
 {
+	wire = nullptr;
 	headers.push_front(toAdd);
 }
 
@@ -200,7 +268,7 @@ void mpp::Reply::addHeader(mpp::Header toAdd)
 **/
 std::string mpp::Reply::getStatText(mpp::Reply::Status s) const
 {
-	return statText.at(s);
+	return statusTable().text.at(s);
 }
 
 /**
@@ -209,9 +277,52 @@ std::string mpp::Reply::getStatText(mpp::Reply::Status s) const
 **/
 void mpp::Reply::setContent(std::string c)
 {
+	wire = nullptr;
 	content = c;
 }
 
+/**
+* @desc Fetches the reply's content.
+* @return The content.
+**/
+std::string mpp::Reply::getContent() const
+{
+	return content;
+}
+
+/**
+* @desc Fetches the value of the reply's Content-Length header.
+* @throws mpp::exceptions::BadHeaderValue if the header's value isn't an std::string::size_type.
+* @return The # of bytes of content, or 0 if there's no Content-Length header.
+**/
+std::string::size_type mpp::Reply::getContentLength() const
+{
+	auto it = std::find_if(headers.cbegin(), headers.cend(), [](const mpp::Header& h) -> bool
+		{
+			return h.getName() == "Content-Length";
+		}
+	);
+
+	if (it == headers.cend()) // No content
+	{
+		return 0;
+	}
+
+	try
+	{
+		return ANY_CAST<std::string::size_type>(it->getValue());
+	}
+
+	catch (BAD_ANY_CAST& bace) // Invalid data type
+	{
+		std::ostringstream ess;
+		ess << "mpp::Reply::getContentLength: the Content-Length header should contain an std::string::size_type value, but doesn't!" << std::endl
+		<< "Error: " << bace.what() << std::endl;
+		mpp::exceptions::BadHeaderValue mebhv(ess.str());
+		throw mebhv;
+	}
+}
+
 /**
 * @desc Uses in-place construction to add a Header to our list.
 * @param name The header's name.
@@ -219,6 +330,7 @@ void mpp::Reply::setContent(std::string c)
 **/
 void mpp::Reply::addHeader(std::string name, ANY_CLASS val)
 {
+	wire = nullptr;
 	headers.emplace_front(name, val); // Construct a new header in-place
 }
 
@@ -230,6 +342,13 @@ void mpp::Reply::addHeader(std::string name, ANY_CLASS val)
 mpp::Reply mpp::Reply::stockReply(mpp::Reply::Status stat)
 {
 	mpp::Reply rep;
+
+	if (stat >= badReq) // Every error reply is prebuilt, with the same headers as below
+	{
+		rep.setFixed(stat);
+		return rep;
+	}
+
 	rep.addHeader("Content-Type", std::string("text/plain"));
 	rep.addHeader("Content-Length", static_cast<std::string::size_type>(0));
 	rep.setStatus(stat);
@@ -243,10 +362,10 @@ mpp::Reply mpp::Reply::stockReply(mpp::Reply::Status stat)
 **/
 mpp::Reply::Reply(const mpp::Reply& other) : stat(other.stat),
 	headers(other.headers),
-	statText(other.statText),
 	content(other.content),
 	crlf(other.crlf),
-	nameValSep(other.nameValSep)
+	nameValSep(other.nameValSep),
+	wire(other.wire)
 {
 }
 
@@ -265,8 +384,8 @@ mpp::Reply& mpp::Reply::operator=(const mpp::Reply& other)
 
 	stat = other.stat;
 	headers = other.headers;
-	statText = other.statText;
 	content = other.content;
+	wire = other.wire;
 	return *this; // Allow chaining
 }
 
@@ -278,9 +397,15 @@ mpp::Reply& mpp::Reply::operator=(const mpp::Reply& other)
 **/
 std::ostream& mpp::operator<<(std::ostream& os, const mpp::Reply& rep)
 {
+	if (rep.wire) // Already formatted
+	{
+		os << *rep.wire;
+		return os;
+	}
+
 	try
 	{
-		os << rep.statText.at(rep.stat) << "\r\n"; // Write the first line of the response
+		os << statusTable().text.at(rep.stat) << "\r\n"; // Write the first line of the response
 	}
 
 	catch (std::out_of_range& stdoor)
@@ -346,6 +471,7 @@ std::ostream& mpp::operator<<(std::ostream& os, const mpp::Reply& rep)
 **/
 void mpp::Reply::clearHeaders()
 {
+	wire = nullptr;
 	headers.clear();
 }
 
@@ -0,0 +1,405 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t, std::uint64_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <algorithm> // std::max, std::min
+#include <iterator> // std::prev
+#include <sstream> // std::ostringstream
+#include <stdexcept> // std::invalid_argument
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* Our headers */
+#include "mpp/Request.hpp" // mpp::Request::Command
+#include "mpp/MalNoun.hpp" // A noun, one byte per code point
+#include "mpp/ReplyCache.hpp" // Class def'n
+
+/**
+* @desc Constructor.
+* @param capacity The most replies to hold. Must be positive.
+**/
+mpp::ReplyCache::ReplyCache(std::size_t capacity) : capacity(capacity),
+	windowCap(std::max<std::size_t>(1, capacity / 100)), // 1% of the cache, as in the W-TinyLFU paper
+	mainCap(capacity - std::min(capacity, windowCap)),
+	protectedCap(mainCap * 4 / 5),
+	sketchWidth(1),
+	nSamples(0),
+	sampleSize(10 * capacity),
+	generation(0)
+{
+	if (capacity == 0)
+	{
+		std::ostringstream ess;
+		ess << "mpp::ReplyCache::ReplyCache: the capacity must be positive.";
+		throw std::invalid_argument(ess.str());
+	}
+
+	while (sketchWidth < capacity) // One counter per entry in each row keeps collisions rare
+	{
+		sketchWidth <<= 1;
+	}
+
+	sketch.assign(NSKETCHROWS * sketchWidth, 0);
+	index.reserve(capacity + 1); // The map never rehashes, so lookups don't allocate
+
+	#ifdef DEBUG
+	std::cout << "mpp::ReplyCache::ReplyCache: capacity = " << capacity << ", window = " << windowCap << ", protected = " << protectedCap << ", sketch width = " << sketchWidth << std::endl;
+	#endif
+}
+
+/**
+* @desc Looks up the reply to a request, and counts the request towards its noun's popularity.
+* @param verb The request's verb.
+* @param noun The request's noun.
+* @return The reply's bytes, or null if it isn't cached. Valid until the next call to insert() or clear().
+**/
+const std::string* mpp::ReplyCache::find(mpp::Request::Command verb, std::string_view noun)
+{
+	return findKey(makeKey(verb, noun));
+}
+
+/**
+* @desc Looks up the reply to a request whose noun is already in compact form, and counts the request towards its noun's popularity.
+* @param verb The request's verb.
+* @param noun The request's noun.
+* @return The reply's bytes, or null if it isn't cached. Valid until the next call to insert() or clear().
+**/
+const std::string* mpp::ReplyCache::find(mpp::Request::Command verb, const MalNoun& noun)
+{
+	return findKey(makeKey(verb, noun));
+}
+
+/**
+* @desc Stores the reply to a request that find() didn't have. This may evict another reply, or not keep this one.
+* @param verb The request's verb.
+* @param noun The request's noun.
+* @param reply The whole reply, exactly as it's sent.
+* @param asOf What getGeneration() returned before the reply's facts were looked up. If the cache has been cleared or invalidated since, the reply may be stale, so it isn't stored.
+**/
+void mpp::ReplyCache::insert(mpp::Request::Command verb, std::string_view noun, std::string_view reply, std::uint64_t asOf)
+{
+	if (asOf == generation)
+	{
+		insertKey(makeKey(verb, noun), reply);
+	}
+}
+
+/**
+* @desc Stores the reply to a request whose noun is already in compact form. This may evict another reply, or not keep this one.
+* @param verb The request's verb.
+* @param noun The request's noun.
+* @param reply The whole reply, exactly as it's sent.
+* @param asOf What getGeneration() returned before the reply's facts were looked up. If the cache has been cleared or invalidated since, the reply may be stale, so it isn't stored.
+**/
+void mpp::ReplyCache::insert(mpp::Request::Command verb, const MalNoun& noun, std::string_view reply, std::uint64_t asOf)
+{
+	if (asOf == generation)
+	{
+		insertKey(makeKey(verb, noun), reply);
+	}
+}
+
+/**
+* @desc Drops every reply, e.g. because the data that they came from has changed, and starts a new generation. The popularity counts and stats are kept.
+**/
+void mpp::ReplyCache::clear()
+{
+	++generation;
+	index.clear();
+	window.clear();
+	probation.clear();
+	protectedList.clear();
+}
+
+/**
+* @desc Drops every reply about a noun, whatever the verb, because the facts that they came from have changed, and starts a new generation. The noun's popularity count is kept.
+* @param noun The noun.
+* @return The # of replies dropped.
+**/
+std::size_t mpp::ReplyCache::invalidate(std::string_view noun)
+{
+	std::size_t toReturn = 0;
+	++generation; // A lookup of this noun may be waiting for the DB, and would otherwise store what it read before the change
+
+	for (Request::Command verb : {Request::FOF, Request::ISSING})
+	{
+		auto found = index.find(makeKey(verb, noun));
+
+		if (found != index.end()) // Not counted as an eviction, since it wasn't dropped to make room
+		{
+			EntryList::iterator it = found->second;
+			index.erase(found);
+			listOf(it->seg).erase(it);
+			++toReturn;
+		}
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Fetches the cache's generation, which changes whenever it's cleared or invalidated. Read it before looking a reply's facts up, and pass it to insert().
+* @return The generation.
+**/
+std::uint64_t mpp::ReplyCache::getGeneration() const
+{
+	return generation;
+}
+
+/**
+* @desc Fetches the # of replies in the cache.
+* @return The # of replies.
+**/
+std::size_t mpp::ReplyCache::size() const
+{
+	return index.size();
+}
+
+/**
+* @desc Fetches the cache's counters.
+* @return The counters.
+**/
+const mpp::ReplyCache::Stats& mpp::ReplyCache::getStats() const
+{
+	return stats;
+}
+
+/**
+* @desc Builds the key for a request in keyBuf.
+* @param verb The request's verb.
+* @param noun The request's noun, in UTF-8. It's converted to compact form if it can be, and kept as it is, with RAWKEYFLAG set in the verb byte, if it can't.
+* @return A view of keyBuf.
+**/
+std::string_view mpp::ReplyCache::makeKey(mpp::Request::Command verb, std::string_view noun)
+{
+	if (MalNoun::encode(noun, nounBuf))
+	{
+		return makeKey(verb, nounBuf);
+	}
+
+	keyBuf.assign(1, static_cast<char>(verb | RAWKEYFLAG));
+	keyBuf.append(noun.data(), noun.size());
+	return keyBuf;
+}
+
+/**
+* @desc Builds the key for a request in keyBuf.
+* @param verb The request's verb.
+* @param noun The request's noun.
+* @return A view of keyBuf.
+**/
+std::string_view mpp::ReplyCache::makeKey(mpp::Request::Command verb, const MalNoun& noun)
+{
+	std::string_view offsets = noun.offsets();
+	keyBuf.assign(1, static_cast<char>(verb));
+	keyBuf.append(offsets.data(), offsets.size());
+	return keyBuf;
+}
+
+/**
+* @desc Looks up a key's reply, and counts the request towards its popularity.
+* @param key The key.
+* @return The reply's bytes, or null if it isn't cached.
+**/
+const std::string* mpp::ReplyCache::findKey(std::string_view key)
+{
+	recordAccess(hasher(key));
+	auto found = index.find(key);
+
+	if (found == index.end())
+	{
+		++stats.misses;
+		return nullptr;
+	}
+
+	++stats.hits;
+	EntryList::iterator it = found->second;
+
+	switch (it->seg)
+	{
+		case Probation: // Hit again since it was admitted, so protect it
+		{
+			it->seg = Protected;
+			protectedList.splice(protectedList.begin(), probation, it);
+
+			if (protectedList.size() > protectedCap) // Make room by putting the least recently used protected entry back on probation
+			{
+				EntryList::iterator demoted = std::prev(protectedList.end());
+				demoted->seg = Probation;
+				probation.splice(probation.begin(), protectedList, demoted);
+			}
+
+			break;
+		}
+
+		default: // Just make it the most recently used entry in its list
+		{
+			EntryList& list = listOf(it->seg);
+			list.splice(list.begin(), list, it);
+			break;
+		}
+	}
+
+	return &it->reply;
+}
+
+/**
+* @desc Stores the reply for a key.
+* @param key The key.
+* @param reply The whole reply, exactly as it's sent.
+**/
+void mpp::ReplyCache::insertKey(std::string_view key, std::string_view reply)
+{
+	auto found = index.find(key);
+
+	if (found != index.end()) // Already cached, e.g. because the same noun came twice in a row. Keep the newer reply.
+	{
+		found->second->reply.assign(reply.data(), reply.size());
+		return;
+	}
+
+	window.push_front(Entry {std::string(key), std::string(reply), Window});
+	index.emplace(window.front().key, window.begin()); // The key must point at the entry's copy, not at keyBuf
+
+	if (window.size() > windowCap)
+	{
+		evictFromWindow();
+	}
+}
+
+/**
+* @desc Finds a key's counter in one row of the sketch.
+* @param h The key's hash.
+* @param row The row.
+* @return The counter's index in sketch.
+**/
+std::size_t mpp::ReplyCache::slot(std::uint64_t h, std::size_t row) const
+{
+	/* Give each row its own hash by mixing in the row # */
+	std::uint64_t x = (h ^ (row * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+	x ^= x >> 31;
+	return row * sketchWidth + (x & (sketchWidth - 1));
+}
+
+/**
+* @desc Counts one request for a key. Every counter is halved once enough requests have been counted, so that old popularity fades.
+* @param h The key's hash.
+**/
+void mpp::ReplyCache::recordAccess(std::uint64_t h)
+{
+	for (std::size_t row = 0; row < NSKETCHROWS; row++)
+	{
+		std::uint8_t& counter = sketch[slot(h, row)];
+
+		if (counter < 15)
+		{
+			++counter;
+		}
+	}
+
+	if (++nSamples >= sampleSize)
+	{
+		for (std::uint8_t& counter : sketch)
+		{
+			counter >>= 1;
+		}
+
+		nSamples /= 2;
+
+		#ifdef DEBUG
+		std::cout << "mpp::ReplyCache::recordAccess: halved the frequency counters" << std::endl;
+		#endif
+	}
+}
+
+/**
+* @desc Estimates how often a key has been asked for recently.
+* @param h The key's hash.
+* @return The estimate, from 0 to 15.
+**/
+unsigned mpp::ReplyCache::frequency(std::uint64_t h) const
+{
+	unsigned toReturn = 15;
+
+	for (std::size_t row = 0; row < NSKETCHROWS; row++) // Other keys can only add to a counter, so the smallest one is the closest
+	{
+		toReturn = std::min<unsigned>(toReturn, sketch[slot(h, row)]);
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Moves the window's oldest entry into the main area if it's wanted there, and makes room by evicting.
+**/
+void mpp::ReplyCache::evictFromWindow()
+{
+	EntryList::iterator candidate = std::prev(window.end());
+
+	if (probation.size() + protectedList.size() < mainCap) // Room to spare
+	{
+		candidate->seg = Probation;
+		probation.splice(probation.begin(), window, candidate);
+		return;
+	}
+
+	/* The main area is full, so the candidate has to beat the entry that would be evicted to make room for it */
+	EntryList& victimList = (probation.empty() ? protectedList : probation);
+
+	if (victimList.empty() || frequency(hasher(candidate->key)) <= frequency(hasher(victimList.back().key))) // Ties go to the victim, which has already proved itself
+	{
+		#ifdef DEBUG
+		std::cout << "mpp::ReplyCache::evictFromWindow: rejected a new entry" << std::endl;
+		#endif
+
+		++stats.rejections;
+		erase(window, candidate);
+		return;
+	}
+
+	erase(victimList, std::prev(victimList.end()));
+	candidate->seg = Probation;
+	probation.splice(probation.begin(), window, candidate);
+}
+
+/**
+* @desc Removes an entry from the cache.
+* @param list The list that holds it.
+* @param it The entry.
+**/
+void mpp::ReplyCache::erase(EntryList& list, EntryList::iterator it)
+{
+	index.erase(it->key);
+	list.erase(it);
+	++stats.evictions;
+}
+
+/**
+* @desc Fetches the list for a segment.
+* @param seg The segment.
+* @return The list.
+**/
+mpp::ReplyCache::EntryList& mpp::ReplyCache::listOf(Segment seg)
+{
+	switch (seg)
+	{
+		case Window:
+		{
+			return window;
+		}
+
+		case Probation:
+		{
+			return probation;
+		}
+
+		default:
+		{
+			return protectedList;
+		}
+	}
+}
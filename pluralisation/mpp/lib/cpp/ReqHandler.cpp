@@ -11,65 +11,163 @@
 #include <vector> // std::vector
 #include <iomanip> // std::quoted
 #include <ios> // std::boolalpha, std::noboolalpha
+#include <memory> // std::shared_ptr, std::make_shared
+#include <optional> // std::optional
+#include <chrono> // std::chrono::seconds
+#include <functional> // std::function
+#include <exception> // std::exception_ptr
+#include <utility> // std::move
 #ifdef DEBUG
 #include <iostream> // std::cout
 #endif
 
 /* Boost */
-#include <boost/regex.hpp> // boost::smatch
-#include <boost/regex/icu.hpp> // boost::make_u32regex, boost::u32regex_match, boost::u32regex
 #include <boost/logic/tribool_fwd.hpp> // boost::logic::tribool fwd declarations
 #include <boost/logic/tribool.hpp> // boost::logic::tribool
 #include <boost/logic/tribool_io.hpp> // operator<< def'ns for boost::logic::tribool
 
-/* MariaDB++ */
-#include <mariadb++/account.hpp> // mariadb::account::create, mariadb::account_ref
-#include <mariadb++/connection.hpp> // mariadb::connection::create
-#include <mariadb++/result_set.hpp> // mariadb::result_set_ref
-#include <mariadb++/exceptions.hpp> // mariadb::exception::connection
-
 /* Our headers */
 #include "bosmacros/array.hpp" // ARRAY_CLASS macro
 #include "mpp/Request.hpp" // Represents a request
 #include "mpp/Reply.hpp" // Represents a reply
 #include "mpp/Header.hpp" // Represents a (name, value) pair
 #include "mpp/data/DBInfo.hpp" // A class that encapsulates the storage of DB info
+#include "mpp/data/LiveLexicon.hpp" // In-memory noun tables that can be replaced while running
+#include "mpp/data/DBPool.hpp" // Pool of DB sessions shared by every handler
+#include "mpp/data/DBSession.hpp" // A DB connection with prepared statements
+#include "mpp/data/AsyncDBSession.hpp" // A DB connection that doesn't block its thread
+#include "mpp/data/NounFacts.hpp" // Everything known about a noun
 #include "mpp/exceptions/DBError.hpp" // Thrown if some sort of error occurs while connecting to the DB
+#include "mpp/SuffixClassifier.hpp" // Classifies nouns by their endings
 #include "mpp/exceptions/UnknownNoun.hpp" // Thrown if a noun doesn't exist in the DB, and the method which throws it expected it to exist
 #include "mpp/ReqHandler.hpp" // Class def'n
 
 /**
 * @desc Handles a request and produces a reply.
+*	Unless the lexicon is in use, a single DB session is checked out of the pool for the whole request, and returned when this method exits.
 * @param req The request object to get request data from.
 * @param rep The respnse object to set parameters on to generate a response.
 **/
 void mpp::ReqHandler::handleReq(const mpp::Request& req, mpp::Reply& rep)
+{
+	std::optional<data::DBPool::Lease> lease; // The session used by every lookup for this request
+
+	if (!lexicon) // Lookups need the DB
+	{
+		lease.emplace(dbPool->acquire()); // Blocks if every session is in use
+		dbSess = &**lease;
+	}
+
+	try
+	{
+		respond(req, rep, getFacts(req.getNoun())); // The only DB round-trip for this request
+	}
+
+	catch (mpp::exceptions::DBError& dbe) // The session may be unusable, so make sure that the pool reconnects it before lending it out again
+	{
+		if (lease)
+		{
+			lease->markBroken();
+		}
+
+		dbSess = nullptr;
+		throw;
+	}
+
+	dbSess = nullptr;
+}
+
+/**
+* @desc Handles a request without blocking, and produces a reply.
+*	If the lexicon is in use, the reply is produced and handler is called before this returns. Otherwise, the noun is looked up by the async DB session, and handler is called from its io_context once the reply is ready.
+* @param req The request object to get request data from. Must stay valid until handler is called.
+* @param rep The respnse object to set parameters on to generate a response. Must stay valid until handler is called.
+* @param handler Called with nothing once the reply is ready, or with a DBError if the noun couldn't be looked up.
+**/
+void mpp::ReqHandler::asyncHandleReq(const mpp::Request& req, mpp::Reply& rep, std::function<void(std::exception_ptr)> handler)
+{
+	if (lexicon || !asyncDB) // Nothing to wait for
+	{
+		std::exception_ptr err;
+
+		try
+		{
+			handleReq(req, rep);
+		}
+
+		catch (mpp::exceptions::DBError& dbe)
+		{
+			err = std::current_exception();
+		}
+
+		handler(err);
+		return;
+	}
+
+	asyncDB->getFacts(req.getNoun(), [this, &req, &rep, handler = std::move(handler)](std::exception_ptr err, data::NounFacts facts)
+		{
+			if (!err)
+			{
+				respond(req, rep, facts);
+			}
+
+			handler(err);
+		}
+	);
+}
+
+/**
+* @desc Produces the reply to a request, once its noun has been looked up.
+* @param req The request object to get request data from.
+* @param rep The respnse object to set parameters on to generate a response.
+* @param facts What the DB knows about the request's noun.
+**/
+void mpp::ReqHandler::respond(const mpp::Request& req, mpp::Reply& rep, const data::NounFacts& facts)
 {
 	std::string utf8Text("text/utf-8"); // Initialise the string once instead of using several temporaries
-	std::string::size_type zeroLengthInd(0);
+	const MalNoun& compact = req.getCompactNoun();
+	nounShape = (compact.empty() ? classifier.classify(facts.noun) : classifier.classify(compact)); // Every helper below asks about the same noun, so its ending is only read once
 
 	switch (req.GETCOM_FUNC()) // Check what type of request it is
 	{
 		case Request::FOF: // "F"ind "O"pposite "F"orm
 		{
-			if (isSingular(req.getNoun())) // Need to find the plural (if it exists)
+			if (isSingular(facts)) // Need to find the plural (if it exists)
 			{
 				#ifdef DEBUG
 				std::cout << "mpp::ReqHandler::handleReq::FOF: noun " << std::quoted(req.getNoun()) << " is singular, so we shall find its plural." << std::endl;
 				#endif
 
-				if (hasPlural(req.getNoun()) == true) // The noun is pluralisable
+				if (hasPlural(facts) == true) // The noun is pluralisable
 				{
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::handleReq::FOF: noun " << std::quoted(req.getNoun()) << " is pluralisable." << std::endl;
 					#endif
 
-					std::vector<std::string> pluralForms = findPlural(req.getNoun());
+					std::vector<std::string> pluralForms;
+
+					try
+					{
+						pluralForms = findPlural(facts);
+					}
+
+					catch (mpp::exceptions::UnknownNoun& un) // Neither the DB nor the noun's ending says how to pluralise it, so as far as we know, it has no plural
+					{
+						#ifdef DEBUG
+						std::cout << "mpp::ReqHandler::handleReq::FOF: " << un.what() << std::endl;
+						#endif
+					}
+
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::handleReq::FOF: # of plural forms found = " << pluralForms.size() << std::endl;
 					#endif
 				
-					if (pluralForms.size() > 1) // There's > 1 possible plural
+					if (pluralForms.empty())
+					{
+						rep.setFixed(Reply::noPlural);
+					}
+
+					else if (pluralForms.size() > 1) // There's > 1 possible plural
 					{
 						#ifdef DEBUG
 						std::cout << "mpp::ReqHAndler::handleReq::FOF: possible plurals of " << std::quoted(req.getNoun()) << " are: " << std::endl << std::endl;
@@ -114,10 +212,7 @@ void mpp::ReqHandler::handleReq(const mpp::Request& req, mpp::Reply& rep)
 
 				else // The noun isn't pluralisable
 				{
-					rep.setStatus(Reply::noPlural);
-					rep.addHeader("Content-Type", utf8Text);
-					rep.addHeader("Content-Length", zeroLengthInd);
-					rep.setContent("");
+					rep.setFixed(Reply::noPlural); // No content, so the reply is prebuilt
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::handleReq::FOF: the noun " << std::quoted(req.getNoun()) << " isn't pluralisable." << std::endl;
 					#endif
@@ -135,12 +230,30 @@ void mpp::ReqHandler::handleReq(const mpp::Request& req, mpp::Reply& rep)
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::handleReq::FOF: the noun " << std::quoted(req.getNoun()) << " is singularisable." << std::endl;
 					#endif
-					std::vector<std::string> singularForms = findSingular(req.getNoun());
+					std::vector<std::string> singularForms;
+
+					try
+					{
+						singularForms = findSingular(facts);
+					}
+
+					catch (mpp::exceptions::UnknownNoun& un) // Not a known stem type, and not in the DB
+					{
+						#ifdef DEBUG
+						std::cout << "mpp::ReqHandler::handleReq::FOF: " << un.what() << std::endl;
+						#endif
+					}
+
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::handleReq::FOF: # of singular forms found = " << singularForms.size() << std::endl;
 					#endif
 
-					if (singularForms.size() == 1) // Only 1 singular form
+					if (singularForms.empty())
+					{
+						rep.setFixed(Reply::noSingular);
+					}
+
+					else if (singularForms.size() == 1) // Only 1 singular form
 					{
 						std::string singularForm = singularForms.front();
 						rep.setStatus(Reply::singularForm);
@@ -189,10 +302,7 @@ void mpp::ReqHandler::handleReq(const mpp::Request& req, mpp::Reply& rep)
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::handleReq::FOF: the noun " << std::quoted(req.getNoun()) << " isn't singularisable." << std::endl;
 					#endif
-					rep.setStatus(Reply::noSingular);
-					rep.addHeader("Content-Type", utf8Text);
-					rep.addHeader("Content-Length", zeroLengthInd);
-					rep.setContent("");
+					rep.setFixed(Reply::noSingular);
 				}
 			}
 
@@ -205,16 +315,13 @@ void mpp::ReqHandler::handleReq(const mpp::Request& req, mpp::Reply& rep)
 			std::cout << "mpp::ReqHandler::handleReq: checking whether " << std::quoted(req.getNoun()) << " is singular" << std::endl;
 			#endif
 
-			rep.addHeader("Content-Type", utf8Text);
-			rep.addHeader("Content-Length", zeroLengthInd);
-
-			if (isSingular(req.getNoun()))
+			/* Neither answer has content, so both replies are prebuilt */
+			if (isSingular(facts))
 			{
 				#ifdef DEBUG
 				std::cout << "mpp::ReqHandler::handleReq: " << std::quoted(req.getNoun()) << " is singular" << std::endl;
 				#endif
-				rep.setStatus(Reply::singular);
-				rep.setContent(""); // This response has no content
+				rep.setFixed(Reply::singular);
 			}
 
 			else // The noun is plural
@@ -222,8 +329,7 @@ void mpp::ReqHandler::handleReq(const mpp::Request& req, mpp::Reply& rep)
 				#ifdef DEBUG
 				std::cout << "mpp::ReqHandler::handleReq: " << std::quoted(req.getNoun()) << " is plural" << std::endl;
 				#endif
-				rep.setStatus(Reply::plural);
-				rep.setContent(""); // No content
+				rep.setFixed(Reply::plural);
 			}
 
 			break;
@@ -239,109 +345,71 @@ void mpp::ReqHandler::handleReq(const mpp::Request& req, mpp::Reply& rep)
 /**
 * @desc Constructor. Performs initial setup, specifically:
 *	1) Loads DB info from a config file.
-* 	2) Opens a connection to the DB.
+* 	2) Opens a connection to the DB, in a pool of its own.
 * @param cfPath The path to the DB config file.
+* @param lex The in-memory noun tables, which may be replaced while requests are being handled. If given, the DB is never queried; if null, every lookup goes to the DB.
+* @param reader The lexicon reader slot of the thread that will call handleReq.
 **/
-mpp::ReqHandler::ReqHandler(std::string cfPath) : dbInfo(cfPath), // Load DB info from the path or throw an exception
-	declRegs { // Set up array of regexes used to guess what declension a noun falls into
-		boost::make_u32regex(".*\\x{d7b}$"), // an-stem
-		boost::make_u32regex(".*\\x{d02}$"), // am-stem
-		boost::make_u32regex(".*\\x{d31}\\x{d4d}$"), // ruh-stem
-		boost::make_u32regex(".*\\x{d1f}\\x{d4d}$"), // duh-stem
-		boost::make_u32regex(".*\\x{d4d}$"), // schwa-stem
-	}
+mpp::ReqHandler::ReqHandler(std::string cfPath, std::shared_ptr<data::LiveLexicon> lex, std::size_t reader) : ReqHandler(
+		lex ? nullptr : std::make_shared<data::DBPool>(data::DBInfo(cfPath), 1, std::chrono::seconds(0)), // Load DB info from the path or throw an exception. A lone handler has no need for background validation.
+		lex,
+		reader
+	)
 {
-	endsInKaar = boost::make_u32regex(".*\\x{d15}\\x{d3e}\\x{d30}(\\x{d7b}|\\x{d3f})$"); // A regex that matches -കാരൻ or -കാരി
 }
 
 /**
-* @desc Acquires the resources needed to communicate with the DB.
+* @desc Constructor. Uses sessions from a pool shared with other handlers.
+* @param pool The pool to check DB sessions out of. May be null if a lexicon is given.
+* @param lex The in-memory noun tables, which may be replaced while requests are being handled. If given, the DB is never queried; if null, every lookup goes to the DB.
+* @param reader The lexicon reader slot of the thread that will call handleReq.
 **/
-void mpp::ReqHandler::openDBConn()
+mpp::ReqHandler::ReqHandler(std::shared_ptr<data::DBPool> pool, std::shared_ptr<data::LiveLexicon> lex, std::size_t reader) : dbPool(pool),
+	dbSess(nullptr),
+	classifier(SuffixClassifier::get()), // Built by whichever handler is constructed first
+	lexicon(lex),
+	lexReader(reader)
 {
-	dbAcc = mariadb::account::create(dbInfo.getHost(), dbInfo.getUser(), dbInfo.getPassword(), dbInfo.getDBName()); // Create a reference to the account, and open the DB we need on connection
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: created a reference to my account" << std::endl;
-	#endif
-	dbConn = mariadb::connection::create(dbAcc); // Create a reference to a connection to the DB using our account info
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: created a reference to a connection to my account" << std::endl;
-	#endif
-	dbConn->set_charset("utf8"); // Ensure that Malayalam nouns are fetched properly
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: set connection's character set to UTF-8" << std::endl;
-	#endif
-	dbConn->connect(); // Actually open the connection
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: opened the connection" << std::endl;
-	#endif
-
-	if (!dbConn->connected())
-	{
-		mpp::exceptions::DBError ex(std::string("mpp::ReqHandler::openDBConn: Couldn't connect to DB!"));
-		throw ex;
-	}
-
-	existStmt = dbConn->create_statement("SELECT * FROM nouns WHERE noun=?"); // Prepare the statement used when checking whether or not a noun exists in the DB
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: created the statement used to check whether or not a noun exists in the DB" << std::endl;
-	#endif
-
-	hasPluralStmt = dbConn->create_statement("SELECT nouns.id,pluralisableNouns.pluralisable FROM nouns JOIN pluralisableNouns ON nouns.id=pluralisableNouns.id WHERE nouns.noun=?"); // Prepare the statement used when checking whether or not a noun is pluralisable
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: created the statement used to check whether or not a noun is pluralisable" << std::endl;
-	#endif
-
-	isAnimateStmt = dbConn->create_statement("SELECT nouns.*,animacies.animate FROM nouns LEFT JOIN animacies ON animacies.id=nouns.id WHERE nouns.noun=?"); // Prepare the statement used to check whether or not a noun is animate
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: created the statement used to check whether or not a noun is animate" << std::endl;
-	#endif
-
-	isHumanStmt = dbConn->create_statement("SELECT nouns.*,humanNouns.humanity FROM nouns LEFT JOIN humanNouns ON humanNouns.id=nouns.id WHERE nouns.noun=?"); // Prepare the statement used to check whether or not a noun refers to a human
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: created the statement used to check whether or not a noun is animate" << std::endl;
-	#endif
-
-	getGenderStmt = dbConn->create_statement("SELECT nouns.id,genders.gender FROM nouns JOIN genders ON nouns.id=genders.id WHERE nouns.noun=?"); // Prepare the statement used to fetch a noun's gender
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn:: created the statement used to find a noun's gender." << std::endl;
-	#endif
-
-	exceptionStmt = dbConn->create_statement("SELECT nouns.id,nouns.noun,exceptions.plural FROM nouns JOIN exceptions ON exceptions.nid=nouns.id WHERE nouns.noun=?"); // Prepare the statement used to fetch the plural of exceptional nouns
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: created statement used to fetch plural of exceptional nouns." << std::endl;
-	#endif
+}
 
-	exSingStmt = dbConn->create_statement("SELECT * FROM nouns WHERE nouns.id IN (SELECT nid FROM exceptions WHERE exceptions.plural=?)"); // Create the statement used to check whether a plural is that of an exceptional noun
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::openDBConn: created statement used to fetch the singular form of an exceptional noun." << std::endl;
-	#endif
+/**
+* @desc Constructor. Looks nouns up without blocking, through asyncHandleReq. One handler can serve every connection on its thread, with several requests waiting for the DB at once.
+* @param db The session to look nouns up on. It must belong to the io_context whose thread calls asyncHandleReq. May be null if a lexicon is given.
+* @param lex The in-memory noun tables, which may be replaced while requests are being handled. If given, the DB is never queried; if null, every lookup goes to db.
+* @param reader The lexicon reader slot of the thread that will call asyncHandleReq.
+**/
+mpp::ReqHandler::ReqHandler(std::shared_ptr<data::AsyncDBSession> db, std::shared_ptr<data::LiveLexicon> lex, std::size_t reader) : dbSess(nullptr),
+	asyncDB(db),
+	classifier(SuffixClassifier::get()),
+	lexicon(lex),
+	lexReader(reader)
+{
 }
 
 /**
 * @desc Determines whether or not the given noun is singular.
-*	It first attempts to find the noun in the DB. If it does, it knows that the noun is singular.
-*	If it doesn't find the noun in the DB, it uses regexes to guess at whether or not the noun is singular.
-* @param noun The noun to check, encoded in UTF-8.
+*	If the noun is in the DB, it knows that the noun is singular.
+*	If it isn't, it uses the noun's ending to guess at whether or not the noun is singular.
+* @param facts What the DB knows about the noun to check.
 * @return True if the noun is singular, false otherwise.
 **/
-bool mpp::ReqHandler::isSingular(std::string noun)
+bool mpp::ReqHandler::isSingular(const data::NounFacts& facts)
 {
-	bool isInDB = inDB(noun);
-	bool regMatched = regGuess(noun);
+	bool isInDB = facts.exists;
+	bool regMatched = regGuess(facts.noun);
 
 	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::isSingular: noun " << std::quoted(noun) << " is" << (isInDB ? "" : "n't") << " in the DB" << std::endl;
-	std::cout << "mpp::ReqHandler::isSingular: noun " << std::quoted(noun);
+	std::cout << "mpp::ReqHandler::isSingular: noun " << std::quoted(facts.noun) << " is" << (isInDB ? "" : "n't") << " in the DB" << std::endl;
+	std::cout << "mpp::ReqHandler::isSingular: noun " << std::quoted(facts.noun);
 
 	if (regMatched)
 	{
-		std::cout << " matched one of the singular regexes." << std::endl;
+		std::cout << " matched one of the singular suffixes." << std::endl;
 	}
 	
 	else
 	{
-		std::cout << " matched none of the singular regexes." << std::endl;
+		std::cout << " matched none of the singular suffixes." << std::endl;
 	}
 	#endif	
 
@@ -349,112 +417,58 @@ bool mpp::ReqHandler::isSingular(std::string noun)
 }
 
 /**
-* @desc Determines whether or not the given singular noun exists in the DB. It queries the DB for the noun and checks how many results there are.
-* @param noun The singular noun to check, encoded in UTF-8.
-* @return True if the singular noun is the DB, false otherwise.
+* @desc Fetches everything known about a noun: from the lexicon if there is one, otherwise from the DB in a single query.
+* @param noun The noun to look up, encoded in UTF-8.
+* @return The noun's facts, which are passed to each predicate.
 **/
-bool mpp::ReqHandler::inDB(std::string noun)
+mpp::data::NounFacts mpp::ReqHandler::getFacts(const std::string& noun)
 {
-	mariadb::u64 nRowsAff; // # of rows affected by the query. If == 1, the noun is in the DB.
-	bool toReturn = false; // Assume that it isn't in by default - which'll be true more often than not
-	int fno = 0; // Field # to load noun into in prepared statement
-
-	openDBConn(); // Open a connection for this call
-
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::inDB: noun to check is " << std::quoted(noun) << std::endl
-	<< "\tfield # = " << fno << std::endl;
-	#endif
-
-	try
-	{
- 		existStmt->set_string(fno, noun); // Load the noun into the query to make
-		mariadb::result_set_ref results = existStmt->query();
-		nRowsAff = results->row_count();
-		#ifdef DEBUG
-		std::cout << "mpp::ReqHandler::inDB: # of rows affected by existence query was " << nRowsAff << std::endl;
-		#endif
-		toReturn = (nRowsAff == 1);
-		#ifdef DEBUG
-		std::cout << "mpp::ReqHandler::inDB: nRowsAff";
-
-		if (nRowsAff == 1)
-		{
-			std::cout << " == 1";
-		}
-
-		else
-		{
-			std::cout << " != 1";
-		}
-	
-		std::cout << ", returning " << std::boolalpha << toReturn << std::noboolalpha << std::endl;
-		#endif
-	}
-
-	catch (mariadb::exception::connection& mece)
+	if (lexicon) // The snapshot holds every noun in the DB, so there's no need to ask the DB
 	{
-	/*	std::ostringstream ess;
-		ess << "mpp::ReqHandler::inDB: caught MariaDB connection exception while trying to execute query" << std::endl
-		<< "\tSELECT * FROM nouns WHERE noun=" << std::quoted(noun, '\'') << std::endl
-		<< "Exception: " << mece.what() << std::endl;
-		mpp::exceptions::DBError ex(ess.str());
-		throw ex;*/
-
-		try
-		{
-			openDBConn(); // Re-open the connection
-		}
-
-		catch (std::exception& secondEx) // Bail out if we can't re-establish the connection
-		{
-			std::ostringstream ess;
-			ess << "mpp::ReqHandler::inDB: caught MariaDB connection exception after failing to re-open the DB connection for a second time" << std::endl
-			<< "\tException: " << secondEx.what() << std::endl;
-			mpp::exceptions::DBError ex(ess.str());
-			throw ex;
-		}
+		data::LiveLexicon::Snapshot snap(*lexicon, lexReader); // The facts are copied out, so the lexicon only needs to stay pinned until this returns
+		return snap->facts(noun);
 	}
 
-	catch (std::out_of_range& stdoore)
-	{
-		std::ostringstream ess;
-		ess << "mpp::ReqHandler::inDB: caught out of range exception while trying to execute query" << std::endl
-		<< "\tSELECT COUNT(*) FROM nouns WHERE noun=" << std::quoted(noun, '\'') << std::endl
-		<< "Exception: " << stdoore.what() << std::endl;
-		mpp::exceptions::DBError ex(ess.str());
-		throw ex;
-	}
+	#ifdef DEBUG
+	std::cout << "mpp::ReqHandler::getFacts: fetching facts about " << std::quoted(noun) << " from the DB" << std::endl;
+	#endif
 
-	return toReturn;
+	return dbSess->getFacts(noun);
 }
 
 /**
-* @desc Uses regexes to guess at whether or not the noun is singular. One regex is used for each class of singular noun.
-* @param noun The noun to check, encoded in UTF-8.
-* @return True if any of the regexes for singular Malayalam nouns matches the given noun. False if none match.
+* @desc Uses the noun's ending to guess at whether or not the noun is singular. One suffix is checked for each class of singular noun.
+* @param noun The noun to check, encoded in UTF-8. Must be the noun whose ending is in nounShape.
+* @return True if any of the suffixes for singular Malayalam nouns matches the given noun. False if none match.
 **/
 bool mpp::ReqHandler::regGuess(std::string noun)
 {
-	ARRAY_CLASS<bool, NDECLREGS+2> matchRes; // Holds whether or not each singular regex matched the noun
-	ARRAY_CLASS<boost::smatch, NDECLREGS+2> what; // Holds what matched (unused, but a necessary parameter for boost::u32regex_match
+	ARRAY_CLASS<bool, NDECLREGS+2> matchRes; // Holds whether or not each singular rule matched the noun
+	const SuffixClassifier::Result& shape = nounShape;
+	ARRAY_CLASS<SuffixClassifier::Rule, NDECLREGS> declRules { // The rules used to guess what declension a noun falls into
+		SuffixClassifier::EndsInAn, // an-stem
+		SuffixClassifier::EndsInAm, // am-stem
+		SuffixClassifier::EndsInRuh, // ruh-stem
+		SuffixClassifier::EndsInDuh, // duh-stem
+		SuffixClassifier::EndsInVirama // schwa-stem
+	};
 	#ifdef DEBUG
-	unsigned short regNum = 1; // Regex #, for printing
+	unsigned short regNum = 1; // Rule #, for printing
 	#endif
 
-	std::transform(declRegs.cbegin(), declRegs.cend(), what.begin(), matchRes.begin(),
-		[&](const boost::u32regex& reg, boost::smatch& whatMatched) -> bool // Check whether the current regex matches the noun. Store the match results (ignored) in what, and the boolean in matchRes.
+	std::transform(declRules.cbegin(), declRules.cend(), matchRes.begin(),
+		[&](SuffixClassifier::Rule r) -> bool // Check whether the current rule matched the noun, and store the boolean in matchRes
 		{
-			bool toReturn = boost::u32regex_match(noun, whatMatched, reg); // Attempt to match this regex
+			bool toReturn = shape.has(r);
 			#ifdef DEBUG
-			std::cout << "mpp::ReqHandler::regGuess: lambda 1: regex #" << regNum << (toReturn ? " matched" : " didn't match") << " noun " << std::quoted(noun) << std::endl;
+			std::cout << "mpp::ReqHandler::regGuess: lambda 1: rule #" << regNum << (toReturn ? " matched" : " didn't match") << " noun " << std::quoted(noun) << std::endl;
 			++regNum;
 			#endif
 			return toReturn;
 		}
 	);
 	 
-	matchRes.at(matchRes.size()-1) = boost::u32regex_match(noun, what.at(what.size()-1), boost::make_u32regex(".*\\x{d7e}$")) && !boost::u32regex_match(noun, what.back(), boost::make_u32regex(".*\\x{d15}\\x{d7e}$")); // Retroflex l-stems are a special case, since we need to distinguish a plural -കൾ suffix from a singular noun that ends in -ൾ . Thus, we look for a match with a regex that ends in ൾ, and a non-match with a regex that matches a final -കൾ
+	matchRes.at(matchRes.size()-2) = shape.has(SuffixClassifier::EndsInRetroflexL) && !shape.has(SuffixClassifier::EndsInKaL); // Retroflex l-stems are a special case, since we need to distinguish a plural -കൾ suffix from a singular noun that ends in -ൾ . Thus, we look for a noun that ends in ൾ, but not in -കൾ
 	
 	#ifdef DEBUG
 	if (matchRes.at(matchRes.size()-2))
@@ -482,56 +496,33 @@ bool mpp::ReqHandler::regGuess(std::string noun)
 	}
 	#endif
 
-	return std::accumulate(matchRes.cbegin(), matchRes.cend(), false, std::logical_or{}); // OR will be true if any regex matched
+	return std::accumulate(matchRes.cbegin(), matchRes.cend(), false, std::logical_or{}); // OR will be true if any rule matched
 }
 
 /**
-* @desc Searches the DB to see whether or not this noun is pluralisable.
-* @param noun The Malayalam noun to find the plural of. It must be a UTF-8 encoded string, with codepoints in the range 0xd00 to 0xd7f.
+* @desc Uses the noun's facts to see whether or not this noun is pluralisable.
+* @param facts What the DB knows about the noun to find the plural of.
 * @return True if the noun is in the DB and has a TRUE 'pluralisable' attribute, false if the noun has no plural form, indeterminate otherwise.
 **/
-boost::logic::tribool mpp::ReqHandler::hasPlural(std::string noun)
+boost::logic::tribool mpp::ReqHandler::hasPlural(const data::NounFacts& facts)
 {
 	boost::logic::tribool toReturn = true;
 
-	if (inDB(noun)) // We can check whether or not this noun is pluralisable, since it's in the DB
+	if (facts.exists) // We can check whether or not this noun is pluralisable, since it's in the DB
 	{
 		#ifdef DEBUG
-		std::cout << "mpp::ReqHandler::hasPlural: noun " << std::quoted(noun) << " is in the DB" << std::endl;
+		std::cout << "mpp::ReqHandler::hasPlural: noun " << std::quoted(facts.noun) << " is in the DB, and is" << (facts.pluralisable ? "" : "n't") << " pluralisable" << std::endl;
 		#endif
-		hasPluralStmt->set_string(0, noun); // Load the noun into the prepared statement
-
-		try
-		{
-			mariadb::result_set_ref qRes = hasPluralStmt->query(); // Run the query
-			
-			while (qRes->next())
-			{
-				#ifdef DEBUG
-				std::cout << "mpp::ReqHandler::hasPlural->if->try->while: current noun is" << (qRes->get_boolean("pluralisable") ? "" : "n't") << " pluralisable" << std::endl;
-				#endif
-				toReturn = toReturn && qRes->get_boolean("pluralisable");
-			}
-		}
-
-		catch (mariadb::exception::connection& mece)
-		{
-			std::ostringstream ess;
-			ess << "mpp::ReqHandler::hasPlural: caught MariaDB connection exception while trying to execute query" << std::endl
-			<< "\tSELECT pluralisable FROM nouns WHERE noun=" << std::quoted(noun, '\'') << std::endl
-			<< "Exception: " << mece.what() << std::endl;
-			mpp::exceptions::DBError ex(ess.str());
-			throw ex;
-		}
+		toReturn = facts.pluralisable;
 	}
 
 	else // Unknown
 	{
 		#ifdef DEBUG
-		std::cout << "mpp::ReqHandler::hasPlural: noun " << std::quoted(noun) << u8" isn't in the DB. Checking whether or not it's \u0d2a\u0d47\u0d7c" << std::endl;
+		std::cout << "mpp::ReqHandler::hasPlural: noun " << std::quoted(facts.noun) << u8" isn't in the DB. Checking whether or not it's \u0d2a\u0d47\u0d7c" << std::endl;
 		#endif
 
-		toReturn = (noun != u8"\u0d2a\u0d47\u0d7c"); // Only the noun പേർ lacks a plural
+		toReturn = (facts.noun != u8"\u0d2a\u0d47\u0d7c"); // Only the noun പേർ lacks a plural
 	}
 
 	return toReturn;
@@ -539,50 +530,27 @@ boost::logic::tribool mpp::ReqHandler::hasPlural(std::string noun)
 
 /**
 * @desc Given a SINGULAR noun, finds its plural form. A vector is returned because a noun may have multiple plural forms.
-* @param noun The SINGULAR noun to find the plural of. The noun ISN'T CHECKED for singularity.
+* @param facts What the DB knows about the SINGULAR noun to find the plural of. The noun ISN'T CHECKED for singularity.
 * @return The plural form of the noun or all plural forms of the noun.
 **/
-std::vector<std::string> mpp::ReqHandler::findPlural(std::string noun)
+std::vector<std::string> mpp::ReqHandler::findPlural(const data::NounFacts& facts)
 {
+	const std::string& noun = facts.noun; // Most of the rules only need the text
 	std::vector<std::string> toReturn;
-	ARRAY_CLASS<boost::smatch, 2> what; // Holds what matched a regex. Unused - only used as a dummy parameter
-	boost::u32regex endsInLongA = boost::make_u32regex(".*\\x{d3e}$"); // A noun that ends in /a:/
-	boost::u32regex endsInSyllabicR = boost::make_u32regex(".*\\x{d43}$"); // A noun that ends in a short syllabic /r/
-	boost::logic::tribool isH = isHuman(noun);
-	boost::logic::tribool isE = isException(noun);
+	const SuffixClassifier::Result& shape = nounShape;
+	boost::logic::tribool isH = isHuman(facts);
+	boost::logic::tribool isE = isException(facts);
 
 	if (isE == true) // This noun has an exceptional plural
 	{
 		#ifdef DEBUG
 		std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << " has an exceptional plural" << std::endl;
 		#endif
-		exceptionStmt->set_string(0, noun); // Load the noun into the statement
 
-		try
-		{
-			mariadb::result_set_ref qRes = exceptionStmt->query(); // Find its plural using the prepared statement
-			#ifdef DEBUG
-			std::cout << "mpp::ReqHandler::findPlural: # of results = " << qRes->row_count() << std::endl;
-			#endif
-
-			while (qRes->next())
-			{
-				std::string pluralForm = qRes->get_string("plural");
-				toReturn.push_back(pluralForm); // Find the noun's plural and store it
-				#ifdef DEBUG
-				std::cout << "mpp::ReqHandler::findPlural: isH: isE: try: while: added plural form " << std::quoted(pluralForm) << std::endl;
-				#endif
-			}
-		}
-
-		catch (mariadb::exception::connection& mece)
-		{
-			std::ostringstream ess;
-			ess << "mpp::ReqHandler::findPlural: exceptional noun with human referent check: caught connection error\n"
-			<< "\t" << mece.what() << "\n";
-			mpp::exceptions::DBError ex(ess.str());
-			throw ex;
-		}
+		toReturn = facts.exceptionalPlurals; // Already fetched along with everything else
+		#ifdef DEBUG
+		std::cout << "mpp::ReqHandler::findPlural: # of results = " << toReturn.size() << std::endl;
+		#endif
 	}
 
 	else // This noun has a regular plural
@@ -593,7 +561,7 @@ std::vector<std::string> mpp::ReqHandler::findPlural(std::string noun)
 			std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << " has a human referent" << std::endl;
 			#endif
 	
-			Gender g = getGender(noun); // The plural form depends on the noun's gender
+			Gender g = getGender(facts); // The plural form depends on the noun's gender
 
 			switch (g)
 			{
@@ -603,15 +571,15 @@ std::vector<std::string> mpp::ReqHandler::findPlural(std::string noun)
 					std::cout << "mpp::ReqHandler::findPlural: isH: the noun " << std::quoted(noun) << " is masculine." << std::endl;
 					#endif
 
-					if (boost::u32regex_match(noun, what[0], endsInLongA) || boost::u32regex_match(noun, what[1], endsInSyllabicR)) // Add the suffix -ക്കൾ
+					if (shape.has(SuffixClassifier::EndsInLongA | SuffixClassifier::EndsInSyllabicR)) // Add the suffix -ക്കൾ
 					{
 						toReturn.push_back(noun + u8"\u0d15\u0d4d\u0d15\u0d7e");
 					}
 	
-					else if (boost::u32regex_match(noun, endsInKaar)) // This must be a -kaaran noun, since getGender already identified it as masculine
+					else if (shape.stem == SuffixClassifier::KaaranStem) // This must be a -kaaran noun, since getGender already identified it as masculine
 					{
-						toReturn.push_back(noun + u8"\u0d2e\u0d3e\u0d7c"); // One possible plural is a -maar form
-						toReturn.push_back(boost::u32regex_replace(noun, boost::make_u32regex("(.*)\\x{d30}\\x{d7b}"), u8"$1\u0d7c")); // Replace final -ran with chillu -r
+						toReturn.push_back(SuffixClassifier::apply(noun, shape.rewrites[0])); // One possible plural is a -maar form
+						toReturn.push_back(SuffixClassifier::apply(noun, shape.rewrites[1])); // Replace final -ran with chillu -r
 					}
 	
 					else // All other masculine nouns
@@ -628,27 +596,24 @@ std::vector<std::string> mpp::ReqHandler::findPlural(std::string noun)
 					std::cout << "mpp::ReqHandler::findPlural: isH: the noun " << std::quoted(noun) << " is feminine." << std::endl;
 					#endif
 
-					boost::u32regex endsInA = boost::make_u32regex(".*[\\x{d15}-\\x{d3a}]$"); // Any noun that ends in a consonant that has no vowel sign after it ends in an /a/, since /a/ is the default vowel
-					boost::u32regex endsInShortI = boost::make_u32regex(".*\\x{d3f}$"); // A noun that ends in /i/
-	
-					if (boost::u32regex_match(noun, what[0], endsInA))
+					if (shape.has(SuffixClassifier::EndsInConsonant))
 					{
 						toReturn.push_back(noun + u8"\u0d2e\u0d3e\u0d7c"); // Add the suffix -maar
 					}
 	
-					else if (boost::u32regex_match(noun, what[0], endsInShortI)) // These nouns can take either -maar or -kaL
+					else if (shape.has(SuffixClassifier::EndsInShortI)) // These nouns can take either -maar or -kaL
 					{
 						toReturn.push_back(noun + u8"\u0d2e\u0d3e\u0d7c"); // Add the suffix -മാർ
 						toReturn.push_back(noun + u8"\u0d15\u0d7e"); // Add the suffix -കൾ
 					}
 	
-					else if (boost::u32regex_match(noun, endsInKaar)) // This must be a -kaari noun, since getGender already identified it as feminine
+					else if (shape.stem == SuffixClassifier::KaariStem) // This must be a -kaari noun, since getGender already identified it as feminine
 					{
-						toReturn.push_back(noun + u8"\u0d2e\u0d3e\u0d7c"); // One possible plural is a -maar form
-						toReturn.push_back(boost::u32regex_replace(noun, boost::make_u32regex("\\x{d30}\\x{d3f}"), u8"\u0d7c")); // Replace final -ri with chillu -r
+						toReturn.push_back(SuffixClassifier::apply(noun, shape.rewrites[0])); // One possible plural is a -maar form
+						toReturn.push_back(SuffixClassifier::apply(noun, shape.rewrites[1])); // Replace final -ri with chillu -r
 					}
 	
-					else if (boost::u32regex_match(noun, what[0], endsInLongA) || boost::u32regex_match(noun, what[1], endsInSyllabicR)) // Add the suffix -ക്കൾ
+					else if (shape.has(SuffixClassifier::EndsInLongA | SuffixClassifier::EndsInSyllabicR)) // Add the suffix -ക്കൾ
 					{
 						toReturn.push_back(noun + u8"\u0d15\u0d4d\u0d15\u0d7e");
 					}
@@ -679,9 +644,7 @@ std::vector<std::string> mpp::ReqHandler::findPlural(std::string noun)
 			std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << " doesn't have a human referent." << std::endl;
 			#endif
 		
-			boost::u32regex endsInAlveolarN = boost::make_u32regex(".*\\x{d7b}$");
-	
-			if (isAnimate(noun) == true && boost::u32regex_match(noun, endsInAlveolarN)) // This noun has an animate referent
+			if (isAnimate(facts) == true && shape.has(SuffixClassifier::EndsInAn)) // This noun has an animate referent
 			{
 				#ifdef DEBUG
 				std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << u8" is animate and ends in \u0d7b." << std::endl;
@@ -694,44 +657,36 @@ std::vector<std::string> mpp::ReqHandler::findPlural(std::string noun)
 				#ifdef DEBUG
 				std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << " is neither animate nor human." << std::endl;
 				#endif
-				boost::u32regex isAmStem = boost::make_u32regex(".*\\x{d02}$"); // Matches a noun that ends in an anusvara
-				boost::u32regex endsInSchwa = boost::make_u32regex(".*\\x{d4d}$"); // Matches a noun that ends in a schwa
-				boost::u32regex cvcuReg = boost::make_u32regex("[\\x{d15}-\\x{d3a}]((?:)|[\\x{d3e}-\\x{d4e}])[\\x{d15}-\\x{d3a}]\\x{d41}"); // Matches a noun of the form CVCu
-				boost::u32regex cLongVReg = boost::make_u32regex("[\\x{d15}-\\x{d3a}][\\x{d3e}|\\x{d40}|\\x{d42}|\\x{d44}|\\x{d47}|\\x{d4b}]"); // Matches a noun of the form C[long V]
-	
-				if (boost::u32regex_match(noun, isAmStem)) // Replace -am with -anngal
+				if (shape.stem == SuffixClassifier::AmStem) // Replace -am with -anngal
 				{
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << " ends in \u0d02" << std::endl;
 					#endif
-					boost::u32regex replaceAmStem = boost::make_u32regex("(.*)\\x{d02}$"); // Capture everything before the final -am
-					std::string pluralForm = boost::u32regex_replace(noun, replaceAmStem, u8"$1\u0d19\u0d4d\u0d19\u0d7e");
+					std::string pluralForm = SuffixClassifier::apply(noun, shape.rewrites[0]);
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::findPlural: the plural form of " << std::quoted(noun) << " is " << std::quoted(pluralForm) << std::endl;
 					#endif
 					toReturn.push_back(pluralForm);
 				}
 	
-				else if (boost::u32regex_match(noun, endsInSchwa)) // Replace schwa with /u/ and add suffix -kaL
+				else if (shape.stem == SuffixClassifier::SchwaStem) // Replace schwa with /u/ and add suffix -kaL
 				{
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << " ends in a schwa" << std::endl;
 					#endif
-					boost::u32regex replaceSchwa = boost::make_u32regex("(.*)\\x{d4d}$"); // Capture everything before the schwa
-					std::string nounWithU = boost::u32regex_replace(noun, replaceSchwa, u8"$1\u0d41"); // Replace schwa with /u/
-					std::string plural = nounWithU + u8"\u0d15\u0d7e"; // Add the suffix -kaL
+					std::string plural = SuffixClassifier::apply(noun, shape.rewrites[0]); // Replace schwa with /u/ and add the suffix -kaL
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << "'s plural is " << std::quoted(plural) << std::endl;
 					#endif
 					toReturn.push_back(plural); // Store it
 				}
 	
-				else if (boost::u32regex_match(noun, cvcuReg) || boost::u32regex_match(noun, cLongVReg)) // Noun in the form CVCu or C[long V]
+				else if (shape.stem == SuffixClassifier::ShortStem) // Noun in the form CVCu or C[long V]
 				{
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::findPlural: the noun " << std::quoted(noun) << " is in the form CVCu or C[long V]" << std::endl;
 					#endif
-					std::string plural = noun + u8"\u0d15\u0d4d\u0d15\u0d7e"; // Add the suffix -kkaL
+					std::string plural = SuffixClassifier::apply(noun, shape.rewrites[0]); // Add the suffix -kkaL
 					#ifdef DEBUG
 					std::cout << "mpp::ReqHandler::findPlural: the plural of the noun " << std::quoted(noun) << " is " << std::quoted(plural) << std::endl;
 					#endif
@@ -767,37 +722,17 @@ bool mpp::ReqHandler::hasSingular(std::string noun)
 }
 
 /**
-* @desc Uses the DB to determine whether or not the given noun is animate.
-* @param noun The noun to check. Malayalam text, encoded in UTF-8.
+* @desc Uses the noun's facts to determine whether or not the given noun is animate.
+* @param facts What the DB knows about the noun to check.
 * @return True if the noun is animate, false if it isn't, boost::indeterminate if it isn't in the DB.
 **/
-boost::logic::tribool mpp::ReqHandler::isAnimate(std::string noun)
+boost::logic::tribool mpp::ReqHandler::isAnimate(const data::NounFacts& facts)
 {
 	bool toReturn = true;
 
-	if (inDB(noun)) // The noun is in the DB
+	if (facts.exists) // The noun is in the DB
 	{
-		isAnimateStmt->set_string(0, noun); // Load the noun into the prepared statement
-
-		try
-		{
-			mariadb::result_set_ref qRes = isAnimateStmt->query(); // Fetch the noun's animacy
-
-			while (qRes->next()) // Should only run once, but still
-			{
-				toReturn = toReturn && qRes->get_boolean("animate"); // AND it to ensure that a single false stops the entire thing
-			}
-		}
-
-		catch (mariadb::exception::connection& mece)
-		{
-			std::ostringstream ess;
-			ess << "mpp::ReqHandler::isAnimate: caught MariaDB connection exception while trying to execute query" << std::endl
-			<< "\tSELECT nouns.*,animacies.animate FROM nouns LEFT JOIN animacies ON animacies.id=nouns.id WHERE nouns.noun=" << std::quoted(noun, '\'') << std::endl
-			<< "Exception: " << mece.what() << std::endl;
-			mpp::exceptions::DBError ex(ess.str());
-			throw ex;
-		}
+		toReturn = facts.animate;
 	}
 
 	else // We don't know
@@ -809,42 +744,22 @@ boost::logic::tribool mpp::ReqHandler::isAnimate(std::string noun)
 }
 
 /**
-* @desc Uses the DB to determine whether or not the given noun refers to a human.
-* @param noun The noun to check. Malayalam text, encoded in UTF-8.
+* @desc Uses the noun's facts to determine whether or not the given noun refers to a human.
+* @param facts What the DB knows about the noun to check.
 * @return True if the noun refers to a human, false if it doesn't, boost::indeterminate if it isn't in the DB.
 **/
-boost::logic::tribool mpp::ReqHandler::isHuman(std::string noun)
+boost::logic::tribool mpp::ReqHandler::isHuman(const data::NounFacts& facts)
 {
 	boost::logic::tribool toReturn = true;
 
-	if (inDB(noun)) // The noun is in the DB
+	if (facts.exists) // The noun is in the DB
 	{
-		isHumanStmt->set_string(0, noun);
-
-		try
-		{
-			mariadb::result_set_ref qRes = isHumanStmt->query(); // Fetch the noun's animacy
-
-			while (qRes->next()) // Should only run once, but still
-			{
-				toReturn = toReturn && qRes->get_boolean("humanity"); // AND it to ensure that a single false stops the entire thing
-			}
-		}
-
-		catch (mariadb::exception::connection& mece)
-		{
-			std::ostringstream ess;
-			ess << "mpp::ReqHandler::isHuman: caught MariaDB connection exception while trying to execute query" << std::endl
-			<< "\tSELECT nouns.*,humanNouns.humanity FROM nouns LEFT JOIN humanNouns ON humanNouns.id=nouns.id WHERE nouns.noun=" << std::quoted(noun, '\'') << std::endl
-			<< "Exception: " << mece.what() << std::endl;
-			mpp::exceptions::DBError ex(ess.str());
-			throw ex;
-		}
+		toReturn = facts.human;
 	}
 
 	else // Unknown unless its a -kaaran/-kaari noun
 	{
-		if (boost::u32regex_match(noun, endsInKaar)) // The noun ends in -കാരൻ or -കാരി
+		if (nounShape.has(SuffixClassifier::EndsInKaaran | SuffixClassifier::EndsInKaari)) // The noun ends in -കാരൻ or -കാരി
 		{
 			toReturn = true;
 		}
@@ -860,64 +775,56 @@ boost::logic::tribool mpp::ReqHandler::isHuman(std::string noun)
 
 /**
 * @desc Finds the gender of the given noun.
-* @param noun The noun to fetch the gender of. Malayalam text, encoded in UTF-8.
+* @param facts What the DB knows about the noun to fetch the gender of.
 * @return An enum value representing the noun's gender (masculine, feminine, or neuter).
 * @note Although most members return a tribool instead of throwing an exception if the noun isn't in the DB, this method throws an exception.
 *	I chose to do this because this method should only be called when it's already known that the noun exists in the DB,
 *	and more importantly, because I want to return a proper Gender type instead of a tribool.
 **/
-mpp::ReqHandler::Gender mpp::ReqHandler::getGender(std::string noun)
+mpp::ReqHandler::Gender mpp::ReqHandler::getGender(const data::NounFacts& facts)
 {
 	Gender toReturn = Unknown;
 	
-	if (inDB(noun)) // The noun is in the DB
+	if (facts.exists) // The noun is in the DB
 	{
-		getGenderStmt->set_string(0, noun); // Load the noun into the prepared statement
-		
-		try
+		switch (facts.gender)
 		{
-			mariadb::result_set_ref qRes = getGenderStmt->query(); // Run the query
-
-			while (qRes->next())
+			case data::Masculine:
 			{
-				std::string genStr = qRes->get_string("gender"); // Fetch the gender as a string
-				
-				if (genStr == "Masculine")
-				{
-					toReturn = Masculine;
-				}
+				toReturn = Masculine;
+				break;
+			}
 
-				else if (genStr == "Feminine")
-				{
-					toReturn = Feminine;
-				}
+			case data::Feminine:
+			{
+				toReturn = Feminine;
+				break;
+			}
 
-				else
-				{
-					toReturn = Neuter;
-				}
+			case data::Neuter:
+			{
+				toReturn = Neuter;
+				break;
 			}
-		}
 
-		catch (mariadb::exception::connection& mece)
-		{
-			std::ostringstream ess;
-			ess << "mpp::ReqHandler::getGender: caught MariaDB connection exception while trying to execute query" << std::endl
-			<< "\tSELECT nouns.id,genders.gender FROM nouns JOIN genders ON nouns.id=genders.id WHERE nouns.noun=" << std::quoted(noun, '\'') << std::endl
-			<< "Exception: " << mece.what() << std::endl;
-			mpp::exceptions::DBError ex(ess.str());
-			throw ex;
+			default: // No row in the genders table
+			{
+				toReturn = Unknown;
+				break;
+			}
 		}
 	}
 
 	else // Error
 	{
-		if (boost::u32regex_match(noun, boost::make_u32regex(".*\\x{d15}\\x{d3e}\\x{d30}\\x{d7b}"))) // -kaaran is masculine
+		const SuffixClassifier::Result& shape = nounShape;
+
+		if (shape.has(SuffixClassifier::EndsInKaaran)) // -kaaran is masculine
 		{
 			toReturn = Masculine;
 		}
 
-		else if (boost::u32regex_match(noun, boost::make_u32regex(".*\\x{d15}\\x{d3e}\\x{d30}\\x{d3f}"))) // -kaari is feminine
+		else if (shape.has(SuffixClassifier::EndsInKaari)) // -kaari is feminine
 		{
 			toReturn = Feminine;
 		}
@@ -925,7 +832,7 @@ mpp::ReqHandler::Gender mpp::ReqHandler::getGender(std::string noun)
 		else // Unknown
 		{
 			std::ostringstream ess;
-			ess << "mpp::ReqHandler::getGender: noun " << std::quoted(noun, '\'') << " doesn't exist in the DB!";
+			ess << "mpp::ReqHandler::getGender: noun " << std::quoted(facts.noun, '\'') << " doesn't exist in the DB!";
 			mpp::exceptions::UnknownNoun ex(ess.str());
 			throw ex;
 		}
@@ -936,14 +843,14 @@ mpp::ReqHandler::Gender mpp::ReqHandler::getGender(std::string noun)
 
 /**
 * @desc Determines whether or not a noun ends in a vowel.
-* @param noun The noun to check. Must be UTF-8 encoded Malayalam text.
+* @param noun The noun to check. Must be UTF-8 encoded Malayalam text, and the noun whose ending is in nounShape.
 * @return True if the noun is a vowel stem, false otherwise.
 **/
 bool mpp::ReqHandler::isVowelStem(std::string noun)
 {
-	ARRAY_CLASS<boost::smatch, 2> what;
-	bool doesntEndInChillu = boost::u32regex_match(noun, what.at(what.size()-1), boost::make_u32regex(".*[^\\x{d7a}-\\x{d7f}]$"));
-	bool doesntEndInSchwa = boost::u32regex_match(noun, what.back(), boost::make_u32regex(".*[^\\x{d4d}]$"));
+	const SuffixClassifier::Result& shape = nounShape;
+	bool doesntEndInChillu = shape.has(SuffixClassifier::EndsInNonChillu);
+	bool doesntEndInSchwa = shape.has(SuffixClassifier::EndsInNonVirama);
 	bool isIva = (noun == u8"\u0d07\u0d35"); // iva is a special case - it's a vowel stem, but it's plural
 	bool isAva = (noun == u8"\u0d05\u0d35"); // ava is also a special case, for the same reason as iva
 	//return doesntEndInChillu && doesntEndInSchwa && !(isIva || isAva); // A vowel-stem must NOT end in a chillu AND must NOT end in a schwa AND must NOT be (iva OR ava)
@@ -952,113 +859,66 @@ bool mpp::ReqHandler::isVowelStem(std::string noun)
 
 /**
 * @desc Determines whether or not a singular noun has an exceptional plural.
-* @param noun The singular noun to check. Must be UTF-8 encoded Malayalam text.
+* @param facts What the DB knows about the singular noun to check.
 * @return True if the singular noun has an exceptional plural, false if it doesn't, and boost::indeterminate if it isn't in the DB.
 **/
-boost::logic::tribool mpp::ReqHandler::isException(std::string noun)
+boost::logic::tribool mpp::ReqHandler::isException(const data::NounFacts& facts)
 {
-	boost::logic::tribool toReturn = true; // Default to true so that a single AND with a 'false' value will set it to false
-	#ifdef DEBUG
-	std::cout << "mpp::ReqHandler::isException: the noun to check is " << std::quoted(noun) << std::endl
-	<< "\ttoReturn = " << std::boolalpha << toReturn << std::noboolalpha << std::endl;
-	#endif
+	boost::logic::tribool toReturn = true;
 
-	if (inDB(noun)) // The noun is in the DB
+	if (facts.exists) // The noun is in the DB
 	{
-		#ifdef DEBUG
-		std::cout << "mpp::ReqHandler::isException: the noun " << std::quoted(noun) << " is in the DB" << std::endl;
-		#endif
-		exceptionStmt->set_string(0, noun); // Load the noun into the prepared statement
-		
-		try
-		{
-			mariadb::result_set_ref qRes = exceptionStmt->query(); // Run the query
-			#ifdef DEBUG
-			std::cout << "mpp::ReqHandler::isException: # of results found = " << qRes->row_count() << std::endl;
-			int pno = 1; // # of current plural form
-			#endif
-
-			if (qRes->row_count() > 0) // The query returned results
-			{
-				while (qRes->next())
-				{
-					std::string pluralStr = qRes->get_string("plural"); // Fetch the noun's stored plural (or empty string)
-					#ifdef DEBUG
-					std::cout << "mpp::ReqHandler::isException: plural #" << pno << " of noun " << std::quoted(noun) << " is " << std::quoted(pluralStr) << std::endl
-					<< "\ttoReturn = " << std::boolalpha << toReturn << " && " << !pluralStr.empty() << " (" << (toReturn && !pluralStr.empty()) << std::noboolalpha << std::endl;
-					#endif
-					toReturn = toReturn && !pluralStr.empty(); // A noun has an irregular plural if the stored string isn't empty
-				}
-			}
-
-			else // No results - the noun must have a regular plural, since it's in the DB but lacks an exceptional plural
-			{
-				toReturn = false;
-			}
-		}
-
-		catch (mariadb::exception::connection& mece)
-		{
-			std::ostringstream ess;
-			ess << "mpp::ReqHandler::isException: caught MariaDB connection exception while trying to execute query" << std::endl
-			<< "SELECT nouns.id,nouns.noun,exceptions.plural FROM nouns JOIN exceptions ON exceptions.id=nouns.id WHERE nouns.noun=" << std::quoted(noun, '\'') << std::endl
-			<< "Exception: " << mece.what() << std::endl;
-			mpp::exceptions::DBError ex(ess.str());
-			throw ex;
-		}
+		toReturn = facts.exceptional;
 	}
 
 	else // The noun isn't in the DB
 	{
-		#ifdef DEBUG
-		std::cout << "mpp::ReqHandler::isException: the noun " << std::quoted(noun) << " isn't in the DB, returning ";
-		#endif
 		toReturn = boost::indeterminate;
-		#ifdef DEBUG
-		std::cout << toReturn << std::endl;
-		#endif
 	}
 
+	#ifdef DEBUG
+	std::cout << "mpp::ReqHandler::isException: the noun " << std::quoted(facts.noun) << (facts.exists ? " is" : " isn't") << " in the DB, returning " << toReturn << std::endl;
+	#endif
+
 	return toReturn;
 }
 
 /**
 * @desc Finds the singular form of a noun, given the plural form.
-* @param noun The noun to find the singular form of. Must be UTF-8 encoded Malayalam text.
+* @param facts What the DB knows about the noun to find the singular form of.
 * @return 1 or more UTF-8 encoded Malayalam strings containing the noun's singular form(s).
 **/
-std::vector<std::string> mpp::ReqHandler::findSingular(std::string noun)
+std::vector<std::string> mpp::ReqHandler::findSingular(const data::NounFacts& facts)
 {
-	/* First, try regexes */
+	const std::string& noun = facts.noun; // Most of the rules only need the text
+
+	/* First, try the noun's ending */
 	std::vector<std::string> toReturn;
+	const SuffixClassifier::Result& shape = nounShape;
 	
-	if (boost::u32regex_match(noun, boost::make_u32regex(".*\\x{d15}\\x{d7e}$"))) // Plural noun ending in kaL
+	if (shape.has(SuffixClassifier::EndsInKaL)) // Plural noun ending in kaL
 	{
-		boost::u32regex kaLfinder = boost::make_u32regex("(.*)\\x{d15}\\x{d7e}"); // Capture everything before the -kaL
-		std::string replacement = "$1"; // Just keep everything except the kaL
-		toReturn.push_back(boost::u32regex_replace(noun, kaLfinder, replacement));
+		toReturn.push_back(SuffixClassifier::withoutSuffix(noun, SuffixClassifier::EndsInKaL)); // Just keep everything except the kaL
 	}
 
-	else if (boost::u32regex_match(noun, boost::make_u32regex(".*\\x{d2e}\\x{d3e}\\x{d7c}"))) // Plural ending in -maar
+	else if (shape.has(SuffixClassifier::EndsInMaar)) // Plural ending in -maar
 	{
-		boost::u32regex stemFinder = boost::make_u32regex("(.*)\\x{d2e}\\x{d3e}\\x{d7c}"); // Capture everything before the -maar
-		toReturn.push_back(boost::u32regex_replace(noun, stemFinder, "$1")); // Return everything before the -maar
+		toReturn.push_back(SuffixClassifier::withoutSuffix(noun, SuffixClassifier::EndsInMaar)); // Return everything before the -maar
 	}
 
-	else if (boost::u32regex_match(noun, boost::make_u32regex(".*\\x{d15}\\x{d4d}\\x{d15}\\x{d7e}"))) // Plural ending in -kkaL
+	else if (shape.has(SuffixClassifier::EndsInKkaL)) // Plural ending in -kkaL
 	{
-		boost::u32regex stemFinder = boost::make_u32regex("(.*)\\x{d15}\\x{d4d}\\x{d15}\\x{d7e}"); // Capture everything before the -kkaL
-		toReturn.push_back(boost::u32regex_replace(noun, stemFinder, "$1")); // Return everything before the -kkaL
+		toReturn.push_back(SuffixClassifier::withoutSuffix(noun, SuffixClassifier::EndsInKkaL)); // Return everything before the -kkaL
 	}
 
-	else if (boost::u32regex_match(noun, boost::make_u32regex(".*\\x{d15}\\x{d3e}\\x{d7c}"))) // Noun ending in -kaar
+	else if (shape.has(SuffixClassifier::EndsInKaarPlural)) // Noun ending in -kaar
 	{
 		/* There are masculine and feminine singular forms, since this is an epicene plural */
 		toReturn.push_back(noun + u8"\u0d7b"); // Masculine singular
 		toReturn.push_back(noun + u8"\u0d3f"); // Feminine singular
 	}
 
-	else if (boost::u32regex_match(noun, boost::make_u32regex("[\\x{d05}|\\x{d07}]\\x{d35}\\x{d7c}"))) // ivar or avar
+	else if (shape.has(SuffixClassifier::IsIvarAvar)) // ivar or avar
 	{
 		/* The plural corresponds to either the masculine or feminine singular pronoun, so we need to add both to the vector */
 		if (noun == u8"\u0d07\u0d35\u0d7c") // ivar
@@ -1074,28 +934,9 @@ std::vector<std::string> mpp::ReqHandler::findSingular(std::string noun)
 		}
 	}
 
-	else if (isExceptionalPlural(noun) == true) // Need to check the DB
+	else if (isExceptionalPlural(facts) == true) // The DB knows its singular form(s)
 	{
-		try
-		{
-			exSingStmt->set_string(0, noun); // Load the noun into the string
-			mariadb::result_set_ref qRes = exSingStmt->query(); // Find its plural using the prepared statement
-
-			while (qRes->next())
-			{
-				toReturn.push_back(qRes->get_string("noun")); // Find the noun's singular form and store it
-			}
-		}
-
-		catch (mariadb::exception::connection& mece)
-		{
-			std::ostringstream ess;
-			ess << "mpp::ReqHandler::isExceptionalPlural: caught MariaDB connection exception while trying to execute query" << std::endl
-			<< "\tSELECT * FROM nouns WHERE noun=" << std::quoted(noun, '\'') << std::endl
-			<< "Exception: " << mece.what() << std::endl;
-			mpp::exceptions::DBError ex(ess.str());
-			throw ex;
-		}
+		toReturn = facts.exceptionalSingulars; // Already fetched along with everything else
 	}
 
 	else // Not a known stem type, and not in the DB. Therefore, we can't guess.
@@ -1111,25 +952,10 @@ std::vector<std::string> mpp::ReqHandler::findSingular(std::string noun)
 
 /**
 * @desc Determines whether or not a string contains the plural form of an exceptional noun.
-* @param noun A UTF-8 encoded Malayalam noun which may or may not be the plural form of an exceptional noun.
-* @return True if the noun has an exceptional plural, false if it doesn't, and boost::indeterminate if it isn't in the DB.
+* @param facts What the DB knows about a noun which may or may not be the plural form of an exceptional noun.
+* @return True if the noun is the plural of an exceptional noun, false otherwise.
 **/
-boost::logic::tribool mpp::ReqHandler::isExceptionalPlural(std::string noun)
+boost::logic::tribool mpp::ReqHandler::isExceptionalPlural(const data::NounFacts& facts)
 {
-	try
-	{
-		exSingStmt->set_string(0, noun); // Load the noun into the prepared statement
-		mariadb::u64 rowsAff = exSingStmt->execute();
-		return (rowsAff != 0);
-	}
-
-	catch (mariadb::exception::connection& mece)
-	{
-		std::ostringstream ess;
-		ess << "mpp::ReqHandler::isExceptionalPlural: caught MariaDB connection exception while trying to execute query" << std::endl
-		<< "\tSELECT * FROM nouns WHERE noun=" << std::quoted(noun, '\'') << std::endl
-		<< "Exception: " << mece.what() << std::endl;
-		mpp::exceptions::DBError ex(ess.str());
-		throw ex;
-	}
+	return !facts.exceptionalSingulars.empty();
 }
@@ -1,14 +1,15 @@
 /* C++ versions of C headers */
 #include <cstddef> // std::size_t
+#include <cctype> // std::isspace, std::isalpha, std::toupper
 
 /* Standard C++ */
 #include <locale> // std::isdigit, std::isspace, std::isalpha, std::toupper, std::tolower, std::isalnum
-#include <algorithm> // std::find_if, std::for_each, std::all_of
-#include <string> // std:wstring, std::string, std::stoll
-#include <sstream> // std::ostringstream, std::stringstream
-#include <memory> // std::make_unique
+#include <algorithm> // std::find_if
+#include <string> // std:wstring, std::string
+#include <string_view> // std::string_view
+#include <charconv> // std::from_chars
+#include <array> // std::array
 #include <utility> // std::pair
-#include <stdexcept> // std::invalid_argument, std::out_of_range
 
 #ifdef DEBUG
 #include <iostream> // std::cout, std::cout
@@ -20,18 +21,98 @@
 #include <boost/logic/tribool.hpp> // boost::tribool, boost::indeterminate
 
 /* My Unicode utilities library */
-#include "vuu/UTF8Validator.hpp" // vuu::UTF8Validator, to ensure that a string contains valid UTF-8
-#include "vuu/CodepointFinder.hpp" // vuu::CodepointFinder, to find the list of codepoints in the UTF-8 string
+#include "vuu/RangeValidator.hpp" // vuu::RangeValidator::Result, which says what's wrong with a noun
 
 /* Our headers */
 #include "mpp/Reply.hpp" // Reply::FailureCode, to indicate why the parser failed
 #include "mpp/Request.hpp" // Request class
 #include "mpp/ver.hpp" // Protocol version info
 #include "mpp/Header.hpp" // Represents a request header
-#include "mpp/functors/PtrResetter.hpp" // Resets pointers to stringstreams
 #include "mpp/functors/Printer.hpp" // Class template that prints items
 #include "mpp/ReqParser.hpp" // Class def'n
 
+namespace
+{
+	/**
+	* @desc Works out the status to fail with for a noun.
+	* @param res What the validator made of the noun.
+	* @return Reply::invalid if the noun is fine, or the status to fail with otherwise.
+	**/
+	mpp::Reply::Status toNounStatus(vuu::RangeValidator::Result res)
+	{
+		switch (res)
+		{
+			case vuu::RangeValidator::InvalidUTF8: // The noun contains invalid UTF-8
+			{
+				return mpp::Reply::invUTF8;
+			}
+
+			case vuu::RangeValidator::OutOfRange: // Valid UTF-8, but not all Malayalam
+			{
+				return mpp::Reply::badReq;
+			}
+
+			default:
+			{
+				return mpp::Reply::invalid;
+			}
+		}
+	}
+
+	/**
+	* @desc Appends a digit to a version # that's being read. Stops growing once the # is far too big to match, so that long runs of digits can't overflow it.
+	* @param num The version # so far.
+	* @param digit The digit, as a character.
+	**/
+	void addDigit(int& num, char digit)
+	{
+		if (num < 100000)
+		{
+			num = num * 10 + (digit - '0');
+		}
+	}
+
+	/**
+	* @desc Reads the value of a Content-Length header.
+	* @param val The header's value.
+	* @param n Set to the # of bytes if the value is valid.
+	* @return True if the whole value is a non-negative decimal int, false otherwise.
+	**/
+	bool toByteCount(std::string_view val, int& n)
+	{
+		int parsed = 0;
+		std::from_chars_result res = std::from_chars(val.data(), val.data() + val.size(), parsed); // Base 10, and never allocates
+
+		if (val.empty() || res.ec != std::errc() || res.ptr != val.data() + val.size() || parsed < 0)
+		{
+			return false;
+		}
+
+		n = parsed;
+		return true;
+	}
+
+	/**
+	* @desc Checks whether or not a character is whitespace, without the undefined behaviour that std::isspace has for negative chars.
+	* @param c The character.
+	* @return True if it's whitespace.
+	**/
+	bool isSpace(char c)
+	{
+		return std::isspace(static_cast<unsigned char>(c));
+	}
+
+	/**
+	* @desc Checks whether or not a character is allowed in a header's name.
+	* @param c The character.
+	* @return True if it's in [a-zA-Z] or is '-'.
+	**/
+	bool isHeaderNameChar(char c)
+	{
+		return std::isalpha(static_cast<unsigned char>(c)) || c == '-';
+	}
+};
+
 /**
 * Construct ready to parse the request method.
 **/
@@ -39,27 +120,17 @@ mpp::ReqParser::ReqParser() : curStat(protocol_name_m), // Construct in start st
 	prevStat(invalid), // Unneeded on the first invocation of consume(), but initialised to satisfy g++
 	status(mpp::Reply::invalid),
 	version {mpp::VER_MAJOR, mpp::VER_MINOR, mpp::VER_PATCH},
-	verSS {std::make_unique<std::stringstream>(), std::make_unique<std::stringstream>(), std::make_unique<std::stringstream>()},
+	verNums {0, 0, 0},
 	verbInfo {
 		{"ISSING", issing_first_s},
 		{"FOF", fof_o}
 	},
-	pSSHeaderName(new std::stringstream),
-	pSSHeaderVal(new std::stringstream),
 	mNBytes(0), // Initialise # of noun bytes read
-	pNounSS(new std::stringstream)
+	nounCheck(MALAYALAMBASE, MALAYALAMBASE + 0x7F), // U+0D00-U+0D7F
+	nNounChecked(0),
+	carrying(false)
 {
 	#ifdef DEBUG
-	if (pSSHeaderName)
-	{
-		std::cout << "mpp::ReqParser::ReqParser: pSSHeaderName is valid." << std::endl;
-	}
-
-	else
-	{
-		std::cout << "mpp::ReqParser::ReqParser: pSSHeaderName is invalid!" << std::endl;
-	}
-
 	/* Set up map of states to state names */
 	stateNames[protocol_name_m] = "protocol_name_m";
 	stateNames[protocol_name_first_p] = "protocol_name_first_p";
@@ -107,28 +178,17 @@ void mpp::ReqParser::reset()
 	std::cout << "mpp::ReqParser::reset: reset to state " << stateNames[curStat] << std::endl;
 	#endif
 
-	for (auto& ptr : verSS)
-	{
-		ptr.reset();
-	}
-
-	pSSHeaderName.reset(new std::stringstream); // Reset the header stringstream
+	verNums.fill(0);
 
-	#ifdef DEBUG
-	if (pSSHeaderName)
-	{
-		std::cout << "mpp::ReqParser::reset: pSSHeaderName owns a new stringstream after reset." << std::endl;
-	}
-	
-	else
-	{
-		std::cout << "mpp::ReqParser::reset: pSSHeaderName owns nothing after reset!" << std::endl;
-	}
-	#endif
-
-	pSSHeaderVal.reset(new std::stringstream); // Reset the header stringstream
-	pNounSS.reset(new std::stringstream); // Reset the noun's stringstream
+	/* clear() keeps each string's capacity, so the next request doesn't reallocate them */
+	headerName.clear();
+	headerVal.clear();
+	nounBytes.clear();
 	mNBytes = 0; // Reset expected # of bytes in noun
+	nounCheck.reset();
+	nNounChecked = 0;
+	carry.clear();
+	carrying = false;
 }
 
 /**
@@ -257,11 +317,11 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 		{
 			if (std::isdigit(input)) // The current character is a digit
 			{
-				*verSS[0] << input; // Append it to the end of the current version #
+				addDigit(verNums[0], input); // Append it to the end of the current version #
 				toReturn = boost::indeterminate; // Keep parsing
 				#ifdef DEBUG
 				std::cout << "mpp::ReqParser::consume: major: read digit '" << input << "'" << std::endl
-				<< "\tverSS[0]->str() = \"" << verSS[0]->str() << "\"" << std::endl;
+				<< "\tverNums[0] = " << verNums[0] << std::endl;
 				#endif
 			}
 
@@ -271,8 +331,7 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 				std::cout << "mpp::ReqParser::consume: read '" << input << "' in \"major\" state" << std::endl;
 				#endif
 
-				short readVerNum; // Holds the version # which we read, for comparison
-				*verSS[0] >> readVerNum; // Convert string to num
+				int readVerNum = verNums[0]; // Holds the version # which we read, for comparison
 	
 				#ifdef DEBUG
 				std::cout << "mpp::ReqParser::consume: major: readVerNum = " << readVerNum << ", version[0] = " << version[0] << std::endl;
@@ -316,18 +375,17 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 		{
 			if (std::isdigit(input)) // The current character is a digit
 			{
-				*verSS[1] << input; // Append it to the end of the current version #
+				addDigit(verNums[1], input); // Append it to the end of the current version #
 				#ifdef DEBUG
 				std::cout << "mpp::ReqParser::consume: minor: read digit '" << input << "'" << std::endl
-				<< "\tverSS[1]->str() = \"" << verSS[1]->str() << "\"" << std::endl;
+				<< "\tverNums[1] = " << verNums[1] << std::endl;
 				#endif
 				toReturn = boost::indeterminate; // Keep parsing
 			}
 
 			else if (input == '.') // Finished reading minor #
 			{
-				short readVerNum; // Holds the version # which we read, for comparison
-				*verSS[1] >> readVerNum; // Convert string to num
+				int readVerNum = verNums[1]; // Holds the version # which we read, for comparison
 
 				#ifdef DEBUG
 				std::cout << "mpp::ReqParser::consume: minor: read minor ver # = " << readVerNum << ", expecting " << version[1] << std::endl;
@@ -371,12 +429,12 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 		{
 			if (std::isdigit(input)) // The current character is a digit
 			{
-				*verSS[2] << input; // Append it to the end of the current version #
+				addDigit(verNums[2], input); // Append it to the end of the current version #
 				toReturn = boost::indeterminate; // Keep parsing
 
 				#ifdef DEBUG
 				std::cout << "mpp::ReqParser::consume: patch: character '" << input << "' is a digit" << std::endl
-				<< "\tverSS[2]->str() = \"" << verSS[2]->str() << "\"" << std::endl;
+				<< "\tverNums[2] = " << verNums[2] << std::endl;
 				#endif
 			}
 
@@ -386,8 +444,7 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 				std::cout << "mpp::ReqParser::consume: patch: character '" << input << "' is a space character" << std::endl;
 				#endif
 
-				short readVerNum; // Holds the version # which we read, for comparison
-				*verSS[2] >> readVerNum; // Convert string to num
+				int readVerNum = verNums[2]; // Holds the version # which we read, for comparison
 
 				#ifdef DEBUG
 				std::cout << "mpp::ReqParser::consume: patch: read patch # = " << readVerNum << ", expecting " << version[2] << std::endl;
@@ -747,24 +804,12 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 		{
 			if (std::isalpha(input) || input == '-') // The header must contain only [a-zA-Z] and '-'
 			{
-				#ifdef DEBUG
-				if (pSSHeaderName) // Check to make sure that the stringstream exists
-				{
-					std::cout << "mpp::ReqParser::consume: The pointer to the string stream for the header's name is: " << pSSHeaderName.get() << std::endl;
-				}
-
-				else
-				{
-					std::cout << "mpp::ReqParser::consume: pSSHeaderName doesn't own an object!" << std::endl;
-				}
-				#endif
-
-				(*pSSHeaderName) << input; // Insert the input into the stream
+				headerName += input; // Append the input to the name
 				toReturn = boost::indeterminate;
 
 				#ifdef DEBUG
-				std::cout << "mpp::ReqParser::consume: header_name: inserted character that is alpha or '-' (" << input << ") into header name stringstream." << std::endl
-				<< "\theader name = \"" << pSSHeaderName->str() << "\"" << std::endl;
+				std::cout << "mpp::ReqParser::consume: header_name: inserted character that is alpha or '-' (" << input << ") into header name." << std::endl
+				<< "\theader name = \"" << headerName << "\"" << std::endl;
 				#endif
 			}
 
@@ -835,12 +880,11 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 				toReturn = boost::indeterminate;
 
 				/* We need to know the length to read the noun, so check if this header is the content-length header */
-				if (pSSHeaderName->str() == "Content-Length") // Yes, we need this header
+				if (headerName == "Content-Length") // Yes, we need this header
 				{
-					if (isValidDecimalInt(pSSHeaderVal->str())) // Ensure that the value we have read so far is a valid int
+					if (toByteCount(headerVal, mNBytes)) // Ensure that the value we have read so far is a valid int, and read the # of bytes in the noun from it
 					{
-						(*pSSHeaderVal) >> mNBytes; // Read the # of bytes in the noun
-						req.addHeader(pSSHeaderName->str(), mNBytes); // Pass the Request object the name and value. It will create and add the Header object internally.
+						req.addHeader(headerName, mNBytes); // Pass the Request object the name and value. It will create and add the Header object internally.
 						#ifdef DEBUG
 						std::cout << "mpp::ReqParser::consume: header_value: noun has length " << mNBytes << " (in bytes)" << std::endl;
 						#endif
@@ -855,36 +899,26 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 
 				else // Treat it as a regular header
 				{
-					req.addHeader(pSSHeaderName->str(), pSSHeaderVal->str());
+					req.addHeader(headerName, headerVal);
 
 					#ifdef DEBUG
-					std::cout << "mpp::ReqParser::consume: header_value: read header \"" << pSSHeaderName->str() << "\", with value \"" << pSSHeaderVal->str() << "\"" << std::endl;
+					std::cout << "mpp::ReqParser::consume: header_value: read header \"" << headerName << "\", with value \"" << headerVal << "\"" << std::endl;
 					#endif
 				}
 
-				/* Reset stringstream pointers for the next header */
-				pSSHeaderName.reset(new std::stringstream);
-				std::cout << "mpp::ReqParser::consume: header_value: read '\r' and reset pSSHeaderName" << std::endl;
-			
-				#ifdef DEBUG
-				if (pSSHeaderName)
-				{
-					std::cout << "mpp::ReqParser::consume: header_value: pSSHeaderName is valid after reset." << std::endl;
-				}
+				/* Clear the name and value for the next header */
+				headerName.clear();
+				headerVal.clear();
 
-				else
-				{
-					std::cout << "mpp::ReqParser::consume: header_value: pSSHeaderName is invalid after reset!" << std::endl;
-				}
+				#ifdef DEBUG
+				std::cout << "mpp::ReqParser::consume: header_value: read '\\r' and cleared the header's name and value" << std::endl;
 				#endif
 
-				pSSHeaderVal.reset(new std::stringstream);
-
 			}
 
 			else // Part of header's value
 			{
-				(*pSSHeaderVal) << input; // Save it
+				headerVal += input; // Save it
 				toReturn = boost::indeterminate;
 
 				#ifdef DEBUG
@@ -929,6 +963,8 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 			if (input == '\n') // Found it
 			{
 				curStat = noun; // Reading the bytes of the Malayalam noun
+				nounCheck.reset();
+				nNounChecked = 0;
 				toReturn = boost::indeterminate;
 				
 				#ifdef DEBUG
@@ -954,12 +990,12 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 		{
 			if (mNBytes > 0) // Still reading
 			{
-				(*pNounSS) << input;
+				nounBytes += input;
 				--mNBytes; // Count this byte
 
 				#ifdef DEBUG
 				std::cout << "ReqParser::consume: noun: noun so far is \"";
-				std::cout << pNounSS->str();
+				std::cout << nounBytes;
 				std::cout << "\", " << mNBytes;
 
 				if (mNBytes == 1)
@@ -977,44 +1013,45 @@ boost::tribool mpp::ReqParser::consume(mpp::Request& req, char input)
 
 				if (mNBytes == 0) // Read the entire noun
 				{
-					/* Ensure that the noun contains valid UTF-8 */
-					std::string noun = pNounSS->str(); // Fetch the contents of the stringstream as a string
+					MalNoun compact;
+					Reply::Status nounStat = checkNoun(nounBytes, compact); // Ensure that the noun is valid UTF-8 and Malayalam
 
-					if (std::all_of(noun.cbegin(), noun.cend(), vuu::UTF8Validator())) // The noun is valid UTF-8
+					if (nounStat == Reply::invalid) // It is
 					{
-						vuu::CodepointFinder vcf = std::for_each(noun.cbegin(), noun.cend(), vuu::CodepointFinder()); // Use the functor to get a list of codepoints in the string (i.e., find the 32-bit codepoints derived from the UTF-8 string)
-						
-						if (std::all_of(vcf.cbegin(), vcf.cend(), [](unsigned long long codePoint) -> bool
-							{
-								return codePoint >= 0xd00 && codePoint <= 0xd7f;
-							})
-						) // Ensure that all of the codepoints are in the Malayalam range
-						{
-							req.setNoun(pNounSS->str()); // Store the noun (as UTF-8 bytes) in the request
-							toReturn = true; // We have successfully parsed an entire request
-	
-							#ifdef DEBUG
-							std::cout << "ReqParser::consume: successfully parsed noun \"" << req.getNoun() << "\"" << std::endl;
-							#endif
-						}
+						req.setNoun(nounBytes); // Store the noun (as UTF-8 bytes) in the request
+						req.setCompactNoun(compact); // And its compact form, which the cache and the classifier use
+						toReturn = true; // We have successfully parsed an entire request
 
-						else // At least one of the codepoints isn't a Malayalam codepoint
-						{
-							toReturn = false;
-							status = Reply::badReq;
-						}
+						#ifdef DEBUG
+						std::cout << "ReqParser::consume: successfully parsed noun \"" << req.getNoun() << "\"" << std::endl;
+						#endif
 					}
 
-					else // The noun contains invalid UTF-8
+					else
 					{
 						toReturn = false;
-						status = Reply::invUTF8;
+						status = nounStat;
 					}
 				}
 
 				else // Some bytes still remain
 				{
-					toReturn = boost::indeterminate; // Keep parsing
+					Reply::Status nounStat = checkNounPart(nounBytes); // The bytes so far may already make the noun bad, and then there's no point waiting for the rest
+
+					if (nounStat == Reply::invalid) // They don't
+					{
+						toReturn = boost::indeterminate; // Keep parsing
+					}
+
+					else
+					{
+						toReturn = false;
+						status = nounStat;
+
+						#ifdef DEBUG
+						std::cout << "ReqParser::consume: noun: rejected with " << mNBytes << " bytes still to come" << std::endl;
+						#endif
+					}
 				}
 			}
 
@@ -1062,32 +1099,364 @@ mpp::Reply::Status mpp::ReqParser::getStatus() const
 }
 
 /**
-* @desc Determines whether or not the given string represents a valid decimal integer.
-* @param toCheck The string to check.
-* @return True if the string represents a valid decimal integer, false otherwise.
+* @desc Parses a request straight out of a read buffer, without going through consume().
+*	Header names, header values and the noun are stored in req as slices of data, so a request that arrived in one read is never copied.
+*	If data ends part-way through a request, its bytes are kept by the parser and the next call continues from them. Only then is anything copied.
+* @param req The Request object to set values on.
+* @param data The bytes that were just read.
+* @return A pair of a tribool (true = full request parsed, false = invalid request, indeterminate = incomplete request); and the # of bytes of data that were used.
+*	The slices in req are valid until data's buffer is reused, or until the next call to this method or to reset(), whichever comes first.
 **/
-bool mpp::ReqParser::isValidDecimalInt(std::string toCheck)
+boost::tuple<boost::tribool, std::size_t> mpp::ReqParser::parse(mpp::Request& req, std::string_view data)
 {
-	std::size_t fuci; // The index of the first character after the point in the string where conversion stopped
+	boost::tribool res;
+	std::size_t used = 0; // # of bytes that scan() looked at
+
+	if (!carrying) // The usual case: the request starts at the beginning of data, so scan it where it is
+	{
+		nounCheck.reset(); // A new request, so its noun hasn't been checked at all
+		nNounChecked = 0;
+		res = scan(req, data, used);
+
+		if (boost::indeterminate(res)) // The read ended part-way through the request, so keep what we have until the rest arrives
+		{
+			carry.assign(data.data(), data.size());
+			carrying = true;
+			used = data.size();
+		}
+	}
 
-	try
+	else // An earlier read started this request
 	{
-		std::stoll(toCheck, &fuci); // Use base 10 (default)
+		std::size_t nCarried = carry.size(); // # of bytes that came from earlier reads
+		carry.append(data.data(), data.size());
+		res = scan(req, carry, used);
 
-		/*
-		* If we got here, the conversion was successful. But the conversion may not have consumed the entire string. We can check this by ensuring that fuci == toCheck.length().
-		*/
+		if (boost::indeterminate(res))
+		{
+			used = data.size();
+		}
 
-		return (fuci == toCheck.length()); // The entire string should have been converted
+		else // Done with the carried bytes. They're left in carry, since req's slices point into them.
+		{
+			carrying = false;
+			used = (used > nCarried ? used - nCarried : 0);
+		}
 	}
 
-	catch (std::invalid_argument& stdia) // std::stoll couldn't convert the string to a number
+	if (carrying && carry.size() > MAXCARRYBYTES) // Don't let a client make us hold onto an unbounded amount of data
 	{
-		return false; // Invalid decimal #
+		status = Reply::badReq;
+		res = false;
+		carrying = false;
 	}
 
-	catch (std::out_of_range& stdoor) // The converted value is outside the range of a long long or std::strtoll set errno to ERANGE
+	#ifdef DEBUG
+	std::cout << "mpp::ReqParser::parse: returning (" << res << ", " << used << ") for " << data.size() << " bytes of input. Carrying " << (carrying ? carry.size() : 0) << " bytes." << std::endl;
+	#endif
+
+	return boost::make_tuple(res, used);
+}
+
+/**
+* @desc Scans one request from the start of a block of bytes. Used by the bulk parse().
+* @param req The request object to set parameters on.
+* @param in The bytes to scan. Must start with the first byte of the request.
+* @param used Set to the # of bytes of in that were looked at.
+* @return True if a valid request was parsed, false if it's invalid, boost::indeterminate if in ends before the request does.
+**/
+boost::tribool mpp::ReqParser::scan(mpp::Request& req, std::string_view in, std::size_t& used)
+{
+	const std::string_view protoName = "MPP/";
+	const std::array<mpp::Reply::Status, 3> verStats {Reply::badMajor, Reply::badMinor, Reply::badPatch}; // Status for a mismatch in each part of the version
+	std::size_t pos = 0; // Scanning position
+	int contentLength = 0; // Value of the last Content-Length header
+	Request::Command com = Request::INVALID; // The verb that was read
+
+	used = in.size(); // Correct whenever we run out of input
+	req.clearHeaders(); // Slices from an earlier, incomplete scan of this request may refer to bytes that have since moved
+
+	/* Protocol name */
+	for (; pos < protoName.size(); pos++)
 	{
+		if (pos == in.size())
+		{
+			return boost::indeterminate;
+		}
+
+		if (in[pos] != protoName[pos])
+		{
+			status = Reply::badReq;
+			used = pos + 1;
+			return false;
+		}
+	}
+
+	/* Version */
+	for (std::size_t i = 0; i < version.size(); i++)
+	{
+		int readVerNum = 0;
+
+		while (pos < in.size() && in[pos] >= '0' && in[pos] <= '9')
+		{
+			addDigit(readVerNum, in[pos++]);
+		}
+
+		if (pos == in.size())
+		{
+			return boost::indeterminate;
+		}
+
+		if (i < version.size() - 1 ? in[pos] != '.' : !isSpace(in[pos])) // Bad separator
+		{
+			status = Reply::badReq;
+			used = pos + 1;
+			return false;
+		}
+
+		if (readVerNum != version[i])
+		{
+			status = verStats[i];
+			used = pos + 1;
+			return false;
+		}
+
+		++pos;
+	}
+
+	/* Verb. The first letter picks the verb, and the rest must match it, in any case. */
+	if (pos == in.size())
+	{
+		return boost::indeterminate;
+	}
+
+	std::string_view verb; // Name of the verb that the first letter picked
+
+	switch (std::toupper(static_cast<unsigned char>(in[pos])))
+	{
+		case 'F':
+		{
+			verb = "FOF";
+			com = Request::FOF;
+			break;
+		}
+
+		case 'I':
+		{
+			verb = "ISSING";
+			com = Request::ISSING;
+			break;
+		}
+
+		default:
+		{
+			status = Reply::unknownVerb;
+			used = pos + 1;
+			return false;
+		}
+	}
+
+	for (std::size_t i = 1; i < verb.size(); i++)
+	{
+		if (++pos == in.size())
+		{
+			return boost::indeterminate;
+		}
+
+		if (std::toupper(static_cast<unsigned char>(in[pos])) != verb[i])
+		{
+			status = Reply::badReq;
+			used = pos + 1;
+			return false;
+		}
+	}
+
+	++pos;
+
+	/* Line terminator after the verb */
+	for (char expected : {'\r', '\n'})
+	{
+		if (pos == in.size())
+		{
+			return boost::indeterminate;
+		}
+
+		if (in[pos++] != expected)
+		{
+			status = Reply::badReq;
+			used = pos;
+			return false;
+		}
+	}
+
+	/* Headers, until a line that starts with '\r' */
+	while (true)
+	{
+		std::size_t nameStart = pos;
+
+		while (pos < in.size() && isHeaderNameChar(in[pos]))
+		{
+			++pos;
+		}
+
+		if (pos == in.size())
+		{
+			return boost::indeterminate;
+		}
+
+		if (in[pos] == '\r') // End of the headers. As in consume(), any name that was started is dropped.
+		{
+			++pos;
+			break;
+		}
+
+		if (in[pos] != ':')
+		{
+			status = Reply::badReq;
+			used = pos + 1;
+			return false;
+		}
+
+		std::string_view name = in.substr(nameStart, pos - nameStart);
+
+		if (++pos == in.size()) // The separator is a single whitespace character
+		{
+			return boost::indeterminate;
+		}
+
+		if (!isSpace(in[pos]))
+		{
+			status = Reply::badReq;
+			used = pos + 1;
+			return false;
+		}
+
+		std::size_t valStart = ++pos;
+		std::size_t valEnd = in.find('\r', valStart);
+
+		if (valEnd == std::string_view::npos)
+		{
+			return boost::indeterminate;
+		}
+
+		std::string_view val = in.substr(valStart, valEnd - valStart);
+		pos = valEnd + 1;
+
+		if (name == "Content-Length" && !toByteCount(val, contentLength)) // We need this header to read the noun
+		{
+			status = Reply::badReq;
+			used = pos;
+			return false;
+		}
+
+		req.addHeaderSlice(name, val);
+
+		#ifdef DEBUG
+		std::cout << "mpp::ReqParser::scan: read header \"" << name << "\", with value \"" << val << "\"" << std::endl;
+		#endif
+
+		if (pos == in.size())
+		{
+			return boost::indeterminate;
+		}
+
+		if (in[pos++] != '\n')
+		{
+			status = Reply::badReq;
+			used = pos;
+			return false;
+		}
+	}
+
+	if (pos == in.size())
+	{
+		return boost::indeterminate;
+	}
+
+	if (in[pos++] != '\n') // Final '\n' of the "\r\n\r\n" that separates the headers from the noun
+	{
+		status = Reply::badReq;
+		used = pos;
 		return false;
 	}
+
+	/* Noun */
+	if (contentLength == 0) // consume() would wait forever for a noun that can't arrive
+	{
+		status = Reply::badReq;
+		used = pos;
+		return false;
+	}
+
+	if (in.size() - pos < static_cast<std::size_t>(contentLength))
+	{
+		Reply::Status nounStat = checkNounPart(in.substr(pos)); // Turn a bad noun away now, rather than holding onto it until the rest arrives
+
+		if (nounStat != Reply::invalid)
+		{
+			status = nounStat;
+			used = in.size();
+			return false;
+		}
+
+		return boost::indeterminate;
+	}
+
+	std::string_view nounView = in.substr(pos, contentLength);
+	MalNoun compact;
+	Reply::Status nounStat = checkNoun(nounView, compact);
+	used = pos + contentLength;
+
+	if (nounStat != Reply::invalid)
+	{
+		status = nounStat;
+		return false;
+	}
+
+	req.SETCOM_FUNC(com);
+	req.setNounSlice(nounView);
+	req.setCompactNoun(compact);
+
+	#ifdef DEBUG
+	std::cout << "mpp::ReqParser::scan: successfully parsed a " << used << "-byte request for the noun \"" << nounView << "\"" << std::endl;
+	#endif
+
+	return true;
+}
+
+/**
+* @desc Checks the part of a noun that has arrived so far, so that a bad noun is turned away without waiting for the rest of it.
+*	Only the bytes that an earlier call for the same noun didn't see are checked.
+* @param soFar The noun's bytes so far. Must start with the bytes that earlier calls for the same noun were given.
+* @return Reply::invalid if the noun is fine so far, or the status to fail with otherwise.
+**/
+mpp::Reply::Status mpp::ReqParser::checkNounPart(std::string_view soFar)
+{
+	std::string_view unseen = soFar.substr(nNounChecked); // A code point that's cut off is kept by nounCheck, so there's no need to look at these bytes again
+	nNounChecked = soFar.size();
+	return toNounStatus(nounCheck.feed(unseen.data(), unseen.size()));
+}
+
+/**
+* @desc Checks that a noun is valid UTF-8 and only contains Malayalam code points.
+*	Only the bytes that earlier calls to checkNounPart() didn't see are checked.
+* @param n The noun's bytes.
+* @param compact Set to the noun, one byte per code point, if it's fine.
+* @return Reply::invalid if the noun is fine, or the status to fail with otherwise.
+**/
+mpp::Reply::Status mpp::ReqParser::checkNoun(std::string_view n, MalNoun& compact)
+{
+	Reply::Status toReturn = checkNounPart(n);
+
+	if (toReturn == Reply::invalid)
+	{
+		toReturn = toNounStatus(nounCheck.finish()); // A noun can't end part-way through a code point
+	}
+
+	if (toReturn == Reply::invalid)
+	{
+		MalNoun::encode(n, compact); // Can't fail, now that every code point is known to be Malayalam
+	}
+
+	return toReturn;
 }
@@ -1,11 +1,13 @@
 /* STL */
-#include <string> // std::string, std::string::size_type
+#include <string> // std::string, std::string::size_type, std::stoi
+#include <string_view> // std::string_view
 #include <algorithm> // std::find_if
 #include <sstream> // std::ostringstream
 #include <vector> // std::vector
 #include <iomanip> // std::quoted
 #include <ostream> // std::endl
 #include <stdexcept> // std::out_of_range
+#include <utility> // std::make_pair
 #ifdef DEBUG
 #include <iostream> // std::cout
 #endif
@@ -25,6 +27,7 @@
 * @desc Default constructor. Initialises the command to an invalid one.
 **/
 mpp::Request::Request() : c(INVALID),
+	nHeaderSlices(0),
 	verbNames { // Set up map of enum values to verb names
 		{FOF, "FOF"},
 		{ISSING, "ISSING"},
@@ -61,6 +64,24 @@ void mpp::Request::addHeader(std::string name, ANY_CLASS value)
 	headers.emplace_front(name, value);
 }
 
+/**
+* @desc Adds a header whose name and value are slices of the buffer that it was parsed from. Nothing is copied unless the request already holds NHEADERSLICES slices.
+* @param name The header's name.
+* @param value The header's value.
+**/
+void mpp::Request::addHeaderSlice(std::string_view name, std::string_view value)
+{
+	if (nHeaderSlices < headerSlices.size())
+	{
+		headerSlices[nHeaderSlices++] = std::make_pair(name, value);
+	}
+
+	else // Out of slots, so fall back to a copy
+	{
+		addHeader(std::string(name), std::string(value));
+	}
+}
+
 /**
 * @desc Attempts to find a Header by the given name.
 * @throws mpp::exceptions::UnknownHeader if a Header with the given name isn't found.
@@ -76,6 +97,20 @@ mpp::Header mpp::Request::findHeader(std::string name)
 	
 	if (it == headers.cend()) // No such header
 	{
+		for (std::size_t i = 0; i < nHeaderSlices; i++) // It may have been added as a slice
+		{
+			if (headerSlices[i].first == name)
+			{
+				if (name == "Content-Length") // Stored as an int, like the parser has always done
+				{
+					return mpp::Header(name, std::stoi(std::string(headerSlices[i].second)));
+				}
+
+				return mpp::Header(name, std::string(headerSlices[i].second));
+			}
+		}
+
+
 		std::ostringstream ess;
 		ess << "Unknown header \"" << name << "\" requested." << std::endl;
 		throw mpp::exceptions::UnknownHeader(ess.str());
@@ -94,6 +129,18 @@ mpp::Header mpp::Request::findHeader(std::string name)
 void mpp::Request::setNoun(std::string noun)
 {
 	this->noun = noun;
+	nounSlice = std::string_view(); // The copy takes precedence over any old slice
+	compactNoun = MalNoun(); // Any old compact form was of another noun
+}
+
+/**
+* @desc Stores the noun as a slice of the buffer that it was parsed from, without copying it. The buffer must outlive the request's handling.
+* @param noun The slice that holds the noun.
+**/
+void mpp::Request::setNounSlice(std::string_view noun)
+{
+	nounSlice = noun;
+	compactNoun = MalNoun(); // Any old compact form was of another noun
 }
 
 /**
@@ -102,7 +149,34 @@ void mpp::Request::setNoun(std::string noun)
 **/
 std::string mpp::Request::getNoun() const
 {
-	return noun;
+	return std::string(getNounView());
+}
+
+/**
+* @desc Fetches the noun associated with this request without copying it.
+* @return A view of this request's noun, which is only valid as long as the noun (or the buffer that it was sliced from) is.
+**/
+std::string_view mpp::Request::getNounView() const
+{
+	return (nounSlice.data() != nullptr ? nounSlice : std::string_view(noun));
+}
+
+/**
+* @desc Stores the noun's compact form, which the parser makes while it checks the noun.
+* @param noun The noun, one byte per code point.
+**/
+void mpp::Request::setCompactNoun(const MalNoun& noun)
+{
+	compactNoun = noun;
+}
+
+/**
+* @desc Fetches the noun's compact form.
+* @return The noun, one byte per code point. Empty if it wasn't set since the noun was.
+**/
+const mpp::MalNoun& mpp::Request::getCompactNoun() const
+{
+	return compactNoun;
 }
 
 /**
@@ -196,11 +270,20 @@ std::vector<boost::asio::const_buffer> mpp::Request::toBuffers()
 		#endif
 	} // for
 
+	for (std::size_t i = 0; i < nHeaderSlices; i++) // Sliced headers refer to memory that outlives the buffers, so they don't need copying into sdata
+	{
+		bufs.push_back(boost::asio::buffer(headerSlices[i].first.data(), headerSlices[i].first.size()));
+		bufs.push_back(boost::asio::buffer(nameValSep));
+		bufs.push_back(boost::asio::buffer(headerSlices[i].second.data(), headerSlices[i].second.size()));
+		bufs.push_back(boost::asio::buffer(crlf));
+	}
+
 	bufs.push_back(boost::asio::buffer(crlf)); // End the headers
 	#ifdef DEBUG
 	printBufs("pushing final CRLF");
 	#endif
-	bufs.push_back(boost::asio::buffer(noun)); // Add the noun
+	std::string_view nounView = getNounView();
+	bufs.push_back(boost::asio::buffer(nounView.data(), nounView.size())); // Add the noun
 	#ifdef DEBUG
 	printBufs("adding noun");
 	#endif
@@ -293,17 +376,35 @@ void mpp::Request::writeToStream(std::ostream& os) const
 		os << val // Write the header's value
 		<< "\r\n"; // End this header line
 	}
+
+	for (std::size_t i = 0; i < nHeaderSlices; i++)
+	{
+		os << headerSlices[i].first << ": " << headerSlices[i].second << "\r\n";
+	}
 	
 	os << "\r\n" // End the headers
-	<< noun; // Write the noun
+	<< getNounView(); // Write the noun
 }
 
 /**
-* @desc Clears our list of headers.
+* @desc Clears our list of headers, including the sliced ones.
 **/
 void mpp::Request::clearHeaders()
 {
 	headers.clear();
+	nHeaderSlices = 0;
+}
+
+/**
+* @desc Clears the command, headers and noun, so that the object can hold the next request on a connection. The noun's storage is kept.
+**/
+void mpp::Request::clear()
+{
+	c = INVALID;
+	clearHeaders();
+	noun.clear();
+	nounSlice = std::string_view();
+	compactNoun = MalNoun();
 }
 
 #ifdef DEBUG
@@ -0,0 +1,63 @@
+/* Boost */
+#include <boost/regex.hpp>
+#include <boost/regex/icu.hpp> // boost::make_u32regex
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* Our headers */
+#include "bosmacros/array.hpp" // ARRAY_CLASS macro
+#include "mpp/RuleSet.hpp" // Class def'n
+
+/**
+* @desc Fetches the process-wide rule set, compiling it on the first call.
+* @return The rule set.
+**/
+const mpp::RuleSet& mpp::RuleSet::get()
+{
+	static const RuleSet rules; // Initialisation is thread-safe, so concurrent first calls compile it only once
+	return rules;
+}
+
+/**
+* @desc Constructor. Compiles every regex. Only called by get().
+**/
+mpp::RuleSet::RuleSet() : declRegs { // Set up array of regexes used to guess what declension a noun falls into
+		boost::make_u32regex(".*\\x{d7b}$"), // an-stem
+		boost::make_u32regex(".*\\x{d02}$"), // am-stem
+		boost::make_u32regex(".*\\x{d31}\\x{d4d}$"), // ruh-stem
+		boost::make_u32regex(".*\\x{d1f}\\x{d4d}$"), // duh-stem
+		boost::make_u32regex(".*\\x{d4d}$"), // schwa-stem
+	},
+	endsInRetroflexL(boost::make_u32regex(".*\\x{d7e}$")),
+	endsInKaL(boost::make_u32regex(".*\\x{d15}\\x{d7e}$")),
+	doesntEndInChillu(boost::make_u32regex(".*[^\\x{d7a}-\\x{d7f}]$")),
+	doesntEndInSchwa(boost::make_u32regex(".*[^\\x{d4d}]$")),
+	endsInKaar(boost::make_u32regex(".*\\x{d15}\\x{d3e}\\x{d30}(\\x{d7b}|\\x{d3f})$")),
+	endsInKaaran(boost::make_u32regex(".*\\x{d15}\\x{d3e}\\x{d30}\\x{d7b}")),
+	endsInKaari(boost::make_u32regex(".*\\x{d15}\\x{d3e}\\x{d30}\\x{d3f}")),
+	endsInLongA(boost::make_u32regex(".*\\x{d3e}$")),
+	endsInSyllabicR(boost::make_u32regex(".*\\x{d43}$")),
+	endsInA(boost::make_u32regex(".*[\\x{d15}-\\x{d3a}]$")), // Any noun that ends in a consonant that has no vowel sign after it ends in an /a/, since /a/ is the default vowel
+	endsInShortI(boost::make_u32regex(".*\\x{d3f}$")),
+	endsInAlveolarN(boost::make_u32regex(".*\\x{d7b}$")),
+	isAmStem(boost::make_u32regex(".*\\x{d02}$")),
+	endsInSchwa(boost::make_u32regex(".*\\x{d4d}$")),
+	cvcuReg(boost::make_u32regex("[\\x{d15}-\\x{d3a}]((?:)|[\\x{d3e}-\\x{d4e}])[\\x{d15}-\\x{d3a}]\\x{d41}")),
+	cLongVReg(boost::make_u32regex("[\\x{d15}-\\x{d3a}][\\x{d3e}|\\x{d40}|\\x{d42}|\\x{d44}|\\x{d47}|\\x{d4b}]")),
+	ranFinder(boost::make_u32regex("(.*)\\x{d30}\\x{d7b}")),
+	riFinder(boost::make_u32regex("\\x{d30}\\x{d3f}")),
+	amStemFinder(boost::make_u32regex("(.*)\\x{d02}$")),
+	schwaFinder(boost::make_u32regex("(.*)\\x{d4d}$")),
+	endsInMaar(boost::make_u32regex(".*\\x{d2e}\\x{d3e}\\x{d7c}")),
+	endsInKkaL(boost::make_u32regex(".*\\x{d15}\\x{d4d}\\x{d15}\\x{d7e}")),
+	endsInKaarPlural(boost::make_u32regex(".*\\x{d15}\\x{d3e}\\x{d7c}")),
+	ivarAvar(boost::make_u32regex("[\\x{d05}|\\x{d07}]\\x{d35}\\x{d7c}")),
+	kaLFinder(boost::make_u32regex("(.*)\\x{d15}\\x{d7e}")),
+	maarFinder(boost::make_u32regex("(.*)\\x{d2e}\\x{d3e}\\x{d7c}")),
+	kkaLFinder(boost::make_u32regex("(.*)\\x{d15}\\x{d4d}\\x{d15}\\x{d7e}"))
+{
+	#ifdef DEBUG
+	std::cout << "mpp::RuleSet::RuleSet: compiled the rule set" << std::endl;
+	#endif
+}
@@ -0,0 +1,369 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+#include <array> // std::array
+#include <algorithm> // std::lower_bound
+#include <utility> // std::pair, std::make_pair
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* Our headers */
+#include "mpp/SuffixClassifier.hpp" // Class def'n
+
+namespace
+{
+	/**
+	* @desc A suffix and the rule that it belongs to.
+	**/
+	struct SuffixRule
+	{
+		mpp::SuffixClassifier::Rule rule;
+		std::string_view text; // UTF-8
+	};
+
+	/* Every literal suffix that ReqHandler tests for. The trie is built from this table. */
+	const std::array<SuffixRule, 15> suffixRules {{
+		{mpp::SuffixClassifier::EndsInAn, u8"\u0d7b"},
+		{mpp::SuffixClassifier::EndsInAm, u8"\u0d02"},
+		{mpp::SuffixClassifier::EndsInRuh, u8"\u0d31\u0d4d"},
+		{mpp::SuffixClassifier::EndsInDuh, u8"\u0d1f\u0d4d"},
+		{mpp::SuffixClassifier::EndsInVirama, u8"\u0d4d"},
+		{mpp::SuffixClassifier::EndsInRetroflexL, u8"\u0d7e"},
+		{mpp::SuffixClassifier::EndsInKaL, u8"\u0d15\u0d7e"},
+		{mpp::SuffixClassifier::EndsInKkaL, u8"\u0d15\u0d4d\u0d15\u0d7e"},
+		{mpp::SuffixClassifier::EndsInMaar, u8"\u0d2e\u0d3e\u0d7c"},
+		{mpp::SuffixClassifier::EndsInKaarPlural, u8"\u0d15\u0d3e\u0d7c"},
+		{mpp::SuffixClassifier::EndsInKaaran, u8"\u0d15\u0d3e\u0d30\u0d7b"},
+		{mpp::SuffixClassifier::EndsInKaari, u8"\u0d15\u0d3e\u0d30\u0d3f"},
+		{mpp::SuffixClassifier::EndsInLongA, u8"\u0d3e"},
+		{mpp::SuffixClassifier::EndsInSyllabicR, u8"\u0d43"},
+		{mpp::SuffixClassifier::EndsInShortI, u8"\u0d3f"}
+	}};
+
+	/* Text used by the rewrites */
+	const std::string_view anusvara = u8"\u0d02"; // -ം
+	const std::string_view virama = u8"\u0d4d"; // -്
+	const std::string_view ran = u8"\u0d30\u0d7b"; // -രൻ
+	const std::string_view ri = u8"\u0d30\u0d3f"; // -രി
+	const std::string_view nngaL = u8"\u0d19\u0d4d\u0d19\u0d7e"; // -ങ്ങൾ
+	const std::string_view ukaL = u8"\u0d41\u0d15\u0d7e"; // -ുകൾ
+	const std::string_view kkaL = u8"\u0d15\u0d4d\u0d15\u0d7e"; // -ക്കൾ
+	const std::string_view maar = u8"\u0d2e\u0d3e\u0d7c"; // -മാർ
+	const std::string_view chilluR = u8"\u0d7c"; // -ർ
+
+	/**
+	* @desc Decodes the code point that ends just before a position in a UTF-8 string.
+	* @param s The string.
+	* @param pos The position after the code point. Must be greater than 0. Moved back to the start of the code point.
+	* @return The code point, or U+FFFD if the bytes before pos aren't the end of a well-formed sequence (in which case pos only moves back by 1).
+	**/
+	char32_t prevCodepoint(std::string_view s, std::size_t& pos)
+	{
+		std::size_t start = pos - 1;
+
+		while (start > 0 && pos - start < 4 && (static_cast<unsigned char>(s[start]) & 0xC0) == 0x80) // Skip back over continuation bytes
+		{
+			start--;
+		}
+
+		unsigned char lead = static_cast<unsigned char>(s[start]);
+		std::size_t len = pos - start;
+		std::size_t expected = (lead < 0x80 ? 1 : ((lead >> 5) == 0x06 ? 2 : ((lead >> 4) == 0x0E ? 3 : ((lead >> 3) == 0x1E ? 4 : 0))));
+
+		if (expected != len) // Stray continuation byte, or a truncated sequence
+		{
+			pos--;
+			return U'\ufffd';
+		}
+
+		char32_t cp = (len == 1 ? lead : lead & (0x7F >> len)); // Payload bits of the lead byte
+
+		for (std::size_t i = start + 1; i < pos; i++)
+		{
+			cp = (cp << 6) | (static_cast<unsigned char>(s[i]) & 0x3F);
+		}
+
+		pos = start;
+		return cp;
+	}
+
+	/**
+	* @desc Checks whether or not a code point is a Malayalam consonant.
+	* @param cp The code point.
+	* @return True if it's in the range U+0D15-U+0D3A.
+	**/
+	bool isConsonant(char32_t cp)
+	{
+		return cp >= U'\u0d15' && cp <= U'\u0d3a';
+	}
+};
+
+/**
+* @desc Checks whether or not any of the given rules matched.
+* @param r The rule(s) to check, OR'd together.
+* @return True if at least one of them matched.
+**/
+bool mpp::SuffixClassifier::Result::has(std::uint32_t r) const
+{
+	return (rules & r) != 0;
+}
+
+/**
+* @desc Fetches the process-wide classifier, building its trie on the first call.
+* @return The classifier.
+**/
+const mpp::SuffixClassifier& mpp::SuffixClassifier::get()
+{
+	static const SuffixClassifier classifier; // Initialisation is thread-safe, so concurrent first calls build it only once
+	return classifier;
+}
+
+/**
+* @desc Classifies a noun.
+* @param noun The noun to classify. UTF-8 encoded Malayalam text.
+* @return Every rule that matched, the stem class, and the stem's rewrites.
+**/
+mpp::SuffixClassifier::Result mpp::SuffixClassifier::classify(std::string_view noun) const
+{
+	Tail rev;
+	std::size_t n = 0; // # of code points decoded
+	std::size_t pos = noun.size(); // Decoding position
+
+	while (pos > 0 && n < rev.size())
+	{
+		rev[n++] = prevCodepoint(noun, pos);
+	}
+
+	return classifyTail(rev, n);
+}
+
+/**
+* @desc Classifies a noun that's already one byte per code point, which needs no decoding.
+* @param noun The noun to classify.
+* @return Every rule that matched, the stem class, and the stem's rewrites. The same as classify() gives for the noun's UTF-8.
+**/
+mpp::SuffixClassifier::Result mpp::SuffixClassifier::classify(const MalNoun& noun) const
+{
+	Tail rev;
+	std::size_t n = 0;
+
+	while (n < noun.size() && n < rev.size())
+	{
+		rev[n] = noun[noun.size() - 1 - n];
+		n++;
+	}
+
+	return classifyTail(rev, n);
+}
+
+/**
+* @desc Applies a rewrite to a noun.
+* @param noun The noun to rewrite.
+* @param rw The rewrite. Must not strip more than the noun's length.
+* @return The rewritten noun.
+**/
+std::string mpp::SuffixClassifier::apply(std::string_view noun, const Rewrite& rw)
+{
+	std::string toReturn;
+	toReturn.reserve(noun.size() - rw.strip + rw.append.size());
+	toReturn.append(noun.substr(0, noun.size() - rw.strip));
+	toReturn.append(rw.append);
+	return toReturn;
+}
+
+/**
+* @desc Removes a suffix from a noun which is known to end in it.
+* @param noun The noun.
+* @param r A suffix rule that matched the noun, such as EndsInKaL.
+* @return The noun without the suffix.
+**/
+std::string mpp::SuffixClassifier::withoutSuffix(std::string_view noun, Rule r)
+{
+	for (const SuffixRule& sr : suffixRules)
+	{
+		if (sr.rule == r && noun.size() >= sr.text.size())
+		{
+			return std::string(noun.substr(0, noun.size() - sr.text.size()));
+		}
+	}
+
+	return std::string(noun); // Not a suffix rule
+}
+
+/**
+* @desc Constructor. Builds the trie from the suffix table. Only called by get().
+**/
+mpp::SuffixClassifier::SuffixClassifier() : trie(1)
+{
+	for (const SuffixRule& sr : suffixRules)
+	{
+		insert(sr.text, sr.rule);
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::SuffixClassifier::SuffixClassifier: built a trie with " << trie.size() << " nodes" << std::endl;
+	#endif
+}
+
+
+/**
+* @desc Adds a suffix to the trie.
+* @param suffix The suffix, in UTF-8.
+* @param r The rule to report when the suffix matches.
+**/
+void mpp::SuffixClassifier::insert(std::string_view suffix, Rule r)
+{
+	std::uint32_t node = 0;
+	std::size_t pos = suffix.size();
+
+	while (pos > 0) // Last code point first
+	{
+		char32_t cp = prevCodepoint(suffix, pos);
+		std::vector<std::pair<char32_t, std::uint32_t>>& next = trie[node].next;
+		auto edge = std::lower_bound(next.begin(), next.end(), std::make_pair(cp, std::uint32_t(0)));
+
+		if (edge != next.end() && edge->first == cp)
+		{
+			node = edge->second;
+		}
+
+		else
+		{
+			std::uint32_t child = trie.size();
+			next.insert(edge, std::make_pair(cp, child)); // Insert before growing the trie, since that invalidates next
+			trie.emplace_back();
+			node = child;
+		}
+	}
+
+	trie[node].accept |= r;
+}
+
+/**
+* @desc Classifies a noun from its last code points, however they were decoded.
+* @param rev The noun's last code points, last first.
+* @param n The # of valid entries in rev. Less than rev's size only if that's the whole noun.
+* @return Every rule that matched, the stem class, and the stem's rewrites.
+**/
+mpp::SuffixClassifier::Result mpp::SuffixClassifier::classifyTail(const Tail& rev, std::size_t n) const
+{
+	Result toReturn;
+	std::uint32_t node = 0; // Current trie node
+
+	for (std::size_t i = 0; i < n; i++) // Walk the trie until the suffix read so far isn't a path in it
+	{
+		const std::vector<std::pair<char32_t, std::uint32_t>>& next = trie[node].next;
+		auto edge = std::lower_bound(next.cbegin(), next.cend(), std::make_pair(rev[i], std::uint32_t(0)));
+
+		if (edge == next.cend() || edge->first != rev[i])
+		{
+			break;
+		}
+
+		node = edge->second;
+		toReturn.rules |= trie[node].accept;
+	}
+
+	if (n > 0) // Tests on the final code point
+	{
+		if (isConsonant(rev[0]))
+		{
+			toReturn.rules |= EndsInConsonant;
+		}
+
+		if (rev[0] < U'\u0d7a' || rev[0] > U'\u0d7f')
+		{
+			toReturn.rules |= EndsInNonChillu;
+		}
+
+		if (rev[0] != U'\u0d4d')
+		{
+			toReturn.rules |= EndsInNonVirama;
+		}
+	}
+
+	/* Whole-word shapes. The vowel classes include '|', as the regexes they replace do. */
+	if ((n == 3 && isConsonant(rev[2]) && isConsonant(rev[1]) && rev[0] == U'\u0d41') ||
+		(n == 4 && isConsonant(rev[3]) && rev[2] >= U'\u0d3e' && rev[2] <= U'\u0d4e' && isConsonant(rev[1]) && rev[0] == U'\u0d41'))
+	{
+		toReturn.rules |= IsCVCu;
+	}
+
+	if (n == 2 && isConsonant(rev[1]))
+	{
+		switch (rev[0])
+		{
+			case U'\u0d3e':
+			case U'\u0d40':
+			case U'\u0d42':
+			case U'\u0d44':
+			case U'\u0d47':
+			case U'\u0d4b':
+			case U'|':
+			{
+				toReturn.rules |= IsCLongV;
+				break;
+			}
+
+			default:
+			{
+				break;
+			}
+		}
+	}
+
+	if (n == 3 && (rev[2] == U'\u0d05' || rev[2] == U'\u0d07' || rev[2] == U'|') && rev[1] == U'\u0d35' && rev[0] == U'\u0d7c')
+	{
+		toReturn.rules |= IsIvarAvar;
+	}
+
+	/* Pick the stem class, in the order that ReqHandler tries them */
+	if (toReturn.has(EndsInKaaran))
+	{
+		toReturn.stem = KaaranStem;
+		toReturn.rewrites[0] = {0, maar};
+		toReturn.rewrites[1] = {ran.size(), chilluR};
+		toReturn.nRewrites = 2;
+	}
+
+	else if (toReturn.has(EndsInKaari))
+	{
+		toReturn.stem = KaariStem;
+		toReturn.rewrites[0] = {0, maar};
+		toReturn.rewrites[1] = {ri.size(), chilluR};
+		toReturn.nRewrites = 2;
+	}
+
+	else if (toReturn.has(EndsInAm))
+	{
+		toReturn.stem = AmStem;
+		toReturn.rewrites[0] = {anusvara.size(), nngaL};
+		toReturn.nRewrites = 1;
+	}
+
+	else if (toReturn.has(EndsInVirama))
+	{
+		toReturn.stem = SchwaStem;
+		toReturn.rewrites[0] = {virama.size(), ukaL};
+		toReturn.nRewrites = 1;
+	}
+
+	else if (toReturn.has(IsCVCu | IsCLongV))
+	{
+		toReturn.stem = ShortStem;
+		toReturn.rewrites[0] = {0, kkaL};
+		toReturn.nRewrites = 1;
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::SuffixClassifier::classify: rules = 0x" << std::hex << toReturn.rules << std::dec << ", stem = " << toReturn.stem << std::endl;
+	#endif
+
+	return toReturn;
+}
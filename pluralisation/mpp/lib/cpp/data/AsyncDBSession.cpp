@@ -0,0 +1,661 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <cstdlib> // std::strtol
+
+/* Standard C++ */
+#include <string> // std::string
+#include <utility> // std::move, std::pair
+#include <functional> // std::function
+#include <exception> // std::exception_ptr, std::make_exception_ptr
+#include <algorithm> // std::find, std::min
+#include <memory> // std::make_shared, std::shared_ptr
+#include <map> // std::map
+#include <vector> // std::vector
+#include <set> // std::set
+#include <unordered_map> // std::unordered_map
+#include <chrono> // std::chrono::milliseconds, std::chrono::microseconds
+#include <sstream> // std::ostringstream
+#include <iomanip> // std::quoted
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* Boost */
+#include <boost/asio/post.hpp> // boost::asio::post
+#include <boost/asio/error.hpp> // boost::asio::error::operation_aborted
+#include <boost/system/error_code.hpp> // boost::system::error_code
+
+/* MariaDB */
+#include <mysql.h> // mysql_*_start, mysql_*_cont, MYSQL_WAIT_READ, MYSQL_WAIT_WRITE, MYSQL_WAIT_EXCEPT
+#include <errmsg.h> // CR_SERVER_GONE_ERROR, CR_SERVER_LOST
+
+/* Our headers */
+#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information
+#include "mpp/data/NounFacts.hpp" // What a lookup produces
+#include "mpp/data/BloomFilter.hpp" // Turns away nouns that the DB knows nothing about
+#include "mpp/exceptions/DBError.hpp" // Passed to handlers if the DB can't be reached
+#include "mpp/data/AsyncDBSession.hpp" // Class def'n
+
+namespace
+{
+	/* Column indices of the facts query's result */
+	enum Column
+	{
+		RequestedCol,
+		NounCol,
+		PluralisableCol,
+		AnimateCol,
+		HumanityCol,
+		GenderCol,
+		PluralCol,
+		SingularCol
+	};
+
+	/**
+	* @desc Folds the rows of the facts query together, in the same way as DBSession::getFacts, into the facts of the nouns that each row was asked for by.
+	*	Rows with a NULL noun come from the second half of the query, and name a singular.
+	* @param res The query's rows.
+	* @param facts The looked-up nouns' facts, each of which starts out empty.
+	**/
+	void fold(MYSQL_RES* res, std::map<std::string, mpp::data::NounFacts>& facts)
+	{
+		MYSQL_ROW row;
+
+		while ((row = mysql_fetch_row(res)) != nullptr)
+		{
+			unsigned long* lengths = mysql_fetch_lengths(res);
+			std::map<std::string, mpp::data::NounFacts>::iterator it = facts.find(std::string(row[RequestedCol], lengths[RequestedCol]));
+
+			if (it == facts.end()) // Can't happen, since the requested column echoes the literals that the query was built from
+			{
+				continue;
+			}
+
+			mpp::data::NounFacts& toReturn = it->second;
+
+			if (!row[NounCol]) // A noun which has this noun as an exceptional plural
+			{
+				std::string singular(row[SingularCol], lengths[SingularCol]);
+
+				if (std::find(toReturn.exceptionalSingulars.cbegin(), toReturn.exceptionalSingulars.cend(), singular) == toReturn.exceptionalSingulars.cend())
+				{
+					toReturn.exceptionalSingulars.push_back(singular);
+				}
+
+				continue;
+			}
+
+			if (!toReturn.exists) // First row for the noun itself
+			{
+				toReturn.exists = true;
+				toReturn.animate = true;
+				toReturn.human = true;
+				toReturn.exceptional = true;
+			}
+
+			if (row[PluralisableCol])
+			{
+				toReturn.pluralisable = toReturn.pluralisable && std::strtol(row[PluralisableCol], nullptr, 10) != 0;
+			}
+
+			toReturn.animate = toReturn.animate && row[AnimateCol] && std::strtol(row[AnimateCol], nullptr, 10) != 0; // A missing row means inanimate
+			toReturn.human = toReturn.human && row[HumanityCol] && std::strtol(row[HumanityCol], nullptr, 10) != 0; // A missing row means non-human
+
+			if (row[GenderCol])
+			{
+				std::string genStr(row[GenderCol], lengths[GenderCol]);
+				toReturn.gender = (genStr == "Masculine" ? mpp::data::Masculine : (genStr == "Feminine" ? mpp::data::Feminine : mpp::data::Neuter));
+			}
+
+			if (row[PluralCol])
+			{
+				std::string plural(row[PluralCol], lengths[PluralCol]);
+				toReturn.exceptional = toReturn.exceptional && !plural.empty(); // A noun has an irregular plural if the stored string isn't empty
+
+				if (std::find(toReturn.exceptionalPlurals.cbegin(), toReturn.exceptionalPlurals.cend(), plural) == toReturn.exceptionalPlurals.cend())
+				{
+					toReturn.exceptionalPlurals.push_back(plural);
+				}
+			}
+		}
+
+		for (std::pair<const std::string, mpp::data::NounFacts>& nf : facts)
+		{
+			nf.second.exceptional = nf.second.exceptional && !nf.second.exceptionalPlurals.empty(); // No exceptions rows means a regular plural
+		}
+	}
+};
+
+/**
+* @desc Constructor. Connects to the DB, blocking until it's done, so that a bad config is found before the server starts.
+* @param ioc The io_context whose thread will use the session.
+* @param info Information needed to connect to the DB.
+* @param batchSize The most nouns to look up in one query. Must be positive.
+* @param batchWindow How long a lookup that finds the connection idle waits for others to join it. Zero sends it straight away.
+* @throws mpp::exceptions::DBError If the connection can't be made.
+**/
+mpp::data::AsyncDBSession::AsyncDBSession(boost::asio::io_context& ioc, const DBInfo& info, std::size_t batchSize, std::chrono::microseconds batchWindow) : ioc(ioc),
+	host(info.getHost()),
+	user(info.getUser()),
+	password(info.getPassword()),
+	dbName(info.getDBName()),
+	mysql(nullptr),
+	sock(ioc),
+	timer(ioc),
+	batchTimer(ioc),
+	batchSize(batchSize > 0 ? batchSize : 1),
+	batchWindow(batchWindow),
+	nWaiting(0),
+	nShared(0),
+	batched(0),
+	busy(false),
+	gathering(false),
+	retried(false),
+	queryErr(0),
+	result(nullptr)
+{
+	open();
+
+	if (!mysql_real_connect(mysql, host.c_str(), user.c_str(), password.c_str(), dbName.c_str(), 0, nullptr, 0)) // The blocking API still works on a non-blocking connection
+	{
+		std::exception_ptr err = dbError("connecting");
+		disconnect();
+		std::rethrow_exception(err);
+	}
+
+	sock.assign(mysql_get_socket(mysql));
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::AsyncDBSession::AsyncDBSession: connected on socket #" << sock.native_handle() << std::endl;
+	#endif
+}
+
+/**
+* @desc Destructor. Closes the connection. Lookups that are still queued are dropped without their handlers being called.
+**/
+mpp::data::AsyncDBSession::~AsyncDBSession()
+{
+	disconnect();
+}
+
+/**
+* @desc Fetches everything that the DB knows about a noun, in the same form as DBSession::getFacts.
+*	If the connection has dropped, it's reopened and the query is retried once.
+*	If the noun is already being looked up, the handler shares that lookup's result.
+* @param noun The noun to look up. UTF-8 encoded Malayalam text.
+* @param handler Called once the lookup is done. Never called before this returns.
+**/
+void mpp::data::AsyncDBSession::getFacts(const std::string& noun, FactsHandler handler)
+{
+	if (filter)
+	{
+		++filterStats.checked;
+
+		if (!filter->mayContain(noun)) // Neither a noun nor an exceptional plural, so the DB would find nothing
+		{
+			++filterStats.rejected;
+			NounFacts facts;
+			facts.noun = noun;
+			boost::asio::post(ioc, [handler = std::move(handler), facts = std::move(facts)]()
+				{
+					handler(nullptr, facts);
+				}
+			);
+			return;
+		}
+	}
+
+	std::vector<FactsHandler>& handlers = waiters[noun];
+	handlers.push_back(std::move(handler));
+	++nWaiting;
+
+	if (handlers.size() > 1) // Queued or running already, and its result will do just as well for this lookup
+	{
+		++nShared;
+
+		#ifdef DEBUG
+		std::cout << "mpp::data::AsyncDBSession::getFacts: " << std::quoted(noun) << " is already being looked up for " << (handlers.size() - 1) << " others" << std::endl;
+		#endif
+
+		return;
+	}
+
+	queue.push_back(noun);
+
+	if (gathering && queue.size() >= batchSize) // The batch is full, so there's no point waiting for the window to end
+	{
+		batchTimer.cancel();
+	}
+
+	else if (!busy && !gathering) // Otherwise, finish() starts it once the lookups ahead of it are done
+	{
+		boost::asio::post(ioc, [this]()
+			{
+				startNext();
+			}
+		);
+	}
+}
+
+/**
+* @desc Fetches the # of lookups that are queued or running.
+* @return The # of lookups.
+**/
+std::size_t mpp::data::AsyncDBSession::pending() const
+{
+	return nWaiting;
+}
+
+/**
+* @desc Fetches the # of lookups that have shared another's result rather than being queued themselves.
+* @return The # of lookups.
+**/
+std::size_t mpp::data::AsyncDBSession::shared() const
+{
+	return nShared;
+}
+
+/**
+* @desc Sets the filter that lookups are checked against before they're queued.
+*	The filter must hold every noun and every exceptional plural in the DB; a noun added to the DB later is reported as unknown until it's added to the filter.
+* @param f The filter, which mustn't be changed while the session holds it. Null turns filtering off.
+**/
+void mpp::data::AsyncDBSession::setFilter(std::shared_ptr<const BloomFilter> f)
+{
+	filter = std::move(f);
+}
+
+/**
+* @desc Fetches the filter's counters.
+* @return The counters.
+**/
+const mpp::data::AsyncDBSession::FilterStats& mpp::data::AsyncDBSession::getFilterStats() const
+{
+	return filterStats;
+}
+
+/**
+* @desc Runs the lookups at the front of the queue, connecting first if need be. Does nothing if a query is already running, or while a batch is being gathered.
+*	If there are fewer than batchSize of them and there's a batch window, the batch is gathered first.
+**/
+void mpp::data::AsyncDBSession::startNext()
+{
+	if (busy || gathering || queue.empty())
+	{
+		return;
+	}
+
+	if (queue.size() < batchSize && batchWindow.count() > 0) // Give other connections a chance to add to the batch
+	{
+		gathering = true;
+		batchTimer.expires_after(batchWindow);
+		batchTimer.async_wait([this](const boost::system::error_code& e) // Cancelled if the batch fills up first, which ends the window just the same
+			{
+				gathering = false;
+				launch();
+			}
+		);
+		return;
+	}
+
+	launch();
+}
+
+/**
+* @desc Runs the lookups at the front of the queue, up to batchSize of them, as one query.
+**/
+void mpp::data::AsyncDBSession::launch()
+{
+	if (busy || queue.empty())
+	{
+		return;
+	}
+
+	busy = true;
+	retried = false;
+	batched = std::min(queue.size(), batchSize);
+
+	if (mysql)
+	{
+		query();
+	}
+
+	else // The last lookup lost the connection
+	{
+		connect([this](std::exception_ptr err)
+			{
+				if (err)
+				{
+					finish(err, std::map<std::string, NounFacts>());
+				}
+
+				else
+				{
+					query();
+				}
+			}
+		);
+	}
+}
+
+/**
+* @desc Allocates a connection handle, and sets the options that every connection needs.
+* @throws mpp::exceptions::DBError If the handle can't be allocated.
+**/
+void mpp::data::AsyncDBSession::open()
+{
+	mysql = mysql_init(nullptr);
+
+	if (!mysql)
+	{
+		mpp::exceptions::DBError ex(std::string("mpp::data::AsyncDBSession::open: couldn't allocate a connection handle!"));
+		throw ex;
+	}
+
+	mysql_options(mysql, MYSQL_OPT_NONBLOCK, nullptr); // Use the default stack size for the client's coroutines
+	mysql_options(mysql, MYSQL_SET_CHARSET_NAME, "utf8"); // Ensure that Malayalam nouns are fetched properly
+}
+
+/**
+* @desc Starts opening a new connection.
+* @param then Called once the connection is open, with nothing, or once it has failed to open, with a DBError.
+**/
+void mpp::data::AsyncDBSession::connect(std::function<void(std::exception_ptr)> then)
+{
+	#ifdef DEBUG
+	std::cout << "mpp::data::AsyncDBSession::connect: reopening the connection" << std::endl;
+	#endif
+
+	try
+	{
+		open();
+	}
+
+	catch (mpp::exceptions::DBError& dbe)
+	{
+		then(std::current_exception());
+		return;
+	}
+
+	std::shared_ptr<MYSQL*> ret = std::make_shared<MYSQL*>(nullptr); // Where the client stores its result
+	int status = mysql_real_connect_start(ret.get(), mysql, host.c_str(), user.c_str(), password.c_str(), dbName.c_str(), 0, nullptr, 0);
+
+	if (status != 0) // The socket exists once the client is waiting on it
+	{
+		sock.assign(mysql_get_socket(mysql));
+	}
+
+	await(status, [this, ret](int ready)
+		{
+			return mysql_real_connect_cont(ret.get(), mysql, ready);
+		},
+		[this, ret, then]()
+		{
+			if (!*ret)
+			{
+				std::exception_ptr err = dbError("connecting");
+				disconnect();
+				then(err);
+				return;
+			}
+
+			if (!sock.is_open()) // Connected without ever waiting
+			{
+				sock.assign(mysql_get_socket(mysql));
+			}
+
+			then(nullptr);
+		}
+	);
+}
+
+/**
+* @desc Starts the query for the running batch.
+**/
+void mpp::data::AsyncDBSession::query()
+{
+	std::set<std::string> nouns(queue.cbegin(), queue.cbegin() + batched); // Sorted, so that the same batch always sends the same query
+	std::string lookups; // A derived table of the nouns, which each half of the query is joined to, so that every row says which noun it's for
+
+	for (const std::string& noun : nouns)
+	{
+		std::string escaped(noun.size() * 2 + 1, '\0');
+		escaped.resize(mysql_real_escape_string(mysql, &escaped[0], noun.data(), noun.size()));
+		lookups += (lookups.empty() ? "SELECT '" : " UNION ALL SELECT '") + escaped + "'" + (lookups.empty() ? " AS noun" : "");
+	}
+
+	/*
+	* The same query as DBSession's facts statement, joined to the batch's nouns rather than comparing with one parameter, since the non-blocking API doesn't cover prepared statements' parameters any better than this.
+	* Each row carries the noun that it was asked for by exactly as it was sent, so the DB's collation can't make the rows of one noun look like another's.
+	*/
+	sql = "SELECT lookups.noun AS requested,nouns.noun AS noun,pluralisableNouns.pluralisable AS pluralisable,animacies.animate AS animate,humanNouns.humanity AS humanity,genders.gender AS gender,exceptions.plural AS plural,NULL AS singular"
+		" FROM (" + lookups + ") AS lookups"
+		" JOIN nouns ON nouns.noun=lookups.noun"
+		" LEFT JOIN pluralisableNouns ON pluralisableNouns.id=nouns.id"
+		" LEFT JOIN animacies ON animacies.id=nouns.id"
+		" LEFT JOIN humanNouns ON humanNouns.id=nouns.id"
+		" LEFT JOIN genders ON genders.id=nouns.id"
+		" LEFT JOIN exceptions ON exceptions.nid=nouns.id"
+		" UNION ALL"
+		" SELECT lookups.noun,NULL,NULL,NULL,NULL,NULL,NULL,nouns.noun"
+		" FROM (" + lookups + ") AS lookups"
+		" JOIN exceptions ON exceptions.plural=lookups.noun"
+		" JOIN nouns ON nouns.id=exceptions.nid";
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::AsyncDBSession::query: fetching facts about " << nouns.size() << " nouns, with " << (queue.size() - batched) << " more waiting" << std::endl;
+	#endif
+
+	await(mysql_real_query_start(&queryErr, mysql, sql.data(), sql.size()), [this](int ready)
+		{
+			return mysql_real_query_cont(&queryErr, mysql, ready);
+		},
+		[this]()
+		{
+			if (queryErr != 0)
+			{
+				fail("sending the query");
+				return;
+			}
+
+			await(mysql_store_result_start(&result, mysql), [this](int ready)
+				{
+					return mysql_store_result_cont(&result, mysql, ready);
+				},
+				[this]()
+				{
+					if (!result)
+					{
+						fail("reading the result");
+						return;
+					}
+
+					std::map<std::string, NounFacts> facts;
+
+					for (std::size_t i = 0; i < batched; i++)
+					{
+						facts[queue[i]].noun = queue[i];
+					}
+
+					fold(result, facts);
+					mysql_free_result(result); // Every row has already been read, so this doesn't touch the socket
+					result = nullptr;
+					finish(nullptr, std::move(facts));
+				}
+			);
+		}
+	);
+}
+
+/**
+* @desc Waits for whatever a non-blocking call is waiting for, then resumes it, until it's done.
+* @param status What the call returned: a MYSQL_WAIT_ mask, or 0 if it's done.
+* @param resume Continues the call.
+* @param done Called once the call is done.
+**/
+void mpp::data::AsyncDBSession::await(int status, Resume resume, std::function<void()> done)
+{
+	if (status == 0)
+	{
+		done();
+		return;
+	}
+
+	auto next = [this, resume, done](const boost::system::error_code& e, int ready)
+	{
+		if (e != boost::asio::error::operation_aborted) // Aborted waits belong to a connection that has been closed, or to a session that's being destroyed
+		{
+			await(resume(ready), resume, done);
+		}
+	};
+
+	/* No client timeouts are set, so the socket is always what's waited for unless the client asks for nothing else */
+	if (status & MYSQL_WAIT_WRITE) // Checked first, since a socket that the client also wants to read from will soon be writable anyway
+	{
+		sock.async_wait(boost::asio::posix::stream_descriptor::wait_write, [next](const boost::system::error_code& e)
+			{
+				next(e, MYSQL_WAIT_WRITE);
+			}
+		);
+	}
+
+	else if (status & (MYSQL_WAIT_READ | MYSQL_WAIT_EXCEPT))
+	{
+		sock.async_wait(boost::asio::posix::stream_descriptor::wait_read, [next](const boost::system::error_code& e)
+			{
+				next(e, MYSQL_WAIT_READ);
+			}
+		);
+	}
+
+	else // MYSQL_WAIT_TIMEOUT
+	{
+		timer.expires_after(std::chrono::milliseconds(mysql_get_timeout_value_ms(mysql)));
+		timer.async_wait([next](const boost::system::error_code& e)
+			{
+				next(e, MYSQL_WAIT_TIMEOUT);
+			}
+		);
+	}
+}
+
+/**
+* @desc Handles a failed query. The connection is closed, and if it was lost, the lookup is retried once on a new one.
+* @param where What was being done.
+**/
+void mpp::data::AsyncDBSession::fail(const std::string& where)
+{
+	unsigned int code = mysql_errno(mysql);
+	std::exception_ptr err = dbError(where);
+	disconnect();
+
+	if (!retried && (code == CR_SERVER_GONE_ERROR || code == CR_SERVER_LOST)) // The connection probably timed out, so try once more on a new one
+	{
+		retried = true;
+		connect([this](std::exception_ptr connErr)
+			{
+				if (connErr) // Bail out if we can't re-establish the connection
+				{
+					finish(connErr, std::map<std::string, NounFacts>());
+				}
+
+				else
+				{
+					query();
+				}
+			}
+		);
+	}
+
+	else
+	{
+		finish(err, std::map<std::string, NounFacts>());
+	}
+}
+
+/**
+* @desc Completes the running batch, then starts the next one.
+* @param err The error, if the query failed. Every lookup in the batch fails with it.
+* @param facts Each noun's facts, if it didn't.
+**/
+void mpp::data::AsyncDBSession::finish(std::exception_ptr err, std::map<std::string, NounFacts> facts)
+{
+	std::vector<std::pair<std::string, std::vector<FactsHandler>>> done; // Taken off the queue first, so that a handler which looks the same noun up again starts a new lookup
+
+	for (std::size_t i = 0; i < batched; i++)
+	{
+		std::unordered_map<std::string, std::vector<FactsHandler>>::iterator it = waiters.find(queue[i]);
+		done.emplace_back(queue[i], std::move(it->second));
+		nWaiting -= done.back().second.size();
+		waiters.erase(it);
+	}
+
+	queue.erase(queue.begin(), queue.begin() + batched);
+	batched = 0;
+	busy = false;
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::AsyncDBSession::finish: lookups of " << done.size() << " nouns " << (err ? "failed" : "succeeded") << std::endl;
+	#endif
+
+	for (std::pair<std::string, std::vector<FactsHandler>>& lookup : done)
+	{
+		if (filter && !err && !facts[lookup.first].exists && facts[lookup.first].exceptionalSingulars.empty()) // The filter let through a noun that it could have ruled out
+		{
+			filterStats.falsePositives += lookup.second.size();
+		}
+
+		for (FactsHandler& handler : lookup.second)
+		{
+			handler(err, (err ? NounFacts() : facts[lookup.first]));
+		}
+	}
+
+	startNext();
+}
+
+/**
+* @desc Closes the connection, so that the next lookup opens a new one.
+**/
+void mpp::data::AsyncDBSession::disconnect()
+{
+	if (result)
+	{
+		mysql_free_result(result);
+		result = nullptr;
+	}
+
+	if (sock.is_open()) // The client closes the socket itself
+	{
+		sock.release();
+	}
+
+	timer.cancel();
+	batchTimer.cancel();
+
+	if (mysql)
+	{
+		mysql_close(mysql);
+		mysql = nullptr;
+	}
+}
+
+/**
+* @desc Builds a DBError from the connection's last error.
+* @param where What was being done.
+* @return The error.
+**/
+std::exception_ptr mpp::data::AsyncDBSession::dbError(const std::string& where)
+{
+	std::ostringstream ess;
+	ess << "mpp::data::AsyncDBSession: error while " << where;
+
+	if (!queue.empty() && busy)
+	{
+		ess << " for " << batched << " nouns, starting with " << std::quoted(queue.front(), '\'');
+	}
+
+	ess << ": " << mysql_error(mysql) << " (#" << mysql_errno(mysql) << ")";
+	return std::make_exception_ptr(mpp::exceptions::DBError(ess.str()));
+}
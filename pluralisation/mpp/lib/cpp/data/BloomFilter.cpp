@@ -0,0 +1,116 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t, std::uint32_t
+
+/* Standard C++ */
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+#include <algorithm> // std::max
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* Our headers */
+#include "mpp/data/PerfectHash.hpp" // PerfectHash::hash
+#include "mpp/data/BloomFilter.hpp" // Class def'n
+
+namespace
+{
+	/* Odd multipliers, one per word, which turn the low half of a key's hash into a different bit for each word. These are the ones used by Impala's and Parquet's blocked filters. */
+	const std::uint32_t salts[BLOOMBLOCKWORDS] = {
+		0x47B6137BU,
+		0x44974D91U,
+		0x8824AD5BU,
+		0xA2B7289DU,
+		0x705495C7U,
+		0x2DF1424BU,
+		0x9EFC4947U,
+		0x5C6BFB31U
+	};
+};
+
+/**
+* @desc Constructor. Makes an empty filter, sized for a # of keys.
+* @param nKeys The # of keys that will be added. More can be added, at the cost of more false positives.
+* @param bitsPerKey The # of bits to use per key. 10 gives about 1 false positive in 100, and each 5 more cut that by about 10 times.
+**/
+mpp::data::BloomFilter::BloomFilter(std::size_t nKeys, unsigned bitsPerKey) : blocks(std::max<std::size_t>(1, (nKeys * bitsPerKey + sizeof(Block) * 8 - 1) / (sizeof(Block) * 8)), Block()),
+	nKeys(0)
+{
+	#ifdef DEBUG
+	std::cout << "mpp::data::BloomFilter::BloomFilter: made " << blocks.size() << " blocks for " << nKeys << " keys at " << bitsPerKey << " bits each" << std::endl;
+	#endif
+}
+
+/**
+* @desc Adds a key.
+* @param key The key.
+**/
+void mpp::data::BloomFilter::insert(std::string_view key)
+{
+	std::uint64_t masks[BLOOMBLOCKWORDS];
+	Block& block = blocks[locate(key, masks)];
+
+	for (std::size_t i = 0; i < BLOOMBLOCKWORDS; i++)
+	{
+		block.words[i] |= masks[i];
+	}
+
+	++nKeys;
+}
+
+/**
+* @desc Checks whether a key may have been added.
+* @param key The key.
+* @return False if the key was definitely never added, or true if it may have been.
+**/
+bool mpp::data::BloomFilter::mayContain(std::string_view key) const
+{
+	std::uint64_t masks[BLOOMBLOCKWORDS];
+	const Block& block = blocks[locate(key, masks)];
+	std::uint64_t missing = 0; // Any bit of the key that isn't set. Gathered without branching, so that the compiler can check every word at once.
+
+	for (std::size_t i = 0; i < BLOOMBLOCKWORDS; i++)
+	{
+		missing |= masks[i] & ~block.words[i];
+	}
+
+	return missing == 0;
+}
+
+/**
+* @desc Fetches the # of keys that have been added.
+* @return The # of keys, counting a key that was added twice twice.
+**/
+std::size_t mpp::data::BloomFilter::size() const
+{
+	return nKeys;
+}
+
+/**
+* @desc Fetches the size of the filter's bits.
+* @return The # of bytes.
+**/
+std::size_t mpp::data::BloomFilter::bytes() const
+{
+	return blocks.size() * sizeof(Block);
+}
+
+/**
+* @desc Finds a key's block, and the bit that it sets in each of the block's words.
+* @param key The key.
+* @param masks Set to the bit in each word.
+* @return The block's index.
+**/
+std::size_t mpp::data::BloomFilter::locate(std::string_view key, std::uint64_t (&masks)[BLOOMBLOCKWORDS]) const
+{
+	std::uint64_t h = PerfectHash::hash(key, BLOOMSEED);
+	std::uint32_t low = static_cast<std::uint32_t>(h);
+
+	for (std::size_t i = 0; i < BLOOMBLOCKWORDS; i++)
+	{
+		masks[i] = std::uint64_t(1) << ((low * salts[i]) >> 26); // The top 6 bits of the product pick one of 64 bits
+	}
+
+	return ((h >> 32) * blocks.size()) >> 32; // Maps the top half of the hash onto the blocks without dividing
+}
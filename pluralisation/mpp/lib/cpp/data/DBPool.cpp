@@ -0,0 +1,299 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+
+/* Standard C++ */
+#include <vector> // std::vector
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex, std::unique_lock, std::lock_guard
+#include <condition_variable> // std::condition_variable
+#include <thread> // std::thread
+#include <chrono> // std::chrono::seconds
+#include <exception> // std::exception
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* Our headers */
+#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information
+#include "mpp/data/DBSession.hpp" // A connection with prepared statements
+#include "mpp/data/DBPool.hpp" // Class def'n
+
+/**
+* @desc Constructor. Takes ownership of a checked-out session.
+* @param p The pool that the session belongs to.
+* @param s The session.
+**/
+mpp::data::DBPool::Lease::Lease(DBPool& p, DBSession* s) : pool(&p), session(s), broken(false)
+{
+}
+
+/**
+* @desc Move constructor. Leaves the other lease empty.
+* @param other The lease to take the session from.
+**/
+mpp::data::DBPool::Lease::Lease(Lease&& other) : pool(other.pool), session(other.session), broken(other.broken)
+{
+	other.pool = nullptr;
+	other.session = nullptr;
+}
+
+/**
+* @desc Destructor. Returns the session to the pool.
+**/
+mpp::data::DBPool::Lease::~Lease()
+{
+	if (pool)
+	{
+		pool->release(session, broken);
+	}
+}
+
+/**
+* @desc Accesses the session.
+* @return The checked-out session.
+**/
+mpp::data::DBSession* mpp::data::DBPool::Lease::operator->() const
+{
+	return session;
+}
+
+/**
+* @desc Accesses the session.
+* @return The checked-out session.
+**/
+mpp::data::DBSession& mpp::data::DBPool::Lease::operator*() const
+{
+	return *session;
+}
+
+/**
+* @desc Marks the session as broken, so that the pool reconnects it before lending it out again.
+**/
+void mpp::data::DBPool::Lease::markBroken()
+{
+	broken = true;
+}
+
+/**
+* @desc Constructor. Opens every session up front and starts the validation thread.
+* @param info Information needed to connect to the DB.
+* @param size The # of sessions in the pool. Requests wait for a free session once this many are checked out.
+* @param validateEvery How often idle sessions are checked. Zero disables the background thread.
+**/
+mpp::data::DBPool::DBPool(const DBInfo& info, std::size_t size, std::chrono::seconds validateEvery) : dbInfo(info),
+	interval(validateEvery),
+	repairPending(false),
+	stopping(false)
+{
+	sessions.reserve(size);
+	idle.reserve(size);
+
+	for (std::size_t i = 0; i < size; i++) // Connect and prepare everything before the first request arrives
+	{
+		sessions.emplace_back(new DBSession(dbInfo));
+		idle.push_back(sessions.back().get());
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::DBPool::DBPool: opened " << sessions.size() << " sessions" << std::endl;
+	#endif
+
+	if (interval.count() > 0)
+	{
+		validator = std::thread([this]()
+			{
+				validate();
+			}
+		);
+	}
+}
+
+/**
+* @desc Destructor. Stops the validation thread. Every lease must have been returned by now.
+**/
+mpp::data::DBPool::~DBPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stopping = true;
+	}
+
+	wake.notify_all();
+
+	if (validator.joinable())
+	{
+		validator.join();
+	}
+}
+
+/**
+* @desc Checks a session out of the pool, waiting for one to be returned if they're all in use.
+* @return A lease on the session.
+**/
+mpp::data::DBPool::Lease mpp::data::DBPool::acquire()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	available.wait(lock, [this]()
+		{
+			return !idle.empty() || !stale.empty();
+		}
+	);
+
+	if (!idle.empty())
+	{
+		DBSession* s = idle.back();
+		idle.pop_back();
+		return Lease(*this, s);
+	}
+
+	/* Only broken sessions are left, so fix one here rather than waiting for the validation thread */
+	DBSession* s = stale.back();
+	stale.pop_back();
+	lock.unlock();
+
+	try
+	{
+		s->reconnect();
+	}
+
+	catch (std::exception& e) // Put it back so that the pool doesn't shrink, and let the caller report the error
+	{
+		lock.lock();
+		stale.push_back(s);
+		lock.unlock();
+		available.notify_one();
+		throw;
+	}
+
+	return Lease(*this, s);
+}
+
+/**
+* @desc Fetches the # of sessions in the pool.
+* @return The pool's size.
+**/
+std::size_t mpp::data::DBPool::size() const
+{
+	return sessions.size();
+}
+
+/**
+* @desc Puts a session back into the pool. Called by Lease.
+* @param s The session to return.
+* @param broken Whether or not the session needs to be reconnected.
+**/
+void mpp::data::DBPool::release(DBSession* s, bool broken)
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		(broken ? stale : idle).push_back(s);
+		repairPending = repairPending || broken;
+	}
+
+	available.notify_one();
+
+	if (broken)
+	{
+		wake.notify_one(); // Let the validation thread reconnect it straight away
+	}
+}
+
+/**
+* @desc Body of the validation thread. Pings each idle session, and reconnects stale ones.
+**/
+void mpp::data::DBPool::validate()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	while (!stopping)
+	{
+		wake.wait_for(lock, interval, [this]()
+			{
+				return stopping || repairPending;
+			}
+		);
+
+		if (stopping)
+		{
+			break;
+		}
+
+		repairPending = false;
+
+		/* First, reconnect every session that was returned broken */
+		std::vector<DBSession*> toFix;
+		toFix.swap(stale);
+		lock.unlock();
+
+		for (DBSession*& s : toFix)
+		{
+			try
+			{
+				s->reconnect();
+			}
+
+			catch (std::exception& e) // The DB is probably down. Try again on the next pass.
+			{
+				#ifdef DEBUG
+				std::cout << "mpp::data::DBPool::validate: couldn't reconnect a session: " << e.what() << std::endl;
+				#endif
+				lock.lock();
+				stale.push_back(s);
+				lock.unlock();
+				s = nullptr;
+			}
+		}
+
+		lock.lock();
+
+		for (DBSession* s : toFix)
+		{
+			if (s)
+			{
+				idle.push_back(s);
+				available.notify_one();
+			}
+		}
+
+		/* Then ping the idle sessions, one at a time, so that requests can keep checking out the others */
+		std::size_t nToCheck = idle.size();
+
+		for (std::size_t i = 0; i < nToCheck && !stopping && !idle.empty(); i++)
+		{
+			DBSession* s = idle.back();
+			idle.pop_back();
+			lock.unlock();
+
+			bool ok = s->isAlive();
+
+			if (!ok)
+			{
+				try
+				{
+					s->reconnect();
+					ok = true;
+				}
+
+				catch (std::exception& e)
+				{
+					#ifdef DEBUG
+					std::cout << "mpp::data::DBPool::validate: couldn't reconnect a stale session: " << e.what() << std::endl;
+					#endif
+				}
+			}
+
+			lock.lock();
+
+			if (ok)
+			{
+				idle.insert(idle.begin(), s); // Put it at the far end, so that the next one checked is a different session
+				available.notify_one();
+			}
+
+			else
+			{
+				stale.push_back(s);
+			}
+		}
+	}
+}
@@ -0,0 +1,373 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <vector> // std::vector
+#include <unordered_map> // std::unordered_map
+#include <exception> // std::exception
+#include <sstream> // std::ostringstream
+#include <iomanip> // std::quoted
+#include <algorithm> // std::find
+#include <stdexcept> // std::out_of_range
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* MariaDB++ */
+#include <mariadb++/account.hpp> // mariadb::account::create
+#include <mariadb++/connection.hpp> // mariadb::connection::create
+#include <mariadb++/result_set.hpp> // mariadb::result_set_ref
+#include <mariadb++/exceptions.hpp> // mariadb::exception::connection
+
+/* Our headers */
+#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information
+#include "mpp/data/NounFacts.hpp" // What a lookup produces
+#include "mpp/exceptions/DBError.hpp" // Thrown if the DB can't be reached
+#include "mpp/data/DBSession.hpp" // Class def'n
+
+/**
+* @desc Constructor. Connects to the DB and prepares the statements.
+* @param info Information needed to connect to the DB.
+**/
+mpp::data::DBSession::DBSession(const DBInfo& info) : dbInfo(info)
+{
+	open();
+}
+
+/**
+* @desc Throws away the current connection and statements, and opens new ones.
+**/
+void mpp::data::DBSession::reconnect()
+{
+	#ifdef DEBUG
+	std::cout << "mpp::data::DBSession::reconnect: reopening the connection" << std::endl;
+	#endif
+	open();
+}
+
+/**
+* @desc Fetches everything that the DB knows about a noun in a single round-trip.
+*	If the connection has dropped, it's reopened and the query is retried once.
+* @param noun The noun to look up. UTF-8 encoded Malayalam text.
+* @return The noun's facts.
+**/
+mpp::data::NounFacts mpp::data::DBSession::getFacts(const std::string& noun)
+{
+	NounFacts toReturn;
+	toReturn.noun = noun;
+	mariadb::result_set_ref qRes;
+
+	try
+	{
+		factsStmt->set_string(0, noun); // The noun whose facts we want
+		factsStmt->set_string(1, noun); // The plural whose singulars we want
+		qRes = factsStmt->query();
+	}
+
+	catch (mariadb::exception::connection& mece) // The connection probably timed out, so try once more on a new one
+	{
+		try
+		{
+			open();
+			factsStmt->set_string(0, noun);
+			factsStmt->set_string(1, noun);
+			qRes = factsStmt->query();
+		}
+
+		catch (std::exception& secondEx) // Bail out if we can't re-establish the connection
+		{
+			std::ostringstream ess;
+			ess << "mpp::data::DBSession::getFacts: caught exception after failing to re-open the DB connection for a second time" << std::endl
+			<< "\tNoun: " << std::quoted(noun, '\'') << std::endl
+			<< "\tFirst exception: " << mece.what() << std::endl
+			<< "\tSecond exception: " << secondEx.what() << std::endl;
+			mpp::exceptions::DBError ex(ess.str());
+			throw ex;
+		}
+	}
+
+	bool hasExceptionRows = false; // Whether or not any exceptions rows were found for the noun
+
+	/*
+	* Fold the rows together. Rows with a NULL noun come from the second half of the query, and name a singular.
+	* The joins multiply rows, so the per-table ANDs see each value several times, which doesn't change the result.
+	*/
+	try
+	{
+		while (qRes->next())
+		{
+			if (qRes->get_is_null("noun")) // A noun which has this noun as an exceptional plural
+			{
+				std::string singular = qRes->get_string("singular");
+
+				if (std::find(toReturn.exceptionalSingulars.cbegin(), toReturn.exceptionalSingulars.cend(), singular) == toReturn.exceptionalSingulars.cend())
+				{
+					toReturn.exceptionalSingulars.push_back(singular);
+				}
+
+				continue;
+			}
+
+			if (!toReturn.exists) // First row for the noun itself
+			{
+				toReturn.exists = true;
+				toReturn.animate = true;
+				toReturn.human = true;
+				toReturn.exceptional = true;
+			}
+
+			if (!qRes->get_is_null("pluralisable"))
+			{
+				toReturn.pluralisable = toReturn.pluralisable && qRes->get_boolean("pluralisable");
+			}
+
+			toReturn.animate = toReturn.animate && !qRes->get_is_null("animate") && qRes->get_boolean("animate"); // A missing row means inanimate
+			toReturn.human = toReturn.human && !qRes->get_is_null("humanity") && qRes->get_boolean("humanity"); // A missing row means non-human
+
+			if (!qRes->get_is_null("gender"))
+			{
+				std::string genStr = qRes->get_string("gender");
+				toReturn.gender = (genStr == "Masculine" ? Masculine : (genStr == "Feminine" ? Feminine : Neuter));
+			}
+
+			if (!qRes->get_is_null("plural"))
+			{
+				std::string plural = qRes->get_string("plural");
+				hasExceptionRows = true;
+				toReturn.exceptional = toReturn.exceptional && !plural.empty(); // A noun has an irregular plural if the stored string isn't empty
+
+				if (std::find(toReturn.exceptionalPlurals.cbegin(), toReturn.exceptionalPlurals.cend(), plural) == toReturn.exceptionalPlurals.cend())
+				{
+					toReturn.exceptionalPlurals.push_back(plural);
+				}
+			}
+		}
+	}
+
+	catch (std::out_of_range& stdoore) // A column was missing from the result
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::DBSession::getFacts: caught out of range exception while reading the facts about " << std::quoted(noun, '\'') << std::endl
+		<< "Exception: " << stdoore.what() << std::endl;
+		mpp::exceptions::DBError ex(ess.str());
+		throw ex;
+	}
+
+	toReturn.exceptional = toReturn.exceptional && hasExceptionRows; // No exceptions rows means a regular plural
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::DBSession::getFacts: noun " << std::quoted(noun) << (toReturn.exists ? " is" : " isn't") << " in the DB, and is the exceptional plural of " << toReturn.exceptionalSingulars.size() << " nouns" << std::endl;
+	#endif
+
+	return toReturn;
+}
+
+/**
+* @desc Fetches the id of the newest row in the lexiconChanges table, which triggers on the noun tables fill in (see the server's README).
+* @return The id, or 0 if the table is empty.
+* @throws mpp::exceptions::DBError If the table can't be read.
+**/
+std::uint64_t mpp::data::DBSession::latestChange()
+{
+	try
+	{
+		mariadb::result_set_ref qRes = dbConn->query("SELECT COALESCE(MAX(id),0) AS id FROM lexiconChanges");
+		return (qRes->next() ? qRes->get_unsigned64("id") : 0);
+	}
+
+	catch (std::exception& e) // Most likely, the table hasn't been created
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::DBSession::latestChange: couldn't read the lexiconChanges table" << std::endl
+		<< "Exception: " << e.what() << std::endl;
+		mpp::exceptions::DBError ex(ess.str());
+		throw ex;
+	}
+}
+
+/**
+* @desc Reads up to LEXICONCHANGESBATCH rows of the lexiconChanges table, oldest first.
+* @param after Only rows with a later id are read. Set to the id of the last row that was read.
+* @param nouns Each noun named by the rows is appended, unless it's already there.
+* @return The # of rows read. If it's LEXICONCHANGESBATCH, there may be more.
+* @throws mpp::exceptions::DBError If the table can't be read.
+**/
+std::size_t mpp::data::DBSession::changedNouns(std::uint64_t& after, std::vector<std::string>& nouns)
+{
+	std::size_t toReturn = 0;
+
+	try
+	{
+		if (!changesStmt)
+		{
+			changesStmt = dbConn->create_statement("SELECT id,noun FROM lexiconChanges WHERE id>? ORDER BY id LIMIT " + std::to_string(LEXICONCHANGESBATCH));
+		}
+
+		changesStmt->set_unsigned64(0, after);
+		mariadb::result_set_ref qRes = changesStmt->query();
+
+		while (qRes->next())
+		{
+			std::string noun = qRes->get_string("noun");
+			after = qRes->get_unsigned64("id");
+			++toReturn;
+
+			if (std::find(nouns.cbegin(), nouns.cend(), noun) == nouns.cend()) // A noun usually changes in several tables at once
+			{
+				nouns.push_back(noun);
+			}
+		}
+	}
+
+	catch (std::exception& e) // The caller can reconnect and try again later; after is only advanced past rows that were read
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::DBSession::changedNouns: couldn't read the lexiconChanges table after row #" << after << std::endl
+		<< "Exception: " << e.what() << std::endl;
+		mpp::exceptions::DBError ex(ess.str());
+		throw ex;
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::DBSession::changedNouns: read " << toReturn << " changes, up to row #" << after << ", naming " << nouns.size() << " nouns so far" << std::endl;
+	#endif
+
+	return toReturn;
+}
+
+/**
+* @desc Reads every string that a lookup could find something about: every noun, and every exceptional plural.
+* @return The strings, each once.
+* @throws mpp::exceptions::DBError If the tables can't be read.
+**/
+std::vector<std::string> mpp::data::DBSession::lookupKeys()
+{
+	std::vector<std::string> toReturn;
+
+	try
+	{
+		mariadb::result_set_ref qRes = dbConn->query("SELECT noun AS lookupKey FROM nouns UNION SELECT plural FROM exceptions WHERE plural<>''"); // An empty plural only marks a regular noun
+
+		while (qRes->next())
+		{
+			toReturn.push_back(qRes->get_string("lookupKey"));
+		}
+	}
+
+	catch (std::exception& e)
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::DBSession::lookupKeys: couldn't read the nouns and their exceptional plurals" << std::endl
+		<< "Exception: " << e.what() << std::endl;
+		mpp::exceptions::DBError ex(ess.str());
+		throw ex;
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::DBSession::lookupKeys: read " << toReturn.size() << " keys" << std::endl;
+	#endif
+
+	return toReturn;
+}
+
+/**
+* @desc Reads every noun's exceptional plurals, e.g. so that the replies about a plural can be dropped once its singular no longer has it.
+* @return The plurals, keyed by the noun. Nouns without any are left out.
+* @throws mpp::exceptions::DBError If the table can't be read.
+**/
+std::unordered_map<std::string, std::vector<std::string>> mpp::data::DBSession::exceptionalPlurals()
+{
+	std::unordered_map<std::string, std::vector<std::string>> toReturn;
+
+	try
+	{
+		mariadb::result_set_ref qRes = dbConn->query("SELECT nouns.noun AS noun,exceptions.plural AS plural FROM nouns JOIN exceptions ON exceptions.nid=nouns.id WHERE exceptions.plural<>''");
+
+		while (qRes->next())
+		{
+			toReturn[qRes->get_string("noun")].push_back(qRes->get_string("plural"));
+		}
+	}
+
+	catch (std::exception& e)
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::DBSession::exceptionalPlurals: couldn't read the exceptional plurals" << std::endl
+		<< "Exception: " << e.what() << std::endl;
+		mpp::exceptions::DBError ex(ess.str());
+		throw ex;
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::DBSession::exceptionalPlurals: read the plurals of " << toReturn.size() << " nouns" << std::endl;
+	#endif
+
+	return toReturn;
+}
+
+/**
+* @desc Checks whether or not the connection still works by sending a trivial query over it.
+* @return True if the query succeeded, false if the connection is stale.
+**/
+bool mpp::data::DBSession::isAlive()
+{
+	if (!dbConn || !dbConn->connected())
+	{
+		return false;
+	}
+
+	try
+	{
+		mariadb::result_set_ref qRes = dbConn->query("SELECT 1");
+		return qRes && qRes->next();
+	}
+
+	catch (std::exception& e) // Any failure means that the session can't be used as it is
+	{
+		#ifdef DEBUG
+		std::cout << "mpp::data::DBSession::isAlive: ping failed: " << e.what() << std::endl;
+		#endif
+		return false;
+	}
+}
+
+/**
+* @desc Acquires the resources needed to communicate with the DB.
+**/
+void mpp::data::DBSession::open()
+{
+	changesStmt.reset(); // Belonged to the old connection, if there was one
+	dbAcc = mariadb::account::create(dbInfo.getHost(), dbInfo.getUser(), dbInfo.getPassword(), dbInfo.getDBName()); // Create a reference to the account, and open the DB we need on connection
+	dbConn = mariadb::connection::create(dbAcc); // Create a reference to a connection to the DB using our account info
+	dbConn->set_charset("utf8"); // Ensure that Malayalam nouns are fetched properly
+	dbConn->connect(); // Actually open the connection
+
+	if (!dbConn->connected())
+	{
+		mpp::exceptions::DBError ex(std::string("mpp::data::DBSession::open: Couldn't connect to DB!"));
+		throw ex;
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::DBSession::open: opened the connection" << std::endl;
+	#endif
+
+	factsStmt = dbConn->create_statement(
+		"SELECT nouns.noun AS noun,pluralisableNouns.pluralisable AS pluralisable,animacies.animate AS animate,humanNouns.humanity AS humanity,genders.gender AS gender,exceptions.plural AS plural,NULL AS singular"
+		" FROM nouns"
+		" LEFT JOIN pluralisableNouns ON pluralisableNouns.id=nouns.id"
+		" LEFT JOIN animacies ON animacies.id=nouns.id"
+		" LEFT JOIN humanNouns ON humanNouns.id=nouns.id"
+		" LEFT JOIN genders ON genders.id=nouns.id"
+		" LEFT JOIN exceptions ON exceptions.nid=nouns.id"
+		" WHERE nouns.noun=?"
+		" UNION ALL"
+		" SELECT NULL,NULL,NULL,NULL,NULL,NULL,nouns.noun FROM nouns JOIN exceptions ON exceptions.nid=nouns.id WHERE exceptions.plural=?"
+	);
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::DBSession::open: prepared the facts statement" << std::endl;
+	#endif
+}
@@ -0,0 +1,717 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t, std::uint32_t, std::uint16_t, std::uint8_t
+#include <cstring> // std::memcpy, std::memcmp, std::strerror
+#include <cstdio> // std::rename, std::remove
+#include <cerrno> // errno
+
+/* POSIX */
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <fcntl.h> // open
+#include <unistd.h> // close
+
+/* Standard C++ */
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+#include <map> // std::map
+#include <algorithm> // std::lower_bound, std::stable_sort, std::find
+#include <sstream> // std::ostringstream
+#include <iomanip> // std::quoted
+#include <ios> // std::ios
+#include <type_traits> // std::is_trivially_copyable
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* MariaDB++ */
+#include <mariadb++/account.hpp> // mariadb::account::create, mariadb::account_ref
+#include <mariadb++/connection.hpp> // mariadb::connection::create, mariadb::connection_ref
+#include <mariadb++/result_set.hpp> // mariadb::result_set_ref
+#include <mariadb++/exceptions.hpp> // mariadb::exception::connection
+
+/* Our headers */
+#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information
+#include "mpp/data/NounFacts.hpp" // What a lookup produces
+#include "mpp/data/PerfectHash.hpp" // Finds a noun's record
+#include "mpp/exceptions/DBError.hpp" // Thrown if the DB can't be read
+#include "mpp/exceptions/LexiconFileError.hpp" // Thrown if a lexicon file can't be read or written
+#include "mpp/data/Lexicon.hpp" // Class def'n
+
+namespace
+{
+	/**
+	* @desc Everything learnt about a single noun while the tables are being read.
+	**/
+	struct NounBuilder
+	{
+		bool pluralisable = true; // AND of pluralisableNouns rows
+		bool animate = true; // AND of animacies rows
+		bool hasAnimacy = false; // Whether or not any animacies rows were found
+		bool human = true; // AND of humanNouns rows
+		bool hasHumanity = false; // Whether or not any humanNouns rows were found
+		mpp::data::Gender gender = mpp::data::Unknown; // Last genders row
+		std::vector<std::string> plurals; // exceptions rows
+
+		/**
+		* @desc Resolves what's been learnt into the form that a DB lookup produces.
+		* @param noun The noun.
+		* @return The noun's facts, without exceptionalSingulars.
+		**/
+		mpp::data::NounFacts toFacts(const std::string& noun) const
+		{
+			mpp::data::NounFacts toReturn;
+			toReturn.noun = noun;
+			toReturn.exists = true;
+			toReturn.pluralisable = pluralisable;
+			toReturn.animate = hasAnimacy && animate;
+			toReturn.human = hasHumanity && human;
+			toReturn.gender = gender;
+			toReturn.exceptional = !plurals.empty(); // No exceptions rows means a regular plural
+			toReturn.exceptionalPlurals = plurals;
+
+			for (const std::string& plural : plurals)
+			{
+				toReturn.exceptional = toReturn.exceptional && !plural.empty();
+			}
+
+			return toReturn;
+		}
+	};
+
+	/**
+	* @desc The start of a lexicon file. It's followed by the record table, the plural table, the by-plural table, the perfect hash's pilots and slots, and the arena, in that order, each starting on an 8 byte boundary.
+	*	Everything is stored in the byte order of the machine that wrote it, so that the tables can be used without conversion.
+	**/
+	struct FileHeader
+	{
+		char magic[8]; // LEXICON_FILE_MAGIC
+		std::uint32_t version; // LEXICON_FILE_VERSION
+		std::uint32_t byteOrder; // BYTEORDERMARK, as the writer stored it
+		std::uint64_t nRecs; // # of noun records
+		std::uint64_t nPluralRefs; // # of entries in each plural table
+		std::uint64_t arenaSize; // Size of the arena in bytes
+		std::uint64_t recOff; // Offset of the record table from the start of the file
+		std::uint64_t pluralOff; // Offset of the plural table
+		std::uint64_t byPluralOff; // Offset of the by-plural table
+		std::uint64_t pilotOff; // Offset of the perfect hash's pilots. There are PerfectHash::bucketsFor(nRecs) of them.
+		std::uint64_t slotOff; // Offset of the perfect hash's slots. There are nRecs of them.
+		std::uint64_t hashSeed; // The perfect hash's seed
+		std::uint64_t arenaOff; // Offset of the arena
+		std::uint64_t fileSize; // Size of the whole file in bytes
+		std::uint64_t checksum; // FNV-1a hash of every byte after the header
+	};
+
+	// Reads differently on a machine of the other byte order
+	const std::uint32_t BYTEORDERMARK = 0x01020304;
+
+	/**
+	* @desc Hashes a block of bytes with 64-bit FNV-1a.
+	* @param data The bytes.
+	* @param len The # of bytes.
+	* @return The hash.
+	**/
+	std::uint64_t fnv1a(const char* data, std::size_t len)
+	{
+		std::uint64_t toReturn = 0xCBF29CE484222325ULL;
+
+		for (std::size_t i = 0; i < len; i++)
+		{
+			toReturn ^= static_cast<unsigned char>(data[i]);
+			toReturn *= 0x100000001B3ULL;
+		}
+
+		return toReturn;
+	}
+
+	/**
+	* @desc Rounds an offset up to the next 8 byte boundary.
+	* @param off The offset.
+	* @return The rounded offset.
+	**/
+	std::uint64_t align8(std::uint64_t off)
+	{
+		return (off + 7) & ~std::uint64_t(7);
+	}
+
+	/**
+	* @desc Checks whether or not a table lies entirely within a file, without overflowing.
+	* @param off The table's offset.
+	* @param count The # of elements in the table.
+	* @param elemSize The size of each element.
+	* @param fileSize The file's size.
+	* @return True if the table fits.
+	**/
+	bool fits(std::uint64_t off, std::uint64_t count, std::uint64_t elemSize, std::uint64_t fileSize)
+	{
+		return off <= fileSize && count <= (fileSize - off) / elemSize;
+	}
+};
+
+/**
+* @desc Constructor. Opens its own connection to the DB, reads every noun table, and builds the snapshot.
+* @param dbInfo Information needed to connect to the DB.
+**/
+mpp::data::Lexicon::Lexicon(const DBInfo& dbInfo) : hashSeed(0), recTable(nullptr), nRecs(0), pluralTable(nullptr), byPluralTable(nullptr), nPluralRefs(0), pilotTable(nullptr), slotTable(nullptr), mapping(nullptr), mappingSize(0)
+{
+	mariadb::account_ref dbAcc = mariadb::account::create(dbInfo.getHost(), dbInfo.getUser(), dbInfo.getPassword(), dbInfo.getDBName());
+	mariadb::connection_ref dbConn = mariadb::connection::create(dbAcc);
+	dbConn->set_charset("utf8"); // Ensure that Malayalam nouns are fetched properly
+	dbConn->connect();
+
+	if (!dbConn->connected())
+	{
+		mpp::exceptions::DBError ex(std::string("mpp::data::Lexicon::Lexicon: Couldn't connect to DB!"));
+		throw ex;
+	}
+
+	std::map<std::string, NounBuilder> nouns; // Sorted by noun, which is the order the records need to be in
+	std::string curQuery; // The query being run, for error messages
+
+	try
+	{
+		curQuery = "SELECT noun FROM nouns";
+		mariadb::result_set_ref qRes = dbConn->query(curQuery);
+
+		while (qRes->next())
+		{
+			nouns[qRes->get_string("noun")];
+		}
+
+		curQuery = "SELECT nouns.noun,pluralisableNouns.pluralisable FROM nouns JOIN pluralisableNouns ON nouns.id=pluralisableNouns.id";
+		qRes = dbConn->query(curQuery);
+
+		while (qRes->next())
+		{
+			NounBuilder& nb = nouns[qRes->get_string("noun")];
+			nb.pluralisable = nb.pluralisable && qRes->get_boolean("pluralisable");
+		}
+
+		curQuery = "SELECT nouns.noun,animacies.animate FROM nouns JOIN animacies ON animacies.id=nouns.id";
+		qRes = dbConn->query(curQuery);
+
+		while (qRes->next())
+		{
+			NounBuilder& nb = nouns[qRes->get_string("noun")];
+			nb.animate = nb.animate && qRes->get_boolean("animate");
+			nb.hasAnimacy = true;
+		}
+
+		curQuery = "SELECT nouns.noun,humanNouns.humanity FROM nouns JOIN humanNouns ON humanNouns.id=nouns.id";
+		qRes = dbConn->query(curQuery);
+
+		while (qRes->next())
+		{
+			NounBuilder& nb = nouns[qRes->get_string("noun")];
+			nb.human = nb.human && qRes->get_boolean("humanity");
+			nb.hasHumanity = true;
+		}
+
+		curQuery = "SELECT nouns.noun,genders.gender FROM nouns JOIN genders ON nouns.id=genders.id";
+		qRes = dbConn->query(curQuery);
+
+		while (qRes->next())
+		{
+			std::string genStr = qRes->get_string("gender");
+			nouns[qRes->get_string("noun")].gender = (genStr == "Masculine" ? Masculine : (genStr == "Feminine" ? Feminine : Neuter));
+		}
+
+		curQuery = "SELECT nouns.noun,exceptions.plural FROM nouns JOIN exceptions ON exceptions.nid=nouns.id";
+		qRes = dbConn->query(curQuery);
+
+		while (qRes->next())
+		{
+			nouns[qRes->get_string("noun")].plurals.push_back(qRes->get_string("plural"));
+		}
+	}
+
+	catch (mariadb::exception::connection& mece)
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::Lexicon::Lexicon: caught MariaDB connection exception while trying to execute query" << std::endl
+		<< "\t" << curQuery << std::endl
+		<< "Exception: " << mece.what() << std::endl;
+		mpp::exceptions::DBError ex(ess.str());
+		throw ex;
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::Lexicon::Lexicon: read " << nouns.size() << " nouns from the DB" << std::endl;
+	#endif
+
+	std::map<std::string, NounFacts> resolved; // Each noun's rows folded together
+
+	for (const auto& [noun, nb] : nouns)
+	{
+		resolved.emplace_hint(resolved.end(), noun, nb.toFacts(noun));
+	}
+
+	build(resolved);
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::Lexicon::Lexicon: built " << records.size() << " records, " << plurals.size() << " exceptional plurals and a " << arena.size() << " byte string arena" << std::endl;
+	#endif
+}
+
+/**
+* @desc Constructor. Copies another lexicon with some of its nouns' facts replaced, so that changes to the DB can be applied without reading every table again.
+* @param base The lexicon to copy. It may have been mapped from a file.
+* @param changes The current facts of every noun that has changed, as DBSession::getFacts returns them. A noun that no longer exists is removed, and one that's new is added.
+**/
+mpp::data::Lexicon::Lexicon(const Lexicon& base, const std::vector<NounFacts>& changes) : hashSeed(0), recTable(nullptr), nRecs(0), pluralTable(nullptr), byPluralTable(nullptr), nPluralRefs(0), pilotTable(nullptr), slotTable(nullptr), mapping(nullptr), mappingSize(0)
+{
+	std::map<std::string, NounFacts> nouns;
+
+	for (std::size_t i = 0; i < base.nRecs; i++) // Already sorted, so each insertion goes straight to the end
+	{
+		nouns.emplace_hint(nouns.end(), std::string(base.nounOf(base.recTable[i])), base.factsOf(base.recTable[i]));
+	}
+
+	for (const NounFacts& nf : changes)
+	{
+		if (nf.exists)
+		{
+			NounFacts& stored = nouns[nf.noun];
+			stored = nf;
+			stored.exceptionalSingulars.clear(); // Worked out from the plural table instead
+		}
+
+		else
+		{
+			nouns.erase(nf.noun);
+		}
+	}
+
+	build(nouns);
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::Lexicon::Lexicon: applied " << changes.size() << " changes to a lexicon of " << base.size() << " nouns, leaving " << records.size() << std::endl;
+	#endif
+}
+
+/**
+* @desc Constructor. Maps a file written by save() read-only. Its header, section bounds and checksum are checked once, here; the tables themselves are used as they are.
+* @param file The file's path.
+* @throws mpp::exceptions::LexiconFileError If the file can't be mapped, or isn't a valid lexicon file for this build.
+**/
+mpp::data::Lexicon::Lexicon(const FILESYSTEM_PATH& file) : hashSeed(0), recTable(nullptr), nRecs(0), pluralTable(nullptr), byPluralTable(nullptr), nPluralRefs(0), pilotTable(nullptr), slotTable(nullptr), mapping(nullptr), mappingSize(0)
+{
+	/* The tables are used straight from the file, so their layout must be fixed */
+	static_assert(std::is_trivially_copyable<NounRecord>::value && sizeof(NounRecord) == 16, "NounRecord's layout has changed; bump LEXICON_FILE_VERSION");
+	static_assert(std::is_trivially_copyable<PluralRef>::value && sizeof(PluralRef) == 12, "PluralRef's layout has changed; bump LEXICON_FILE_VERSION");
+	static_assert(std::is_trivially_copyable<PerfectHash::Slot>::value && sizeof(PerfectHash::Slot) == 8, "PerfectHash::Slot's layout has changed; bump LEXICON_FILE_VERSION");
+
+	std::ostringstream ess;
+	ess << "mpp::data::Lexicon::Lexicon: " << std::quoted(file.string()) << ": ";
+	int fd = ::open(file.string().c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+	{
+		ess << "couldn't open the file: " << std::strerror(errno);
+		mpp::exceptions::LexiconFileError ex(ess.str());
+		throw ex;
+	}
+
+	struct stat st;
+
+	if (::fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) < sizeof(FileHeader))
+	{
+		::close(fd);
+		ess << "too short to be a lexicon file";
+		mpp::exceptions::LexiconFileError ex(ess.str());
+		throw ex;
+	}
+
+	void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd); // The mapping keeps the file open
+
+	if (addr == MAP_FAILED)
+	{
+		ess << "couldn't map the file: " << std::strerror(errno);
+		mpp::exceptions::LexiconFileError ex(ess.str());
+		throw ex;
+	}
+
+	mapping = addr;
+	mappingSize = st.st_size;
+	const char* base = static_cast<const char*>(mapping);
+	FileHeader hdr;
+	std::memcpy(&hdr, base, sizeof(hdr));
+
+	/* Find the first thing wrong with the file, if anything */
+	const char* problem = nullptr;
+
+	if (std::memcmp(hdr.magic, LEXICON_FILE_MAGIC, sizeof(hdr.magic)) != 0)
+	{
+		problem = "not a lexicon file";
+	}
+
+	else if (hdr.byteOrder != BYTEORDERMARK)
+	{
+		problem = "written on a machine with a different byte order";
+	}
+
+	else if (hdr.version != LEXICON_FILE_VERSION)
+	{
+		problem = "written in a different version of the format; recompile it with mpp-lexc";
+	}
+
+	else if (hdr.fileSize != mappingSize)
+	{
+		problem = "truncated, or has trailing data";
+	}
+
+	else if (hdr.recOff % alignof(NounRecord) != 0 || hdr.pluralOff % alignof(PluralRef) != 0 || hdr.byPluralOff % alignof(PluralRef) != 0
+		|| hdr.pilotOff % alignof(std::uint32_t) != 0 || hdr.slotOff % alignof(PerfectHash::Slot) != 0
+		|| hdr.recOff < sizeof(FileHeader) || hdr.pluralOff < sizeof(FileHeader) || hdr.byPluralOff < sizeof(FileHeader)
+		|| hdr.pilotOff < sizeof(FileHeader) || hdr.slotOff < sizeof(FileHeader) || hdr.arenaOff < sizeof(FileHeader)
+		|| !fits(hdr.recOff, hdr.nRecs, sizeof(NounRecord), hdr.fileSize)
+		|| !fits(hdr.pluralOff, hdr.nPluralRefs, sizeof(PluralRef), hdr.fileSize)
+		|| !fits(hdr.byPluralOff, hdr.nPluralRefs, sizeof(PluralRef), hdr.fileSize)
+		|| !fits(hdr.pilotOff, PerfectHash::bucketsFor(hdr.nRecs), sizeof(std::uint32_t), hdr.fileSize)
+		|| !fits(hdr.slotOff, hdr.nRecs, sizeof(PerfectHash::Slot), hdr.fileSize)
+		|| !fits(hdr.arenaOff, hdr.arenaSize, 1, hdr.fileSize))
+	{
+		problem = "has a table outside the file";
+	}
+
+	else if (fnv1a(base + sizeof(FileHeader), mappingSize - sizeof(FileHeader)) != hdr.checksum)
+	{
+		problem = "checksum mismatch; the file is corrupt";
+	}
+
+	if (!problem)
+	{
+		arenaView = std::string_view(base + hdr.arenaOff, hdr.arenaSize);
+		recTable = reinterpret_cast<const NounRecord*>(base + hdr.recOff);
+		nRecs = hdr.nRecs;
+		pluralTable = reinterpret_cast<const PluralRef*>(base + hdr.pluralOff);
+		byPluralTable = reinterpret_cast<const PluralRef*>(base + hdr.byPluralOff);
+		nPluralRefs = hdr.nPluralRefs;
+		pilotTable = reinterpret_cast<const std::uint32_t*>(base + hdr.pilotOff);
+		slotTable = reinterpret_cast<const PerfectHash::Slot*>(base + hdr.slotOff);
+		hashSeed = hdr.hashSeed;
+		nounIndex = PerfectHash(hashSeed, pilotTable, slotTable, nRecs);
+
+		/* The checksum only catches damage, not a bad writer. Check every reference once, so that lookups never have to. */
+		for (std::size_t i = 0; i < nRecs && !problem; i++)
+		{
+			const NounRecord& rec = recTable[i];
+
+			if (std::uint64_t(rec.nounOff) + rec.nounLen > arenaView.size() || std::uint64_t(rec.pluralIdx) + rec.nPlurals > nPluralRefs || rec.gender > Unknown)
+			{
+				problem = "has a noun record that points outside its tables";
+			}
+
+			else if (nounIndex.find(nounOf(rec)) != i) // Also guards against slots that point outside the record table, since every slot is some noun's
+			{
+				problem = "has a perfect hash that doesn't find every noun";
+			}
+		}
+
+		for (std::size_t i = 0; i < nPluralRefs && !problem; i++)
+		{
+			for (const PluralRef* table : {pluralTable, byPluralTable})
+			{
+				if (std::uint64_t(table[i].off) + table[i].len > arenaView.size() || table[i].recIdx >= nRecs)
+				{
+					problem = "has a plural that points outside its tables";
+				}
+			}
+		}
+	}
+
+	if (problem)
+	{
+		::munmap(mapping, mappingSize); // The destructor won't run
+		ess << problem;
+		mpp::exceptions::LexiconFileError ex(ess.str());
+		throw ex;
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::Lexicon::Lexicon: mapped " << nRecs << " records, " << nPluralRefs << " exceptional plurals and a " << arenaView.size() << " byte string arena from " << file << std::endl;
+	#endif
+}
+
+/**
+* @desc Destructor. Unmaps the file, if the lexicon was mapped from one.
+**/
+mpp::data::Lexicon::~Lexicon()
+{
+	if (mapping)
+	{
+		::munmap(mapping, mappingSize);
+	}
+}
+
+/**
+* @desc Writes the lexicon to a file that can be mapped by the path constructor.
+*	The file is written under a temporary name and then renamed, so that servers which already have the old file mapped keep seeing a complete copy of it.
+* @param file The file's path.
+* @throws mpp::exceptions::LexiconFileError If the file can't be written.
+**/
+void mpp::data::Lexicon::save(const FILESYSTEM_PATH& file) const
+{
+	FileHeader hdr {};
+	std::memcpy(hdr.magic, LEXICON_FILE_MAGIC, sizeof(hdr.magic));
+	hdr.version = LEXICON_FILE_VERSION;
+	hdr.byteOrder = BYTEORDERMARK;
+	hdr.nRecs = nRecs;
+	hdr.nPluralRefs = nPluralRefs;
+	hdr.arenaSize = arenaView.size();
+	hdr.recOff = align8(sizeof(FileHeader));
+	hdr.pluralOff = align8(hdr.recOff + nRecs * sizeof(NounRecord));
+	hdr.byPluralOff = align8(hdr.pluralOff + nPluralRefs * sizeof(PluralRef));
+	hdr.pilotOff = align8(hdr.byPluralOff + nPluralRefs * sizeof(PluralRef));
+	hdr.slotOff = align8(hdr.pilotOff + PerfectHash::bucketsFor(nRecs) * sizeof(std::uint32_t));
+	hdr.hashSeed = hashSeed;
+	hdr.arenaOff = align8(hdr.slotOff + nRecs * sizeof(PerfectHash::Slot));
+	hdr.fileSize = hdr.arenaOff + hdr.arenaSize;
+
+	/* Lay out the whole file in memory, so that the checksum can be computed before anything is written */
+	std::string image(hdr.fileSize, '\0');
+	std::memcpy(&image[hdr.recOff], recTable, nRecs * sizeof(NounRecord));
+	std::memcpy(&image[hdr.pluralOff], pluralTable, nPluralRefs * sizeof(PluralRef));
+	std::memcpy(&image[hdr.byPluralOff], byPluralTable, nPluralRefs * sizeof(PluralRef));
+	std::memcpy(&image[hdr.pilotOff], pilotTable, PerfectHash::bucketsFor(nRecs) * sizeof(std::uint32_t));
+	std::memcpy(&image[hdr.slotOff], slotTable, nRecs * sizeof(PerfectHash::Slot));
+	std::memcpy(&image[hdr.arenaOff], arenaView.data(), arenaView.size());
+	hdr.checksum = fnv1a(image.data() + sizeof(FileHeader), image.size() - sizeof(FileHeader));
+	std::memcpy(&image[0], &hdr, sizeof(hdr));
+
+	/* Overwriting the file in place would change it under the feet of any process that has it mapped */
+	std::string tmpPath = file.string() + ".tmp";
+	OFSTREAM out(tmpPath, std::ios::binary | std::ios::trunc);
+	out.write(image.data(), image.size());
+	out.close();
+
+	if (!out || std::rename(tmpPath.c_str(), file.string().c_str()) != 0)
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::Lexicon::save: couldn't write " << std::quoted(file.string()) << ": " << std::strerror(errno);
+		std::remove(tmpPath.c_str());
+		mpp::exceptions::LexiconFileError ex(ess.str());
+		throw ex;
+	}
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::Lexicon::save: wrote " << hdr.fileSize << " bytes to " << file << std::endl;
+	#endif
+}
+
+/**
+* @desc Finds the record for a noun.
+* @param noun The noun to look up. UTF-8 encoded Malayalam text.
+* @return A pointer to the noun's record, or nullptr if the noun isn't in the lexicon.
+**/
+const mpp::data::Lexicon::NounRecord* mpp::data::Lexicon::find(std::string_view noun) const
+{
+	std::uint32_t idx = nounIndex.find(noun);
+
+	if (idx != MPHNOTFOUND && nounOf(recTable[idx]) == noun) // The fingerprint has already turned away almost every other noun, so this comparison almost always succeeds
+	{
+		return &recTable[idx];
+	}
+
+	return nullptr;
+}
+
+/**
+* @desc Gathers everything known about a noun, in the same form as a DB lookup would.
+* @param noun The noun to look up. UTF-8 encoded Malayalam text.
+* @return The noun's facts. If it isn't in the lexicon, only exceptionalSingulars may be filled in.
+**/
+mpp::data::NounFacts mpp::data::Lexicon::facts(const std::string& noun) const
+{
+	const NounRecord* rec = find(noun);
+	NounFacts toReturn;
+
+	if (rec)
+	{
+		toReturn = factsOf(*rec);
+	}
+
+	else
+	{
+		toReturn.noun = noun;
+	}
+
+	toReturn.exceptionalSingulars = singularsOf(noun);
+	return toReturn;
+}
+
+/**
+* @desc Fetches the text of a record's noun.
+* @param rec A record belonging to this lexicon.
+* @return A view of the noun, which lives as long as the lexicon.
+**/
+std::string_view mpp::data::Lexicon::nounOf(const NounRecord& rec) const
+{
+	return str(rec.nounOff, rec.nounLen);
+}
+
+/**
+* @desc Fetches a noun's exceptional plurals, in the order that the exceptions table returned them.
+* @param rec A record belonging to this lexicon.
+* @return Every exceptions.plural value stored for the noun (possibly none).
+**/
+std::vector<std::string> mpp::data::Lexicon::exceptionalPlurals(const NounRecord& rec) const
+{
+	std::vector<std::string> toReturn;
+	toReturn.reserve(rec.nPlurals);
+
+	for (std::uint32_t i = rec.pluralIdx; i < rec.pluralIdx + rec.nPlurals; i++)
+	{
+		toReturn.emplace_back(str(pluralTable[i].off, pluralTable[i].len));
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Finds the singular forms of an exceptional plural.
+* @param plural A plural which may or may not be stored in the exceptions table.
+* @return The nouns which have the given plural as an exceptional plural (possibly none).
+**/
+std::vector<std::string> mpp::data::Lexicon::singularsOf(std::string_view plural) const
+{
+	std::vector<std::string> toReturn;
+	const PluralRef* end = byPluralTable + nPluralRefs;
+	const PluralRef* it = std::lower_bound(byPluralTable, end, plural, [this](const PluralRef& ref, std::string_view key)
+		{
+			return str(ref.off, ref.len) < key;
+		}
+	);
+
+	for (; it != end && str(it->off, it->len) == plural; ++it)
+	{
+		std::string_view singular = nounOf(recTable[it->recIdx]);
+
+		if (std::find(toReturn.cbegin(), toReturn.cend(), singular) == toReturn.cend()) // The DB returns each noun once, even if it has the same plural twice
+		{
+			toReturn.emplace_back(singular);
+		}
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Fetches the number of nouns in the lexicon.
+* @return The number of noun records.
+**/
+std::size_t mpp::data::Lexicon::size() const
+{
+	return nRecs;
+}
+
+/**
+* @desc Fetches a view of a string in the arena.
+* @param off The string's offset.
+* @param len The string's length.
+* @return A view of the string.
+**/
+std::string_view mpp::data::Lexicon::str(std::uint32_t off, std::uint32_t len) const
+{
+	return std::string_view(arenaView.data() + off, len);
+}
+
+/**
+* @desc Appends a string to the arena.
+* @param s The string to append.
+* @return The offset at which it was stored.
+**/
+std::uint32_t mpp::data::Lexicon::intern(const std::string& s)
+{
+	std::uint32_t off = static_cast<std::uint32_t>(arena.size());
+	arena.append(s);
+	return off;
+}
+
+/**
+* @desc Fetches the facts stored in a record. exceptionalSingulars isn't filled in, since it doesn't come from the record.
+* @param rec A record belonging to this lexicon.
+* @return The facts.
+**/
+mpp::data::NounFacts mpp::data::Lexicon::factsOf(const NounRecord& rec) const
+{
+	NounFacts toReturn;
+	toReturn.noun = nounOf(rec);
+	toReturn.exists = true;
+	toReturn.pluralisable = (rec.flags & Pluralisable) != 0;
+	toReturn.animate = (rec.flags & Animate) != 0;
+	toReturn.human = (rec.flags & Human) != 0;
+	toReturn.gender = static_cast<Gender>(rec.gender);
+	toReturn.exceptional = (rec.flags & Exceptional) != 0;
+	toReturn.exceptionalPlurals = exceptionalPlurals(rec);
+	return toReturn;
+}
+
+/**
+* @desc Flattens a set of nouns into the arena, the record and plural tables and the perfect hash, and points lookups at them.
+* @param nouns Every noun's facts, keyed (and so sorted) by noun.
+**/
+void mpp::data::Lexicon::build(const std::map<std::string, NounFacts>& nouns)
+{
+	/* Flatten the map into the arena and the record table */
+	records.reserve(nouns.size());
+
+	for (const auto& [noun, nf] : nouns)
+	{
+		NounRecord rec;
+		rec.nounOff = intern(noun);
+		rec.nounLen = static_cast<std::uint16_t>(noun.size());
+		rec.flags = (nf.pluralisable ? Pluralisable : 0)
+			| (nf.animate ? Animate : 0)
+			| (nf.human ? Human : 0)
+			| (nf.exceptional ? Exceptional : 0);
+		rec.gender = nf.gender;
+		rec.pluralIdx = static_cast<std::uint32_t>(plurals.size());
+		rec.nPlurals = static_cast<std::uint32_t>(nf.exceptionalPlurals.size());
+
+		for (const std::string& plural : nf.exceptionalPlurals)
+		{
+			plurals.push_back(PluralRef{intern(plural), static_cast<std::uint32_t>(plural.size()), static_cast<std::uint32_t>(records.size())});
+		}
+
+		records.push_back(rec);
+	}
+
+	byPlural = plurals;
+	useOwnTables(); // Before sorting, since the comparison reads the arena through arenaView
+	std::stable_sort(byPlural.begin(), byPlural.end(), [this](const PluralRef& a, const PluralRef& b)
+		{
+			return str(a.off, a.len) < str(b.off, b.len);
+		}
+	);
+
+	/* Hash the nouns, so that a record's index is its key's index */
+	std::vector<std::string_view> keys;
+	keys.reserve(records.size());
+
+	for (const NounRecord& rec : records)
+	{
+		keys.push_back(nounOf(rec));
+	}
+
+	hashSeed = PerfectHash::build(keys, pilots, slots);
+	useOwnTables();
+}
+
+/**
+* @desc Points the tables that lookups use at the arena and vectors built by build(), including the perfect hash's.
+**/
+void mpp::data::Lexicon::useOwnTables()
+{
+	arenaView = arena;
+	recTable = records.data();
+	nRecs = records.size();
+	pluralTable = plurals.data();
+	byPluralTable = byPlural.data();
+	nPluralRefs = plurals.size();
+	pilotTable = pilots.data();
+	slotTable = slots.data();
+	nounIndex = PerfectHash(hashSeed, pilotTable, slotTable, slots.size());
+}
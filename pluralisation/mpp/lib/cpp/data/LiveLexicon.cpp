@@ -0,0 +1,168 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* Standard C++ */
+#include <atomic> // std::atomic, std::memory_order_release
+#include <memory> // std::shared_ptr
+#include <mutex> // std::lock_guard
+#include <algorithm> // std::min, std::remove_if
+#include <limits> // std::numeric_limits
+#include <utility> // std::move
+#include <sstream> // std::ostringstream
+#include <stdexcept> // std::out_of_range, std::invalid_argument
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* Our headers */
+#include "mpp/data/Lexicon.hpp" // What's published
+#include "mpp/data/LiveLexicon.hpp" // Class def'n
+
+/**
+* @desc Constructor. Pins the current lexicon.
+* @param live The lexicon to read.
+* @param reader The reading thread's slot, from 0 to readers() - 1.
+* @throws std::out_of_range If there's no such slot.
+**/
+mpp::data::LiveLexicon::Snapshot::Snapshot(const LiveLexicon& live, std::size_t reader) : pin(live.slots[reader < live.nReaders ? reader : 0].pinned)
+{
+	if (reader >= live.nReaders)
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::LiveLexicon::Snapshot::Snapshot: reader #" << reader << " doesn't exist; there are " << live.nReaders << " readers.";
+		throw std::out_of_range(ess.str());
+	}
+
+	/*
+	* Announce the epoch before loading the pointer. Both are sequentially consistent, so if the pointer loaded here is later replaced,
+	* the epoch stored here is no later than the one it's retired under, and reclaim() will see this pin.
+	*/
+	pin.store(live.epoch.load());
+	lex = live.published.load();
+}
+
+/**
+* @desc Destructor. Unpins the lexicon.
+**/
+mpp::data::LiveLexicon::Snapshot::~Snapshot()
+{
+	pin.store(0, std::memory_order_release); // Every read of the lexicon happens before reclaim() sees this
+}
+
+/**
+* @desc Fetches the pinned lexicon.
+* @return The lexicon. Only valid while this snapshot exists.
+**/
+const mpp::data::Lexicon* mpp::data::LiveLexicon::Snapshot::operator->() const
+{
+	return lex;
+}
+
+/**
+* @desc Fetches the pinned lexicon.
+* @return The lexicon. Only valid while this snapshot exists.
+**/
+const mpp::data::Lexicon& mpp::data::LiveLexicon::Snapshot::operator*() const
+{
+	return *lex;
+}
+
+/**
+* @desc Constructor.
+* @param initial The first lexicon to publish. Must not be null.
+* @param nReaders The # of threads that will read it. Must be positive.
+**/
+mpp::data::LiveLexicon::LiveLexicon(std::shared_ptr<const Lexicon> initial, std::size_t nReaders) : published(initial.get()),
+	epoch(1),
+	slots(new ReaderSlot[nReaders]),
+	nReaders(nReaders),
+	owner(initial)
+{
+	if (!initial || nReaders == 0)
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::LiveLexicon::LiveLexicon: " << (initial ? "there must be at least one reader." : "there's no lexicon to publish.");
+		throw std::invalid_argument(ess.str());
+	}
+}
+
+/**
+* @desc Makes a new lexicon current. Requests that have already pinned the old one keep using it; every later one sees the new one.
+*	The old lexicon is retired, and freed by a later call to reclaim().
+* @param next The lexicon to publish. Must not be null.
+**/
+void mpp::data::LiveLexicon::publish(std::shared_ptr<const Lexicon> next)
+{
+	if (!next)
+	{
+		std::ostringstream ess;
+		ess << "mpp::data::LiveLexicon::publish: there's no lexicon to publish.";
+		throw std::invalid_argument(ess.str());
+	}
+
+	std::lock_guard<std::mutex> lock(writerMtx);
+	published.store(next.get());
+	std::uint64_t retiredIn = epoch.fetch_add(1); // Any reader that loaded the old pointer pinned this epoch or an earlier one
+	retired.emplace_back(retiredIn, std::move(owner));
+	owner = std::move(next);
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::LiveLexicon::publish: published a lexicon of " << owner->size() << " nouns in epoch " << (retiredIn + 1) << ", with " << retired.size() << " waiting to be reclaimed" << std::endl;
+	#endif
+}
+
+/**
+* @desc Frees every retired lexicon that no reader can still be using.
+* @return The # of retired lexicons that are still pinned.
+**/
+std::size_t mpp::data::LiveLexicon::reclaim()
+{
+	std::lock_guard<std::mutex> lock(writerMtx);
+	std::uint64_t oldestPin = std::numeric_limits<std::uint64_t>::max();
+
+	for (std::size_t i = 0; i < nReaders; i++)
+	{
+		std::uint64_t pinned = slots[i].pinned.load();
+
+		if (pinned != 0)
+		{
+			oldestPin = std::min(oldestPin, pinned);
+		}
+	}
+
+	/* A lexicon retired in epoch e can only be pinned by a reader whose pin is e or earlier */
+	retired.erase(
+		std::remove_if(retired.begin(), retired.end(), [oldestPin](const std::pair<std::uint64_t, std::shared_ptr<const Lexicon>>& r)
+			{
+				return r.first < oldestPin;
+			}
+		),
+		retired.end()
+	);
+
+	#ifdef DEBUG
+	std::cout << "mpp::data::LiveLexicon::reclaim: " << retired.size() << " retired lexicons are still pinned" << std::endl;
+	#endif
+
+	return retired.size();
+}
+
+/**
+* @desc Fetches the current lexicon, for use outside of the readers' threads.
+* @return The lexicon. Holding on to it delays its destruction, but not its retirement.
+**/
+std::shared_ptr<const mpp::data::Lexicon> mpp::data::LiveLexicon::current() const
+{
+	std::lock_guard<std::mutex> lock(writerMtx);
+	return owner;
+}
+
+/**
+* @desc Fetches the # of reader slots.
+* @return The # of slots.
+**/
+std::size_t mpp::data::LiveLexicon::readers() const
+{
+	return nReaders;
+}
@@ -0,0 +1,274 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t, std::uint32_t
+#include <cstring> // std::memcpy
+
+/* Standard C++ */
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+#include <algorithm> // std::fill, std::find, std::stable_sort
+#include <numeric> // std::iota, std::partial_sum
+#include <sstream> // std::ostringstream
+#include <stdexcept> // std::runtime_error
+#ifdef DEBUG
+#include <iostream> // std::cout
+#endif
+
+/* Our headers */
+#include "mpp/data/PerfectHash.hpp" // Class def'n
+
+namespace
+{
+	/**
+	* @desc Scrambles a 64-bit value, so that every bit of the result depends on every bit of the input. This is MurmurHash3's finaliser.
+	* @param x The value.
+	* @return The scrambled value.
+	**/
+	std::uint64_t mix(std::uint64_t x)
+	{
+		x ^= x >> 33;
+		x *= 0xFF51AFD7ED558CCDULL;
+		x ^= x >> 33;
+		x *= 0xC4CEB9FE1A85EC53ULL;
+		x ^= x >> 33;
+		return x;
+	}
+};
+
+/**
+* @desc Builds the tables for a set of keys.
+* @param keys The keys. They must all be different.
+* @param pilots Set to one pilot per bucket.
+* @param slots Set to one slot per key.
+* @return The seed that the tables were built with.
+* @throws std::runtime_error If no seed works, which only happens if two keys are the same.
+**/
+std::uint64_t mpp::data::PerfectHash::build(const std::vector<std::string_view>& keys, std::vector<std::uint32_t>& pilots, std::vector<Slot>& slots)
+{
+	std::size_t n = keys.size();
+	std::size_t nBuckets = bucketsFor(n);
+	std::vector<std::uint64_t> hashes(n);
+	std::vector<std::size_t> bucketStart(nBuckets + 1); // Where each bucket's keys start in byBucket
+	std::vector<std::size_t> byBucket(n); // Key indices, grouped by bucket
+	std::vector<std::size_t> bucketOrder(nBuckets); // Biggest bucket first
+	std::vector<bool> taken(n); // Slots used so far
+	std::vector<std::size_t> positions; // Where the current bucket's keys would go
+
+	for (std::uint64_t attempt = 0; attempt < MPHMAXSEEDS; attempt++)
+	{
+		std::uint64_t seed = mix(attempt + 1);
+
+		/* Group the keys by bucket */
+		std::fill(bucketStart.begin(), bucketStart.end(), 0);
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			hashes[i] = hash(keys[i], seed);
+			++bucketStart[bucketOf(hashes[i], nBuckets) + 1];
+		}
+
+		std::partial_sum(bucketStart.begin(), bucketStart.end(), bucketStart.begin());
+		std::vector<std::size_t> next(bucketStart.begin(), bucketStart.end() - 1);
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			byBucket[next[bucketOf(hashes[i], nBuckets)]++] = i;
+		}
+
+		/* Place the biggest buckets first, while it's still easy to find room for them */
+		std::iota(bucketOrder.begin(), bucketOrder.end(), 0);
+		std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&bucketStart](std::size_t a, std::size_t b)
+			{
+				return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+			}
+		);
+
+		taken.assign(n, false);
+		pilots.assign(nBuckets, 0);
+		slots.assign(n, Slot {MPHNOTFOUND, 0});
+		bool placedAll = true;
+
+		for (std::size_t b : bucketOrder)
+		{
+			std::size_t first = bucketStart[b];
+			std::size_t last = bucketStart[b + 1];
+
+			if (first == last) // Every bucket after this one is empty too
+			{
+				break;
+			}
+
+			/* Keys with the same hash always land on the same slot, so only another seed can separate them */
+			for (std::size_t i = first; i < last && placedAll; i++)
+			{
+				for (std::size_t j = i + 1; j < last && placedAll; j++)
+				{
+					placedAll = (hashes[byBucket[i]] != hashes[byBucket[j]]);
+				}
+			}
+
+			std::uint32_t pilot = 0;
+
+			for (; placedAll && pilot < MPHMAXPILOT; pilot++) // Find a pilot that puts every key in the bucket on a free slot of its own
+			{
+				positions.clear();
+
+				for (std::size_t i = first; i < last; i++)
+				{
+					std::size_t pos = slotOf(hashes[byBucket[i]], pilot, n);
+
+					if (taken[pos] || std::find(positions.cbegin(), positions.cend(), pos) != positions.cend())
+					{
+						break;
+					}
+
+					positions.push_back(pos);
+				}
+
+				if (positions.size() == last - first)
+				{
+					break;
+				}
+			}
+
+			if (!placedAll || pilot == MPHMAXPILOT)
+			{
+				placedAll = false;
+				break;
+			}
+
+			pilots[b] = pilot;
+
+			for (std::size_t i = first; i < last; i++)
+			{
+				std::size_t k = byBucket[i];
+				std::size_t pos = positions[i - first];
+				taken[pos] = true;
+				slots[pos] = Slot {static_cast<std::uint32_t>(k), fingerprintOf(hashes[k])};
+			}
+		}
+
+		if (placedAll)
+		{
+			#ifdef DEBUG
+			std::cout << "mpp::data::PerfectHash::build: placed " << n << " keys in " << nBuckets << " buckets with seed #" << attempt << std::endl;
+			#endif
+
+			return seed;
+		}
+
+		#ifdef DEBUG
+		std::cout << "mpp::data::PerfectHash::build: seed #" << attempt << " failed, trying another" << std::endl;
+		#endif
+	}
+
+	std::ostringstream ess;
+	ess << "mpp::data::PerfectHash::build: couldn't place " << n << " keys with any of " << MPHMAXSEEDS << " seeds. Are some of them the same?";
+	throw std::runtime_error(ess.str());
+}
+
+/**
+* @desc Fetches the # of buckets that build() uses for a # of keys.
+* @param nKeys The # of keys.
+* @return The # of buckets.
+**/
+std::size_t mpp::data::PerfectHash::bucketsFor(std::size_t nKeys)
+{
+	return (nKeys + MPHBUCKETSIZE - 1) / MPHBUCKETSIZE;
+}
+
+/**
+* @desc Constructor. Makes an empty function, which finds nothing.
+**/
+mpp::data::PerfectHash::PerfectHash() : seed(0), pilots(nullptr), slots(nullptr), nSlots(0), nBuckets(0)
+{
+}
+
+/**
+* @desc Constructor. Uses tables made by build().
+* @param seed The seed returned by build().
+* @param pilots The pilots. There must be bucketsFor(nSlots) of them.
+* @param slots The slots.
+* @param nSlots The # of slots, i.e. the # of keys.
+**/
+mpp::data::PerfectHash::PerfectHash(std::uint64_t seed, const std::uint32_t* pilots, const Slot* slots, std::size_t nSlots) : seed(seed), pilots(pilots), slots(slots), nSlots(nSlots), nBuckets(bucketsFor(nSlots))
+{
+}
+
+/**
+* @desc Finds the index of a key.
+* @param key The key.
+* @return The index that build() was given the key at, or MPHNOTFOUND if the key's fingerprint doesn't match its slot's. Keys outside the set match with a probability of 1 in 2^32, so the caller must still check the key at the index.
+**/
+std::uint32_t mpp::data::PerfectHash::find(std::string_view key) const
+{
+	if (nSlots == 0)
+	{
+		return MPHNOTFOUND;
+	}
+
+	std::uint64_t h = hash(key, seed);
+	const Slot& slot = slots[slotOf(h, pilots[bucketOf(h, nBuckets)], nSlots)];
+	return (slot.fingerprint == fingerprintOf(h) ? slot.index : MPHNOTFOUND);
+}
+
+/**
+* @desc Hashes a key.
+* @param key The key.
+* @param seed The seed.
+* @return The hash.
+**/
+std::uint64_t mpp::data::PerfectHash::hash(std::string_view key, std::uint64_t seed)
+{
+	std::uint64_t toReturn = seed ^ (key.size() * 0x9E3779B97F4A7C15ULL);
+	std::size_t i = 0;
+
+	for (; i + sizeof(std::uint64_t) <= key.size(); i += sizeof(std::uint64_t)) // A word at a time. Malayalam letters are 3 bytes each, so nouns are rarely short.
+	{
+		std::uint64_t word;
+		std::memcpy(&word, key.data() + i, sizeof(word));
+		toReturn = mix(toReturn ^ word);
+	}
+
+	std::uint64_t tail = 0;
+
+	if (i < key.size())
+	{
+		std::memcpy(&tail, key.data() + i, key.size() - i);
+	}
+
+	return mix(toReturn ^ tail);
+}
+
+/**
+* @desc Finds a hash's bucket.
+* @param h The hash.
+* @param nBuckets The # of buckets.
+* @return The bucket's index.
+**/
+std::size_t mpp::data::PerfectHash::bucketOf(std::uint64_t h, std::size_t nBuckets)
+{
+	return ((h >> 32) * nBuckets) >> 32; // Maps the top half of the hash onto [0, nBuckets) without dividing
+}
+
+/**
+* @desc Finds a hash's slot, given its bucket's pilot.
+* @param h The hash.
+* @param pilot The pilot.
+* @param nSlots The # of slots.
+* @return The slot's index.
+**/
+std::size_t mpp::data::PerfectHash::slotOf(std::uint64_t h, std::uint32_t pilot, std::size_t nSlots)
+{
+	return mix(h ^ (pilot * 0x9E3779B97F4A7C15ULL)) % nSlots;
+}
+
+/**
+* @desc Computes a hash's fingerprint.
+* @param h The hash.
+* @return The fingerprint.
+**/
+std::uint32_t mpp::data::PerfectHash::fingerprintOf(std::uint64_t h)
+{
+	return static_cast<std::uint32_t>(mix(h + 0xD6E8FEB86659FD93ULL) >> 32);
+}
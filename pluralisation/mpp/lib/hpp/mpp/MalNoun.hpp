@@ -0,0 +1,148 @@
+#ifndef MPP_MALNOUN_HPP
+#define MPP_MALNOUN_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <functional> // std::hash
+
+// The most code points that a MalNoun holds without allocating. Nearly every noun is shorter.
+#define MALNOUNINLINE 24
+
+// The first code point of the Malayalam block, which every code point of a MalNoun is an offset from
+#define MALAYALAMBASE 0x0D00
+
+namespace mpp
+{
+	/**
+	* @desc A noun made only of code points from the Malayalam block (U+0D00-U+0D7F), stored as one byte per code point: its offset from U+0D00.
+	*	UTF-8 spends 3 bytes on each of these code points, so this is a third of the size, and comparing two nouns or checking a suffix compares bytes rather than decoding.
+	*	Short nouns are held inline. The hash is computed once, when the noun is made.
+	**/
+	class MalNoun
+	{
+		public:
+			/**
+			* @desc Constructor. Makes an empty noun.
+			**/
+			MalNoun();
+
+			/**
+			* @desc Constructor. Converts a noun from UTF-8.
+			* @param utf8 The noun. UTF-8 encoded Malayalam text.
+			* @throws std::invalid_argument If the noun isn't valid UTF-8, or has a code point outside the Malayalam block.
+			**/
+			explicit MalNoun(std::string_view utf8);
+
+			/**
+			* @desc Converts a noun from UTF-8, if it can be.
+			* @param utf8 The noun.
+			* @param out Set to the noun, if it could be converted. Left alone otherwise.
+			* @return True if the noun is valid UTF-8 and only has code points from the Malayalam block.
+			**/
+			static bool encode(std::string_view utf8, MalNoun& out);
+
+			/**
+			* @desc Fetches the # of code points in the noun.
+			* @return The # of code points.
+			**/
+			std::size_t size() const;
+
+			/**
+			* @desc Checks whether or not the noun is empty.
+			* @return True if it has no code points.
+			**/
+			bool empty() const;
+
+			/**
+			* @desc Fetches one of the noun's code points.
+			* @param i The code point's index. Must be less than size().
+			* @return The code point.
+			**/
+			char32_t operator[](std::size_t i) const;
+
+			/**
+			* @desc Fetches the noun's compact form.
+			* @return One byte per code point, each the code point's offset from U+0D00. Valid as long as the noun is, and isn't changed.
+			**/
+			std::string_view offsets() const;
+
+			/**
+			* @desc Fetches the noun's hash, which was computed when it was made.
+			* @return The hash of offsets().
+			**/
+			std::size_t hash() const;
+
+			/**
+			* @desc Checks whether or not the noun ends in a suffix.
+			* @param suffix The suffix.
+			* @return True if the noun's last code points are the suffix's.
+			**/
+			bool endsWith(const MalNoun& suffix) const;
+
+			/**
+			* @desc Converts the noun to UTF-8.
+			* @return The noun's UTF-8.
+			**/
+			std::string toUtf8() const;
+
+			/**
+			* @desc Converts the noun to UTF-8, appending it to a string.
+			* @param out The string.
+			**/
+			void appendUtf8(std::string& out) const;
+
+			/**
+			* @desc Compares two nouns.
+			* @param other The other noun.
+			* @return True if they have the same code points.
+			**/
+			bool operator==(const MalNoun& other) const;
+
+			/**
+			* @desc Compares two nouns.
+			* @param other The other noun.
+			* @return True if their code points differ.
+			**/
+			bool operator!=(const MalNoun& other) const;
+
+			/**
+			* @desc Orders two nouns by code point, which is also the order of their UTF-8.
+			* @param other The other noun.
+			* @return True if this noun comes first.
+			**/
+			bool operator<(const MalNoun& other) const;
+
+		private:
+			/**
+			* @desc Fetches the noun's bytes, wherever they're held.
+			* @return The bytes.
+			**/
+			const char* data() const;
+
+			std::size_t len; // # of code points
+			std::size_t h; // Hash of the offsets
+			char small[MALNOUNINLINE]; // The offsets, if there are no more than MALNOUNINLINE of them
+			std::string large; // The offsets otherwise. Empty for a short noun.
+	};
+};
+
+namespace std
+{
+	/**
+	* @desc Lets a MalNoun key a std::unordered_map, using the hash that it already has.
+	**/
+	template<> struct hash<mpp::MalNoun>
+	{
+		std::size_t operator()(const mpp::MalNoun& n) const
+		{
+			return n.hash();
+		}
+	};
+};
+
+#endif // MPP_MALNOUN_HPP
@@ -6,7 +6,6 @@
 #include <vector> // std::vector
 #include <forward_list> // std::forward_list
 #include <array> // std::array
-#include <map> // std::map
 
 /* Boost */
 #include <boost/asio/buffer.hpp> // boost::asio::const_buffer
@@ -63,17 +62,27 @@ namespace mpp
 			**/
 			void setStatus(Status s);
 
+			/**
+			* @desc Turns this into one of the replies whose bytes never change: the answers to ISSING, FOF's "no such form" answers, and every error.
+			*	Those replies are formatted once per process, and toBuffers() returns the prebuilt bytes instead of formatting headers.
+			*	The reply's headers are part of the prebuilt bytes, so it has none of its own. Adding a header, setting content or changing the status makes it an ordinary reply again.
+			* @param s The status. If it doesn't have a fixed reply, this is the same as setStatus(s).
+			**/
+			void setFixed(Status s);
+
 			/**
 			* @desc Converts the Reply into a vector of buffers that Boost.Asio can send over the network.
 			*	The buffers don't own the underlying memory blocks.
 			*	Therefore, the Reply object must remain valid and
 			*	unchanged until the write operation has completed.
+			*	A fixed reply is a single buffer that points at the shared prebuilt bytes, which live until the program exits.
+			* @return The buffers. They're held by the Reply, and are replaced by the next call.
 			**/
-			std::vector<boost::asio::const_buffer> toBuffers();
+			const std::vector<boost::asio::const_buffer>& toBuffers();
 
 			/**
 			* @name Default constructor.
-			* @desc Constructs an invalid reply and sets up the status text map.
+			* @desc Constructs an invalid reply.
 			**/
 			Reply();
 
@@ -94,6 +103,19 @@ namespace mpp
 			**/
 			void setContent(std::string c);
 
+			/**
+			* @desc Fetches the reply's content.
+			* @return The content.
+			**/
+			std::string getContent() const;
+
+			/**
+			* @desc Fetches the value of the reply's Content-Length header.
+			* @throws mpp::exceptions::BadHeaderValue if the header's value isn't an std::string::size_type.
+			* @return The # of bytes of content, or 0 if there's no Content-Length header.
+			**/
+			std::string::size_type getContentLength() const;
+
 			/**
 			* @desc Uses in-place construction to add a Header to our list.
 			* @param name The header's name.
@@ -148,12 +170,12 @@ namespace mpp
 
 			Status stat; // This reply's status
 			std::forward_list<mpp::Header> headers; // List of headers to send with the reply
-			std::map<Status, std::string> statText; // Text for each status
 			std::string content; // The reply's content
 			const std::array<char, 2> crlf; // CR/LF sequence to be used in the reply
 			const std::array<char, 2> nameValSep; // Separates a header name from its value
 			std::forward_list<std::string> repBufConts; // Holds the contents of the buffers so that they won't contain garbage deleted strings
 			std::vector<boost::asio::const_buffer> repBufs; // Holds this reply as a vector of buffers. Made it a member so that it won't get deleted before the Reply goes out of scope.
+			const std::string* wire; // The prebuilt bytes of a fixed reply, or null if the reply has to be formatted
 
 			/**
 			* Friend declaration to allow operator<< to access private members.
@@ -0,0 +1,234 @@
+#ifndef MPP_REPLYCACHE_HPP
+#define MPP_REPLYCACHE_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t, std::uint64_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <list> // std::list
+#include <vector> // std::vector
+#include <unordered_map> // std::unordered_map
+#include <functional> // std::hash
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+
+/* Our headers */
+#include "mpp/Request.hpp" // mpp::Request::Command
+#include "mpp/MalNoun.hpp" // A noun, one byte per code point
+
+// The # of rows in the frequency sketch
+#define NSKETCHROWS 4
+
+// Set in the verb byte of a key whose noun is kept as UTF-8 because it isn't all Malayalam, so that it can't collide with a compact key
+#define RAWKEYFLAG 0x80
+
+namespace mpp
+{
+	/**
+	* @desc A bounded cache of ready-to-send replies, keyed by (verb, noun), with W-TinyLFU eviction.
+	*	New entries go into a small LRU window. When the window overflows, its oldest entry only displaces the main area's next victim if a count-min sketch says that it's been asked for more often, so a scan of rare nouns can't flush the hot set.
+	*	The main area is a segmented LRU: entries start on probation, and move to the protected segment when they're hit again.
+	*	Nouns are keyed in their compact form, one byte per code point, so a key is a third of the size of the noun's UTF-8.
+	*	There's no locking. Each io_context's thread gets a cache of its own, so no two threads ever share one.
+	**/
+	class ReplyCache : private boost::noncopyable
+	{
+		public:
+			/**
+			* @desc What the cache has done since it was created.
+			**/
+			struct Stats
+			{
+				std::uint64_t hits = 0; // Lookups that found a reply
+				std::uint64_t misses = 0; // Lookups that didn't
+				std::uint64_t evictions = 0; // Entries dropped to make room, including rejected ones
+				std::uint64_t rejections = 0; // New entries that weren't admitted to the main area, because its victim was more popular
+			};
+
+			/**
+			* @desc Constructor.
+			* @param capacity The most replies to hold. Must be positive.
+			**/
+			explicit ReplyCache(std::size_t capacity);
+
+			/**
+			* @desc Looks up the reply to a request, and counts the request towards its noun's popularity.
+			* @param verb The request's verb.
+			* @param noun The request's noun.
+			* @return The reply's bytes, or null if it isn't cached. Valid until the next call to insert() or clear().
+			**/
+			const std::string* find(Request::Command verb, std::string_view noun);
+
+			/**
+			* @desc Looks up the reply to a request whose noun is already in compact form, and counts the request towards its noun's popularity.
+			* @param verb The request's verb.
+			* @param noun The request's noun.
+			* @return The reply's bytes, or null if it isn't cached. Valid until the next call to insert() or clear().
+			**/
+			const std::string* find(Request::Command verb, const MalNoun& noun);
+
+			/**
+			* @desc Stores the reply to a request that find() didn't have. This may evict another reply, or not keep this one.
+			* @param verb The request's verb.
+			* @param noun The request's noun.
+			* @param reply The whole reply, exactly as it's sent.
+			* @param asOf What getGeneration() returned before the reply's facts were looked up. If the cache has been cleared or invalidated since, the reply may be stale, so it isn't stored.
+			**/
+			void insert(Request::Command verb, std::string_view noun, std::string_view reply, std::uint64_t asOf);
+
+			/**
+			* @desc Stores the reply to a request whose noun is already in compact form. This may evict another reply, or not keep this one.
+			* @param verb The request's verb.
+			* @param noun The request's noun.
+			* @param reply The whole reply, exactly as it's sent.
+			* @param asOf What getGeneration() returned before the reply's facts were looked up. If the cache has been cleared or invalidated since, the reply may be stale, so it isn't stored.
+			**/
+			void insert(Request::Command verb, const MalNoun& noun, std::string_view reply, std::uint64_t asOf);
+
+			/**
+			* @desc Drops every reply, e.g. because the data that they came from has changed, and starts a new generation. The popularity counts and stats are kept.
+			**/
+			void clear();
+
+			/**
+			* @desc Drops every reply about a noun, whatever the verb, because the facts that they came from have changed, and starts a new generation. The noun's popularity count is kept.
+			* @param noun The noun.
+			* @return The # of replies dropped.
+			**/
+			std::size_t invalidate(std::string_view noun);
+
+			/**
+			* @desc Fetches the cache's generation, which changes whenever it's cleared or invalidated. Read it before looking a reply's facts up, and pass it to insert().
+			* @return The generation.
+			**/
+			std::uint64_t getGeneration() const;
+
+			/**
+			* @desc Fetches the # of replies in the cache.
+			* @return The # of replies.
+			**/
+			std::size_t size() const;
+
+			/**
+			* @desc Fetches the cache's counters.
+			* @return The counters.
+			**/
+			const Stats& getStats() const;
+
+		private:
+			/* Types */
+			enum Segment : std::uint8_t // Where an entry lives
+			{
+				Window, // Recently added, not yet admitted
+				Probation, // Admitted, but not hit since
+				Protected // Hit at least once since being admitted
+			};
+
+			/**
+			* @desc A cached reply.
+			**/
+			struct Entry
+			{
+				std::string key; // Verb byte followed by the noun's compact form. The index's keys point into this.
+				std::string reply; // The reply's bytes
+				Segment seg; // The list that holds this entry
+			};
+
+			typedef std::list<Entry> EntryList; // Most recently used first
+
+			/**
+			* @desc Builds the key for a request in keyBuf.
+			* @param verb The request's verb.
+			* @param noun The request's noun, in UTF-8. It's converted to compact form if it can be, and kept as it is, with RAWKEYFLAG set in the verb byte, if it can't.
+			* @return A view of keyBuf.
+			**/
+			std::string_view makeKey(Request::Command verb, std::string_view noun);
+
+			/**
+			* @desc Builds the key for a request in keyBuf.
+			* @param verb The request's verb.
+			* @param noun The request's noun.
+			* @return A view of keyBuf.
+			**/
+			std::string_view makeKey(Request::Command verb, const MalNoun& noun);
+
+			/**
+			* @desc Looks up a key's reply, and counts the request towards its popularity.
+			* @param key The key.
+			* @return The reply's bytes, or null if it isn't cached.
+			**/
+			const std::string* findKey(std::string_view key);
+
+			/**
+			* @desc Stores the reply for a key.
+			* @param key The key.
+			* @param reply The whole reply, exactly as it's sent.
+			**/
+			void insertKey(std::string_view key, std::string_view reply);
+
+			/**
+			* @desc Finds a key's counter in one row of the sketch.
+			* @param h The key's hash.
+			* @param row The row.
+			* @return The counter's index in sketch.
+			**/
+			std::size_t slot(std::uint64_t h, std::size_t row) const;
+
+			/**
+			* @desc Counts one request for a key. Every counter is halved once enough requests have been counted, so that old popularity fades.
+			* @param h The key's hash.
+			**/
+			void recordAccess(std::uint64_t h);
+
+			/**
+			* @desc Estimates how often a key has been asked for recently.
+			* @param h The key's hash.
+			* @return The estimate, from 0 to 15.
+			**/
+			unsigned frequency(std::uint64_t h) const;
+
+			/**
+			* @desc Moves the window's oldest entry into the main area if it's wanted there, and makes room by evicting.
+			**/
+			void evictFromWindow();
+
+			/**
+			* @desc Removes an entry from the cache.
+			* @param list The list that holds it.
+			* @param it The entry.
+			**/
+			void erase(EntryList& list, EntryList::iterator it);
+
+			/**
+			* @desc Fetches the list for a segment.
+			* @param seg The segment.
+			* @return The list.
+			**/
+			EntryList& listOf(Segment seg);
+
+			/* Properties */
+			const std::size_t capacity; // Most entries in total
+			const std::size_t windowCap; // Most entries in the window
+			const std::size_t mainCap; // Most entries in probation and protected together
+			const std::size_t protectedCap; // Most entries in protected
+			EntryList window;
+			EntryList probation;
+			EntryList protectedList;
+			std::unordered_map<std::string_view, EntryList::iterator> index; // Finds an entry by key
+			std::vector<std::uint8_t> sketch; // NSKETCHROWS rows of 4-bit counters, one per byte
+			std::size_t sketchWidth; // # of counters per row. A power of 2.
+			std::size_t nSamples; // # of requests counted since the counters were last halved
+			const std::size_t sampleSize; // # of requests to count before halving
+			std::string keyBuf; // Reused by makeKey(), so that lookups don't allocate
+			MalNoun nounBuf; // Reused by makeKey() to convert UTF-8 nouns
+			std::hash<std::string_view> hasher;
+			Stats stats;
+			std::uint64_t generation; // # of times the cache has been cleared or invalidated
+	};
+};
+
+#endif // MPP_REPLYCACHE_HPP
@@ -1,28 +1,32 @@
 #ifndef MPP_REQHANDLER_HPP
 #define MPP_REQHANDLER_HPP
 
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+
 /* Standard C++ */
 #include <string> // std::string
 #include <vector> // std::vector
+#include <memory> // std::shared_ptr
+#include <functional> // std::function
+#include <exception> // std::exception_ptr
 
 /* Boost */
 #include <boost/noncopyable.hpp> // boost::noncopyable
-#include <boost/regex.hpp>
-#include <boost/regex/icu.hpp> // boost::u32regex
 #include <boost/logic/tribool.hpp> // boost::logic::tribool
 
-/* MariaDB++ */
-#include <mariadb++/account.hpp> // mariadb::account_ref
-#include <mariadb++/connection.hpp> // mariadb::connection_ref
-#include <mariadb++/statement.hpp> // mariadb::statement_ref
-
 /* Our headers */
 #include "bosmacros/array.hpp" // ARRAY_CLASS macro
 #include "mpp/Request.hpp" // Represents a single request
 #include "mpp/Reply.hpp" // Represents a single reply
-#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information (username, host, etc.)
-
-// The # of regexes used to guess at a noun's declension
+#include "mpp/data/LiveLexicon.hpp" // In-memory noun tables that can be replaced while running
+#include "mpp/data/DBPool.hpp" // Pool of DB sessions shared by every handler
+#include "mpp/data/DBSession.hpp" // A DB connection with prepared statements
+#include "mpp/data/AsyncDBSession.hpp" // A DB connection that doesn't block its thread
+#include "mpp/data/NounFacts.hpp" // Everything known about a noun
+#include "mpp/SuffixClassifier.hpp" // Classifies nouns by their endings
+
+// The # of suffixes used to guess at a noun's declension
 #define NDECLREGS 5
 
 namespace mpp
@@ -35,18 +39,46 @@ namespace mpp
 		public:
 			/**
 			* @desc Handles a request and produces a reply. 
+			*	Unless the lexicon is in use, a single DB session is checked out of the pool for the whole request, and returned when this method exits.
 			* @param req The request object to get request data from.
 			* @param rep The respnse object to set parameters on to generate a response.
 			**/
 			void handleReq(const Request& req, Reply& rep);
 
+			/**
+			* @desc Handles a request without blocking, and produces a reply.
+			*	If the lexicon is in use, the reply is produced and handler is called before this returns. Otherwise, the noun is looked up by the async DB session, and handler is called from its io_context once the reply is ready.
+			* @param req The request object to get request data from. Must stay valid until handler is called.
+			* @param rep The respnse object to set parameters on to generate a response. Must stay valid until handler is called.
+			* @param handler Called with nothing once the reply is ready, or with a DBError if the noun couldn't be looked up.
+			**/
+			void asyncHandleReq(const Request& req, Reply& rep, std::function<void(std::exception_ptr)> handler);
+
 			/**
 			* @desc Constructor. Performs initial setup, specifically:
 			*	1) Loads DB info from a config file.
-			* 	2) Opens a connection to the DB.
+			* 	2) Opens a connection to the DB, in a pool of its own.
 			* @param cfPath The path to the DB config file.
+			* @param lex The in-memory noun tables, which may be replaced while requests are being handled. If given, the DB is never queried; if null, every lookup goes to the DB.
+			* @param reader The lexicon reader slot of the thread that will call handleReq.
 			**/
-			explicit ReqHandler(std::string cfPath);
+			explicit ReqHandler(std::string cfPath, std::shared_ptr<data::LiveLexicon> lex = nullptr, std::size_t reader = 0);
+
+			/**
+			* @desc Constructor. Uses sessions from a pool shared with other handlers.
+			* @param pool The pool to check DB sessions out of. May be null if a lexicon is given.
+			* @param lex The in-memory noun tables, which may be replaced while requests are being handled. If given, the DB is never queried; if null, every lookup goes to the DB.
+			* @param reader The lexicon reader slot of the thread that will call handleReq.
+			**/
+			explicit ReqHandler(std::shared_ptr<data::DBPool> pool, std::shared_ptr<data::LiveLexicon> lex = nullptr, std::size_t reader = 0);
+
+			/**
+			* @desc Constructor. Looks nouns up without blocking, through asyncHandleReq. One handler can serve every connection on its thread, with several requests waiting for the DB at once.
+			* @param db The session to look nouns up on. It must belong to the io_context whose thread calls asyncHandleReq. May be null if a lexicon is given.
+			* @param lex The in-memory noun tables, which may be replaced while requests are being handled. If given, the DB is never queried; if null, every lookup goes to db.
+			* @param reader The lexicon reader slot of the thread that will call asyncHandleReq.
+			**/
+			explicit ReqHandler(std::shared_ptr<data::AsyncDBSession> db, std::shared_ptr<data::LiveLexicon> lex = nullptr, std::size_t reader = 0);
 
 		private:
 			/* Types */
@@ -59,46 +91,49 @@ namespace mpp
 			};
 
 			/**
-			* @desc Acquires the resources needed to communicate with the DB.
+			* @desc Produces the reply to a request, once its noun has been looked up.
+			* @param req The request object to get request data from.
+			* @param rep The respnse object to set parameters on to generate a response.
+			* @param facts What the DB knows about the request's noun.
 			**/
-			void openDBConn();
+			void respond(const Request& req, Reply& rep, const data::NounFacts& facts);
 
 			/**
 			* @desc Determines whether or not the given noun is singular.
-			*	It first attempts to find the noun in the DB. If it does, it knows that the noun is singular.
-			*	If it doesn't find the noun in the DB, it uses regexes to guess at whether or not the noun is singular.
-			* @param noun The Malayalam noun to find the plural of. It must be a UTF-8 encoded string, with codepoints in the range 0xd00 to 0xd7f.
+			*	If the noun is in the DB, it knows that the noun is singular.
+			*	If it isn't, it uses the noun's ending to guess at whether or not the noun is singular.
+			* @param facts What the DB knows about the noun to check.
 			* @return True if the noun is singular, false otherwise.
 			**/
-			bool isSingular(std::string noun);
+			bool isSingular(const data::NounFacts& facts);
 
 			/**
-			* @desc Determines whether or not the given noun exists in the DB. It queries the DB for the noun and checks how many results there are.
-			* @param noun The Malayalam noun to find the plural of. It must be a UTF-8 encoded string, with codepoints in the range 0xd00 to 0xd7f.
-			* @return True if the noun is the DB, false otherwise.
+			* @desc Fetches everything known about a noun: from the lexicon if there is one, otherwise from the DB in a single query.
+			* @param noun The Malayalam noun to look up. It must be a UTF-8 encoded string, with codepoints in the range 0xd00 to 0xd7f.
+			* @return The noun's facts, which are passed to each predicate.
 			**/
-			bool inDB(std::string noun);
+			data::NounFacts getFacts(const std::string& noun);
 
 			/**
-			* @desc Uses regexes to guess at whether or not the noun is singular. One regex is used for each class of singular noun.
-			* @param noun The Malayalam noun to find the plural of. It must be a UTF-8 encoded string, with codepoints in the range 0xd00 to 0xd7f.
-			* @return True if any of the regexes for singular Malayalam nouns matches the given noun. False if none match.
+			* @desc Uses the noun's ending to guess at whether or not the noun is singular. One suffix is checked for each class of singular noun.
+			* @param noun The Malayalam noun to find the plural of. It must be a UTF-8 encoded string, with codepoints in the range 0xd00 to 0xd7f, and must be the noun whose ending is in nounShape.
+			* @return True if any of the suffixes for singular Malayalam nouns matches the given noun. False if none match.
 			**/
 			bool regGuess(std::string noun);
 
 			/**
-			* @desc Searches the DB to see whether or not this noun is pluralisable.
-			* @param noun The Malayalam noun to find the plural of. It must be a UTF-8 encoded string, with codepoints in the range 0xd00 to 0xd7f.
+			* @desc Uses the noun's facts to see whether or not this noun is pluralisable.
+			* @param facts What the DB knows about the noun to find the plural of.
 			* @return True if the noun is in the DB and has a TRUE 'pluralisable' attribute, false if the noun has no plural form, indeterminate otherwise.
 			**/
-			boost::logic::tribool hasPlural(std::string noun);
+			boost::logic::tribool hasPlural(const data::NounFacts& facts);
 
 			/**
 			* @desc Given a SINGULAR noun, finds its plural form. A vector is returned because a noun may have multiple plural forms.
-			* @param noun The SINGULAR noun to find the plural of. The noun ISN'T CHECKED for singularity.
+			* @param facts What the DB knows about the SINGULAR noun to find the plural of. The noun ISN'T CHECKED for singularity.
 			* @return The plural form of the noun or all plural forms of the noun.
 			**/
-			std::vector<std::string> findPlural(std::string noun);
+			std::vector<std::string> findPlural(const data::NounFacts& facts);
 
 			/**
 			* @desc Given a PLURAL noun, determines whether or not it has a corresponding SINGULAR form.
@@ -108,67 +143,62 @@ namespace mpp
 			bool hasSingular(std::string noun);
 
 			/**
-			* @desc Uses the DB to determine whether or not the given noun is animate.
-			* @param noun The noun to check. Malayalam text, encoded in UTF-8.
+			* @desc Uses the noun's facts to determine whether or not the given noun is animate.
+			* @param facts What the DB knows about the noun to check.
 			* @return True if the noun is animate, false if it isn't, boost::indeterminate if it isn't in the DB.
 			**/
-			boost::logic::tribool isAnimate(std::string noun);
+			boost::logic::tribool isAnimate(const data::NounFacts& facts);
 
 			/**
-			* @desc Uses the DB to determine whether or not the given noun refers to a human.
-			* @param noun The noun to check. Malayalam text, encoded in UTF-8.
+			* @desc Uses the noun's facts to determine whether or not the given noun refers to a human.
+			* @param facts What the DB knows about the noun to check.
 			* @return True if the noun refers to a human, false if it doesn't, boost::indeterminate if it isn't in the DB.
 			**/
-			boost::logic::tribool isHuman(std::string noun);
+			boost::logic::tribool isHuman(const data::NounFacts& facts);
 
 			/**
 			* @desc Finds the gender of the given noun.
-			* @param noun The noun to fetch the gender of. Malayalam text, encoded in UTF-8.
+			* @param facts What the DB knows about the noun to fetch the gender of.
 			* @return An enum value representing the noun's gender (masculine, feminine, or neuter).
 			**/
-			Gender getGender(std::string noun);
+			Gender getGender(const data::NounFacts& facts);
 
 			/**
 			* @desc Determines whether or not a noun ends in a vowel.
-			* @param noun The noun to check. Must be UTF-8 encoded Malayalam text.
+			* @param noun The noun to check. Must be UTF-8 encoded Malayalam text, and the noun whose ending is in nounShape.
 			* @return True if the noun is a vowel stem, false otherwise.
 			**/
 			bool isVowelStem(std::string noun);
 
 			/**
 			* @desc Determines whether or not a noun has an exceptional plural.
-			* @param noun The noun to check. Must be UTF-8 encoded Malayalam text.
+			* @param facts What the DB knows about the noun to check.
 			* @return True if the noun has an exceptional plural, false if it doesn't, and boost::indeterminate if it isn't in the DB.
 			**/
-			boost::logic::tribool isException(std::string noun);
+			boost::logic::tribool isException(const data::NounFacts& facts);
 
 			/**
 			* @desc Finds the singular form of a noun, given the plural form.
-			* @param noun The noun to find the singular form of. Must be UTF-8 encoded Malayalam text.
+			* @param facts What the DB knows about the noun to find the singular form of.
 			* @return 1 or more UTF-8 encoded Malayalam strings containing the noun's singular form(s).
 			**/
-			std::vector<std::string> findSingular(std::string noun);
+			std::vector<std::string> findSingular(const data::NounFacts& facts);
 
 			/**
 			* @desc Determines whether or not a string contains the plural form of an exceptional noun.
-			* @param noun A UTF-8 encoded Malayalam noun which may or may not be the plural form of an exceptional noun.
-			* @return True if the noun has an exceptional plural, false if it doesn't, and boost::indeterminate if it isn't in the DB.
+			* @param facts What the DB knows about a noun which may or may not be the plural form of an exceptional noun.
+			* @return True if the noun is the plural of an exceptional noun, false otherwise.
 			**/
-			boost::logic::tribool isExceptionalPlural(std::string noun);
+			boost::logic::tribool isExceptionalPlural(const data::NounFacts& facts);
 
 			/* Properties */
-			data::DBInfo dbInfo; // Holds information req'd to connect to the DB
-			mariadb::account_ref dbAcc; // Pointer to DB account object
-			mariadb::connection_ref dbConn; // Pointer to DB connection object
-			mariadb::statement_ref existStmt; // Prepared statement used to check whether a noun is in the DB or not
-			mariadb::statement_ref hasPluralStmt; // Prepared statement used to check whether or not a noun is pluralisable
-			mariadb::statement_ref isAnimateStmt; // Prepared statement used to check whether or not a noun is animate
-			mariadb::statement_ref isHumanStmt; // Used to check whether or not a noun refers to a human
-			mariadb::statement_ref getGenderStmt; // Used to find a noun's gender
-			mariadb::statement_ref exceptionStmt; // Used to determine whether a noun is an exception that has a special plural and what the exceptional plural is
-			mariadb::statement_ref exSingStmt; // Used to determine the singular form of an exceptional noun's plural
-			ARRAY_CLASS<boost::u32regex, NDECLREGS> declRegs; // Array of regular expressions for use in determining the noun's declension class
-			boost::u32regex endsInKaar; // Regex used to check if a noun is a -kaaran/-kaari noun
+			std::shared_ptr<data::DBPool> dbPool; // Pool of pre-connected sessions, shared by every handler. Null if the lexicon is in use.
+			data::DBSession* dbSess; // The session checked out for the request being handled. Only valid during handleReq.
+			std::shared_ptr<data::AsyncDBSession> asyncDB; // Used by asyncHandleReq. Null if the handler was given a pool, or if the lexicon is in use.
+			const SuffixClassifier& classifier; // Suffix trie shared by every handler
+			SuffixClassifier::Result nounShape; // The ending of the noun being answered. Set by respond() before any helper uses it.
+			std::shared_ptr<data::LiveLexicon> lexicon; // The noun tables, shared by every handler. Null if the DB should be queried instead.
+			std::size_t lexReader; // This handler's thread's slot in lexicon
 	};
 };
 
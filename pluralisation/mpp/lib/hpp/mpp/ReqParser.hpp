@@ -1,10 +1,12 @@
 #ifndef MPP_REQPARSER_HPP
 #define MPP_REQPARSER_HPP
 
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+
 /* STL */
-#include <sstream> // std::stringstream
 #include <string> // std::string
-#include <memory> // std::unique_ptr
+#include <string_view> // std::string_view
 
 #ifdef DEBUG
 #include <map> // std::map
@@ -16,11 +18,18 @@
 #include <boost/logic/tribool.hpp> // boost::tribool, boost::indeterminate
 #include <boost/logic/tribool_io.hpp> // operator<< for boost::logic::tribool
 
+/* My Unicode utilities library */
+#include "vuu/StreamValidator.hpp" // vuu::StreamValidator, to check a noun as its bytes arrive
+
 /* Our headers */
 #include "bosmacros/array.hpp" // ARRAY_CLASS macro
 #include "mpp/Request.hpp" // Represents a request
+#include "mpp/MalNoun.hpp" // A noun, one byte per code point
 #include "mpp/Reply.hpp" // Reply::FailureCode (to indicate why the parser failed)
 
+// The most bytes that the parser will hold onto for a request that spans reads
+#define MAXCARRYBYTES 65536
+
 namespace mpp
 {
 	/*
@@ -80,6 +89,17 @@ namespace mpp
 				return boost::make_tuple(res, begin);
 			}
 	
+			/**
+			* @desc Parses a request straight out of a read buffer, without going through consume().
+			*	Header names, header values and the noun are stored in req as slices of data, so a request that arrived in one read is never copied.
+			*	If data ends part-way through a request, its bytes are kept by the parser and the next call continues from them. Only then is anything copied.
+			* @param req The Request object to set values on.
+			* @param data The bytes that were just read.
+			* @return A pair of a tribool (true = full request parsed, false = invalid request, indeterminate = incomplete request); and the # of bytes of data that were used.
+			*	The slices in req are valid until data's buffer is reused, or until the next call to this method or to reset(), whichever comes first.
+			**/
+			boost::tuple<boost::tribool, std::size_t> parse(Request& req, std::string_view data);
+
 			/**
 			* @desc Fetches the reason why the parser couldn't finish parsing a request. Needed by Reply::stockReply in Server.
 			* @return A reason code that indicates why the parser couldn't finish.
@@ -94,6 +114,32 @@ namespace mpp
 			**/
 			boost::tribool consume(Request& req, char input);
 
+			/**
+			* @desc Scans one request from the start of a block of bytes. Used by the bulk parse().
+			* @param req The request object to set parameters on.
+			* @param in The bytes to scan. Must start with the first byte of the request.
+			* @param used Set to the # of bytes of in that were looked at.
+			* @return True if a valid request was parsed, false if it's invalid, boost::indeterminate if in ends before the request does.
+			**/
+			boost::tribool scan(Request& req, std::string_view in, std::size_t& used);
+
+			/**
+			* @desc Checks the part of a noun that has arrived so far, so that a bad noun is turned away without waiting for the rest of it.
+			*	Only the bytes that an earlier call for the same noun didn't see are checked.
+			* @param soFar The noun's bytes so far. Must start with the bytes that earlier calls for the same noun were given.
+			* @return Reply::invalid if the noun is fine so far, or the status to fail with otherwise.
+			**/
+			Reply::Status checkNounPart(std::string_view soFar);
+
+			/**
+			* @desc Checks that a noun is valid UTF-8 and only contains Malayalam code points.
+			*	Only the bytes that earlier calls to checkNounPart() didn't see are checked.
+			* @param n The noun's bytes.
+			* @param compact Set to the noun, one byte per code point, if it's fine.
+			* @return Reply::invalid if the noun is fine, or the status to fail with otherwise.
+			**/
+			Reply::Status checkNoun(std::string_view n, MalNoun& compact);
+
 			enum State
 			{
 				/* Reading "MPP" */
@@ -136,23 +182,20 @@ namespace mpp
 				invalid = -1 // Used to indicate an invalid state in prevStat upon default construction
 			};
 
-			/**
-			* @desc Determines whether or not the given string represents a valid decimal integer.
-			* @param toCheck The string to check.
-			* @return True if the string represents a valid decimal integer, false otherwise.
-			**/
-			bool isValidDecimalInt(std::string toCheck);
-	
 			State curStat; // Current state
 			State prevStat; // Previous state
 			mpp::Reply::Status status;
 			const ARRAY_CLASS<short, 3> version; // Current parser/server version
-			ARRAY_CLASS<std::unique_ptr<std::stringstream>, 3> verSS; // Used to store textual versions of version #s for each part of the version string (VER_MAJOR.VER_MINOR.VER_PATCH) until we need to convert them to numbers for comparison
+			ARRAY_CLASS<int, 3> verNums; // The version #s (VER_MAJOR.VER_MINOR.VER_PATCH) read so far, accumulated digit by digit until they're compared
 			std::map<std::string, State> verbInfo; // Maps a verb to its state. The keys are iterated to check recognised verbs. The values are only used to determine which state to jump to next after parsing the first character of the verb.
-			std::unique_ptr<std::stringstream> pSSHeaderName; // Use a pointer so that we can easily reset the stringstream
-			std::unique_ptr<std::stringstream> pSSHeaderVal; // Use a pointer so that we can easily reset the stringstream
+			std::string headerName; // Name of the header being read. Cleared rather than reallocated between headers.
+			std::string headerVal; // Value of the header being read
 			int mNBytes; // # of bytes in Malayalam noun.
-			std::unique_ptr<std::stringstream> pNounSS; // Pointer to noun stringstream
+			std::string nounBytes; // The noun's bytes read so far
+			vuu::StreamValidator nounCheck; // Checks the noun's bytes as they arrive, across reads
+			std::size_t nNounChecked; // # of the noun's bytes that nounCheck has seen
+			std::string carry; // The bulk parser's copy of a request that spans reads
+			bool carrying; // Whether or not carry holds the start of an unfinished request
 	
 			#ifdef DEBUG
 			std::map<State, std::string> stateNames; // Used to name states for debugging
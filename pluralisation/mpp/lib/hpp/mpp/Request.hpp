@@ -4,6 +4,9 @@
 /* STL */
 #include <forward_list> // std::forward_list
 #include <string> // std::string
+#include <string_view> // std::string_view
+#include <utility> // std::pair
+#include <cstddef> // std::size_t
 #include <vector> // std::vector
 #include <map> // std::map
 #include <array> // std::array
@@ -12,6 +15,7 @@
 /* Our headers */
 #include "bosmacros/any.hpp" // ANY_CLASS macro
 #include "mpp/Header.hpp" // Header class
+#include "mpp/MalNoun.hpp" // MalNoun class
 
 /* Boost */
 #include <boost/asio/buffer.hpp> // boost::asio::const_buffer
@@ -20,6 +24,9 @@
 #define GETCOM_FUNC getCommand
 #define SETCOM_FUNC setCommand
 
+// The # of headers that a Request can hold as slices before it starts copying them
+#define NHEADERSLICES 8
+
 namespace mpp
 {
 	class Request
@@ -56,6 +63,13 @@ namespace mpp
 			**/
 			void addHeader(std::string name, ANY_CLASS value);
 
+			/**
+			* @desc Adds a header whose name and value are slices of the buffer that it was parsed from. Nothing is copied unless the request already holds NHEADERSLICES slices.
+			* @param name The header's name.
+			* @param value The header's value.
+			**/
+			void addHeaderSlice(std::string_view name, std::string_view value);
+
 			/**
 			* @desc Attempts to find a Header by the given name.
 			* @throws mpp::exceptions::UnknownHeader if a Header with the given name isn't found.
@@ -69,12 +83,36 @@ namespace mpp
 			**/
 			void setNoun(std::string noun);
 
+			/**
+			* @desc Stores the noun as a slice of the buffer that it was parsed from, without copying it. The buffer must outlive the request's handling.
+			* @param noun The slice that holds the noun.
+			**/
+			void setNounSlice(std::string_view noun);
+
 			/**
 			* @desc Fetches the noun associated with this request.
 			* @return This request's noun.
 			**/
 			std::string getNoun() const;
 
+			/**
+			* @desc Fetches the noun associated with this request without copying it.
+			* @return A view of this request's noun, which is only valid as long as the noun (or the buffer that it was sliced from) is.
+			**/
+			std::string_view getNounView() const;
+
+			/**
+			* @desc Stores the noun's compact form, which the parser makes while it checks the noun.
+			* @param noun The noun, one byte per code point.
+			**/
+			void setCompactNoun(const MalNoun& noun);
+
+			/**
+			* @desc Fetches the noun's compact form.
+			* @return The noun, one byte per code point. Empty if it wasn't set since the noun was.
+			**/
+			const MalNoun& getCompactNoun() const;
+
 			/**
 			* @desc Converts the Request object to a sequence of constant buffers, suitable for network transport.
 			* @return A vector of constant buffers, containing text that represents this Request object.
@@ -88,10 +126,15 @@ namespace mpp
 			typename std::string::size_type size() const;
 
 			/**
-			* @desc Clears our list of headers.
+			* @desc Clears our list of headers, including the sliced ones.
 			**/
 			void clearHeaders();
 
+			/**
+			* @desc Clears the command, headers and noun, so that the object can hold the next request on a connection. The noun's storage is kept.
+			**/
+			void clear();
+
 		private:
 			/*** Methods ***/
 
@@ -113,6 +156,10 @@ namespace mpp
 			Command c; // The command which this request asks the server to perform
 			std::forward_list<mpp::Header> headers; // A list of request headers
 			std::string noun; // The noun given with this request
+			std::string_view nounSlice; // The noun, when it was set with setNounSlice(). Null otherwise.
+			MalNoun compactNoun; // The noun, one byte per code point, when the parser set it. Empty otherwise.
+			std::array<std::pair<std::string_view, std::string_view>, NHEADERSLICES> headerSlices; // (name, value) pairs of headers that were added with addHeaderSlice()
+			std::size_t nHeaderSlices; // # of valid entries in headerSlices
 			std::map<Command, std::string> verbNames; // Maps a verb enum to a string describing it for network transport
 			const std::array<char, 2> crlf; // Used to represent the sequence "\r\n"
 			const std::array<char, 2> nameValSep; // Contains the ':' and space that separate a header name from its value
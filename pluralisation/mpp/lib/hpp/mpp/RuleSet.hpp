@@ -0,0 +1,75 @@
+#ifndef MPP_RULESET_HPP
+#define MPP_RULESET_HPP
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+#include <boost/regex.hpp>
+#include <boost/regex/icu.hpp> // boost::u32regex
+
+/* Our headers */
+#include "bosmacros/array.hpp" // ARRAY_CLASS macro
+
+// The # of regexes used to guess at a noun's declension
+#define NDECLREGS 5
+
+namespace mpp
+{
+	/**
+	* @desc Every regex that ReqHandler used to classify and inflect nouns, compiled once per process.
+	*	The set is immutable once built, so every thread shares the same instance without locking.
+	*	ReqHandler now uses SuffixClassifier instead. These regexes are kept as the reference that suffixTest checks it against.
+	**/
+	class RuleSet : private boost::noncopyable
+	{
+		public:
+			/**
+			* @desc Fetches the process-wide rule set, compiling it on the first call.
+			* @return The rule set.
+			**/
+			static const RuleSet& get();
+
+			/* Declension guessing */
+			const ARRAY_CLASS<boost::u32regex, NDECLREGS> declRegs; // an-, am-, ruh-, duh- and schwa-stems, in that order
+			const boost::u32regex endsInRetroflexL; // Ends in -ൾ
+			const boost::u32regex endsInKaL; // Ends in -കൾ
+			const boost::u32regex doesntEndInChillu; // Ends in anything but a chillu
+			const boost::u32regex doesntEndInSchwa; // Ends in anything but a virama
+
+			/* -kaaran/-kaari nouns */
+			const boost::u32regex endsInKaar; // Ends in -കാരൻ or -കാരി
+			const boost::u32regex endsInKaaran; // Ends in -കാരൻ (masculine)
+			const boost::u32regex endsInKaari; // Ends in -കാരി (feminine)
+
+			/* Plural formation */
+			const boost::u32regex endsInLongA; // Ends in /a:/
+			const boost::u32regex endsInSyllabicR; // Ends in a short syllabic /r/
+			const boost::u32regex endsInA; // Ends in a consonant with no vowel sign, i.e. in the inherent /a/
+			const boost::u32regex endsInShortI; // Ends in /i/
+			const boost::u32regex endsInAlveolarN; // Ends in chillu -n
+			const boost::u32regex isAmStem; // Ends in an anusvara
+			const boost::u32regex endsInSchwa; // Ends in a virama
+			const boost::u32regex cvcuReg; // Contains CVCu
+			const boost::u32regex cLongVReg; // Contains C[long V]
+			const boost::u32regex ranFinder; // -ran, with everything before it captured
+			const boost::u32regex riFinder; // -ri
+			const boost::u32regex amStemFinder; // Captures everything before a final -am
+			const boost::u32regex schwaFinder; // Captures everything before a final schwa
+
+			/* Singular formation */
+			const boost::u32regex endsInMaar; // Ends in -മാർ
+			const boost::u32regex endsInKkaL; // Ends in -ക്കൾ
+			const boost::u32regex endsInKaarPlural; // Ends in -കാർ
+			const boost::u32regex ivarAvar; // ഇവർ or അവർ
+			const boost::u32regex kaLFinder; // Captures everything before -കൾ
+			const boost::u32regex maarFinder; // Captures everything before -മാർ
+			const boost::u32regex kkaLFinder; // Captures everything before -ക്കൾ
+
+		private:
+			/**
+			* @desc Constructor. Compiles every regex. Only called by get().
+			**/
+			RuleSet();
+	};
+};
+
+#endif // MPP_RULESET_HPP
@@ -0,0 +1,171 @@
+#ifndef MPP_SUFFIXCLASSIFIER_HPP
+#define MPP_SUFFIXCLASSIFIER_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+#include <array> // std::array
+#include <utility> // std::pair
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+
+/* Our headers */
+#include "mpp/MalNoun.hpp" // A noun, one byte per code point
+
+namespace mpp
+{
+	/**
+	* @desc Classifies a noun by its ending, without ICU.
+	*	Every suffix rule that ReqHandler used to test with an anchored regex is stored, reversed, in a trie of code points.
+	*	classify() decodes the noun's UTF-8 backwards from the end and walks the trie once, so the cost depends on the length of the longest suffix rather than on the noun.
+	*	The few whole-word shapes (CVCu, C[long V], ivar/avar) are checked from the same code points, since they're never longer than four.
+	*	RuleSet holds the regexes that these rules replace, and the suffixTest program checks that both agree.
+	**/
+	class SuffixClassifier : private boost::noncopyable
+	{
+		public:
+			/* Types */
+			enum Rule : std::uint32_t // A single test on the noun. A Result holds every one that matched.
+			{
+				EndsInAn = 1 << 0, // -ൻ (an-stem)
+				EndsInAm = 1 << 1, // -ം (am-stem)
+				EndsInRuh = 1 << 2, // -റ് (ruh-stem)
+				EndsInDuh = 1 << 3, // -ട് (duh-stem)
+				EndsInVirama = 1 << 4, // -് (schwa-stem)
+				EndsInRetroflexL = 1 << 5, // -ൾ
+				EndsInKaL = 1 << 6, // -കൾ
+				EndsInKkaL = 1 << 7, // -ക്കൾ
+				EndsInMaar = 1 << 8, // -മാർ
+				EndsInKaarPlural = 1 << 9, // -കാർ
+				EndsInKaaran = 1 << 10, // -കാരൻ
+				EndsInKaari = 1 << 11, // -കാരി
+				EndsInLongA = 1 << 12, // -ാ
+				EndsInSyllabicR = 1 << 13, // -ൃ
+				EndsInShortI = 1 << 14, // -ി
+				EndsInConsonant = 1 << 15, // A consonant with no vowel sign, i.e. the inherent /a/
+				EndsInNonChillu = 1 << 16, // Anything but a chillu
+				EndsInNonVirama = 1 << 17, // Anything but a virama
+				IsCVCu = 1 << 18, // The whole noun is CVCu or CCu
+				IsCLongV = 1 << 19, // The whole noun is C[long V]
+				IsIvarAvar = 1 << 20 // The whole noun is ഇവർ or അവർ
+			};
+
+			enum Stem // The class that decides how an inanimate or -kaaran/-kaari noun is pluralised
+			{
+				OtherStem, // Takes a plain suffix
+				AmStem, // -ം becomes -ങ്ങൾ
+				SchwaStem, // -് becomes -ുകൾ
+				ShortStem, // CVCu or C[long V], which takes -ക്കൾ
+				KaaranStem, // -കാരൻ, which takes -മാർ or becomes -കാർ
+				KaariStem // -കാരി, which takes -മാർ or becomes -കാർ
+			};
+
+			/**
+			* @desc An edit to the end of a noun: drop some bytes, then append some text.
+			**/
+			struct Rewrite
+			{
+				std::size_t strip; // # of bytes to remove from the end of the noun
+				std::string_view append; // UTF-8 text to add after that
+			};
+
+			/**
+			* @desc What classify() found out about a noun.
+			**/
+			struct Result
+			{
+				/**
+				* @desc Checks whether or not any of the given rules matched.
+				* @param r The rule(s) to check, OR'd together.
+				* @return True if at least one of them matched.
+				**/
+				bool has(std::uint32_t r) const;
+
+				std::uint32_t rules = 0; // Every rule that matched, OR'd together
+				Stem stem = OtherStem; // The noun's stem class
+				std::size_t nRewrites = 0; // # of valid entries in rewrites
+				std::array<Rewrite, 2> rewrites; // The stem's plural rewrites, most usual first
+			};
+
+			/**
+			* @desc Fetches the process-wide classifier, building its trie on the first call.
+			* @return The classifier.
+			**/
+			static const SuffixClassifier& get();
+
+			/**
+			* @desc Classifies a noun.
+			* @param noun The noun to classify. UTF-8 encoded Malayalam text.
+			* @return Every rule that matched, the stem class, and the stem's rewrites.
+			**/
+			Result classify(std::string_view noun) const;
+
+			/**
+			* @desc Classifies a noun that's already one byte per code point, which needs no decoding.
+			* @param noun The noun to classify.
+			* @return Every rule that matched, the stem class, and the stem's rewrites. The same as classify() gives for the noun's UTF-8.
+			**/
+			Result classify(const MalNoun& noun) const;
+
+			/**
+			* @desc Applies a rewrite to a noun.
+			* @param noun The noun to rewrite.
+			* @param rw The rewrite. Must not strip more than the noun's length.
+			* @return The rewritten noun.
+			**/
+			static std::string apply(std::string_view noun, const Rewrite& rw);
+
+			/**
+			* @desc Removes a suffix from a noun which is known to end in it.
+			* @param noun The noun.
+			* @param r A suffix rule that matched the noun, such as EndsInKaL.
+			* @return The noun without the suffix.
+			**/
+			static std::string withoutSuffix(std::string_view noun, Rule r);
+
+		private:
+			/**
+			* @desc A noun's last code points, last first. One more than the longest whole-word shape, so that we know when the noun is longer than that.
+			**/
+			typedef std::array<char32_t, 5> Tail;
+
+			/**
+			* @desc A node in the trie. The root is at index 0.
+			**/
+			struct Node
+			{
+				std::uint32_t accept = 0; // Rules whose suffix ends at this node
+				std::vector<std::pair<char32_t, std::uint32_t>> next; // (code point, child index) pairs, sorted by code point
+			};
+
+			/**
+			* @desc Constructor. Builds the trie from the suffix table. Only called by get().
+			**/
+			SuffixClassifier();
+
+			/**
+			* @desc Classifies a noun from its last code points, however they were decoded.
+			* @param rev The noun's last code points, last first.
+			* @param n The # of valid entries in rev. Less than rev's size only if that's the whole noun.
+			* @return Every rule that matched, the stem class, and the stem's rewrites.
+			**/
+			Result classifyTail(const Tail& rev, std::size_t n) const;
+
+			/**
+			* @desc Adds a suffix to the trie.
+			* @param suffix The suffix, in UTF-8.
+			* @param r The rule to report when the suffix matches.
+			**/
+			void insert(std::string_view suffix, Rule r);
+
+			std::vector<Node> trie; // Reversed suffixes, one code point per edge
+	};
+};
+
+#endif // MPP_SUFFIXCLASSIFIER_HPP
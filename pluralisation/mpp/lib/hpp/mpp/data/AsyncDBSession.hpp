@@ -0,0 +1,203 @@
+#ifndef MPP_DATA_ASYNCDBSESSION_HPP
+#define MPP_DATA_ASYNCDBSESSION_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <deque> // std::deque
+#include <vector> // std::vector
+#include <unordered_map> // std::unordered_map
+#include <functional> // std::function
+#include <exception> // std::exception_ptr
+#include <map> // std::map
+#include <chrono> // std::chrono::microseconds
+#include <memory> // std::shared_ptr
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+#include <boost/asio/io_context.hpp> // boost::asio::io_context
+#include <boost/asio/posix/stream_descriptor.hpp> // boost::asio::posix::stream_descriptor
+#include <boost/asio/steady_timer.hpp> // boost::asio::steady_timer
+
+/* MariaDB */
+#include <mysql.h> // MYSQL, MYSQL_RES
+
+/* Our headers */
+#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information (username, host, etc.)
+#include "mpp/data/NounFacts.hpp" // What a lookup produces
+#include "mpp/data/BloomFilter.hpp" // Turns away nouns that the DB knows nothing about
+
+namespace mpp
+{
+	namespace data
+	{
+		/**
+		* @desc A single connection to the DB that never blocks the thread using it.
+		*	It uses the MariaDB client's non-blocking API: each call returns as soon as it would have to wait for the socket, and the socket is handed to an io_context, which resumes the call once it's ready. The io_context's thread can serve every other connection in the meantime.
+		*	A connection runs one query at a time, so lookups are queued and run in the order that they were asked for. Every method, and every handler, runs on the io_context's thread.
+		*	Lookups that queue up behind a running query are sent together as one query, of up to batchSize nouns, once it finishes. A lookup that finds the connection idle may also wait up to batchWindow for others to join it.
+		*	A lookup of a noun that's already queued or running doesn't queue again; it waits for the same result, so that a burst of requests for one noun costs the DB one lookup.
+		*	If the session has a filter of every noun and exceptional plural in the DB, a noun that the filter rules out is answered without a query.
+		**/
+		class AsyncDBSession : private boost::noncopyable
+		{
+			public:
+				/* Types */
+				typedef std::function<void(std::exception_ptr, NounFacts)> FactsHandler; // Called with a DBError, or with the noun's facts
+
+				/**
+				* @desc How well the filter is doing. Its false positive rate is falsePositives / (falsePositives + rejected).
+				**/
+				struct FilterStats
+				{
+					std::uint64_t checked = 0; // Lookups that the filter was asked about
+					std::uint64_t rejected = 0; // Lookups that it ruled out, which never reached the DB
+					std::uint64_t falsePositives = 0; // Lookups that it let through, of nouns that the DB knew nothing about
+				};
+
+				/**
+				* @desc Constructor. Connects to the DB, blocking until it's done, so that a bad config is found before the server starts.
+				* @param ioc The io_context whose thread will use the session.
+				* @param info Information needed to connect to the DB.
+				* @param batchSize The most nouns to look up in one query. Must be positive.
+				* @param batchWindow How long a lookup that finds the connection idle waits for others to join it. Zero sends it straight away.
+				* @throws mpp::exceptions::DBError If the connection can't be made.
+				**/
+				AsyncDBSession(boost::asio::io_context& ioc, const DBInfo& info, std::size_t batchSize = 1, std::chrono::microseconds batchWindow = std::chrono::microseconds(0));
+
+				/**
+				* @desc Destructor. Closes the connection. Lookups that are still queued are dropped without their handlers being called.
+				**/
+				~AsyncDBSession();
+
+				/**
+				* @desc Fetches everything that the DB knows about a noun, in the same form as DBSession::getFacts.
+				*	If the connection has dropped, it's reopened and the query is retried once.
+				*	If the noun is already being looked up, the handler shares that lookup's result.
+				* @param noun The noun to look up. UTF-8 encoded Malayalam text.
+				* @param handler Called once the lookup is done. Never called before this returns.
+				**/
+				void getFacts(const std::string& noun, FactsHandler handler);
+
+				/**
+				* @desc Fetches the # of lookups that are queued or running.
+				* @return The # of lookups.
+				**/
+				std::size_t pending() const;
+
+				/**
+				* @desc Fetches the # of lookups that have shared another's result rather than being queued themselves.
+				* @return The # of lookups.
+				**/
+				std::size_t shared() const;
+
+				/**
+				* @desc Sets the filter that lookups are checked against before they're queued.
+				*	The filter must hold every noun and every exceptional plural in the DB; a noun added to the DB later is reported as unknown until it's added to the filter.
+				* @param f The filter, which mustn't be changed while the session holds it. Null turns filtering off.
+				**/
+				void setFilter(std::shared_ptr<const BloomFilter> f);
+
+				/**
+				* @desc Fetches the filter's counters.
+				* @return The counters.
+				**/
+				const FilterStats& getFilterStats() const;
+
+			private:
+				/* Types */
+				typedef std::function<int(int)> Resume; // Continues a non-blocking call, given the events that it was waiting for. Returns what it's waiting for next, or 0 if it's done.
+
+				/**
+				* @desc Runs the lookups at the front of the queue, connecting first if need be. Does nothing if a query is already running, or while a batch is being gathered.
+				*	If there are fewer than batchSize of them and there's a batch window, the batch is gathered first.
+				**/
+				void startNext();
+
+				/**
+				* @desc Runs the lookups at the front of the queue, up to batchSize of them, as one query.
+				**/
+				void launch();
+
+				/**
+				* @desc Allocates a connection handle, and sets the options that every connection needs.
+				* @throws mpp::exceptions::DBError If the handle can't be allocated.
+				**/
+				void open();
+
+				/**
+				* @desc Starts opening a new connection.
+				* @param then Called once the connection is open, with nothing, or once it has failed to open, with a DBError.
+				**/
+				void connect(std::function<void(std::exception_ptr)> then);
+
+				/**
+				* @desc Starts the query for the running batch. Duplicate nouns are only asked for once.
+				**/
+				void query();
+
+				/**
+				* @desc Waits for whatever a non-blocking call is waiting for, then resumes it, until it's done.
+				* @param status What the call returned: a MYSQL_WAIT_ mask, or 0 if it's done.
+				* @param resume Continues the call.
+				* @param done Called once the call is done.
+				**/
+				void await(int status, Resume resume, std::function<void()> done);
+
+				/**
+				* @desc Handles a failed query. The connection is closed, and if it was lost, the batch is retried once on a new one.
+				* @param where What was being done.
+				**/
+				void fail(const std::string& where);
+
+				/**
+				* @desc Completes the running batch, then starts the next one.
+				* @param err The error, if the query failed. Every lookup in the batch fails with it.
+				* @param facts Each noun's facts, if it didn't.
+				**/
+				void finish(std::exception_ptr err, std::map<std::string, NounFacts> facts);
+
+				/**
+				* @desc Closes the connection, so that the next lookup opens a new one.
+				**/
+				void disconnect();
+
+				/**
+				* @desc Builds a DBError from the connection's last error.
+				* @param where What was being done.
+				* @return The error.
+				**/
+				std::exception_ptr dbError(const std::string& where);
+
+				boost::asio::io_context& ioc;
+				std::string host; // Kept here, since the connection may be reopened at any time
+				std::string user;
+				std::string password;
+				std::string dbName;
+				MYSQL* mysql; // The connection. Null when it's closed.
+				boost::asio::posix::stream_descriptor sock; // The connection's socket, registered with ioc. It belongs to the client library, so it's released rather than closed.
+				boost::asio::steady_timer timer; // Used if the client library is waiting for a timeout rather than for the socket
+				boost::asio::steady_timer batchTimer; // Ends the batch window
+				std::size_t batchSize;
+				std::chrono::microseconds batchWindow;
+				std::deque<std::string> queue; // Nouns to look up, oldest first, each only once. The first batched ones are running if busy is set.
+				std::unordered_map<std::string, std::vector<FactsHandler>> waiters; // The handlers of every noun in queue, in the order that they were asked for
+				std::size_t nWaiting; // # of handlers in waiters
+				std::size_t nShared; // # of lookups that found their noun in queue
+				std::shared_ptr<const BloomFilter> filter; // Null if filtering is off
+				FilterStats filterStats;
+				std::size_t batched; // # of nouns at the front of the queue that the running query answers
+				bool busy; // Whether or not a query is running
+				bool gathering; // Whether or not batchTimer is running
+				bool retried; // Whether or not the running batch has already been retried on a new connection
+				std::string sql; // The running query. The client library reads it while the query is being sent.
+				int queryErr; // What mysql_real_query returned
+				MYSQL_RES* result; // The running query's rows
+		};
+	};
+};
+
+#endif // MPP_DATA_ASYNCDBSESSION_HPP
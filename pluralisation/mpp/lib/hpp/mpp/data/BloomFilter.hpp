@@ -0,0 +1,85 @@
+#ifndef MPP_DATA_BLOOMFILTER_HPP
+#define MPP_DATA_BLOOMFILTER_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* Standard C++ */
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+
+// The # of 64-bit words in a block. A block is one cache line, and a key sets one bit in each word.
+#define BLOOMBLOCKWORDS 8
+
+// The seed that keys are hashed with, so that the filter's bits don't line up with the lexicon's perfect hash
+#define BLOOMSEED 0x2545F4914F6CDD1DULL
+
+namespace mpp
+{
+	namespace data
+	{
+		/**
+		* @desc A Bloom filter over a set of strings, which answers "definitely not in the set" or "possibly in the set".
+		*	It's blocked: every bit of a key lies in one cache line, chosen by its hash, so a check costs one hash and one cache miss however many bits are set.
+		*	Keys can be added but never removed. A copy can be made, added to, and swapped in for the original, which is how a filter that's being read is updated.
+		**/
+		class BloomFilter
+		{
+			public:
+				/**
+				* @desc Constructor. Makes an empty filter, sized for a # of keys.
+				* @param nKeys The # of keys that will be added. More can be added, at the cost of more false positives.
+				* @param bitsPerKey The # of bits to use per key. 10 gives about 1 false positive in 100, and each 5 more cut that by about 10 times.
+				**/
+				BloomFilter(std::size_t nKeys, unsigned bitsPerKey);
+
+				/**
+				* @desc Adds a key.
+				* @param key The key.
+				**/
+				void insert(std::string_view key);
+
+				/**
+				* @desc Checks whether a key may have been added.
+				* @param key The key.
+				* @return False if the key was definitely never added, or true if it may have been.
+				**/
+				bool mayContain(std::string_view key) const;
+
+				/**
+				* @desc Fetches the # of keys that have been added.
+				* @return The # of keys, counting a key that was added twice twice.
+				**/
+				std::size_t size() const;
+
+				/**
+				* @desc Fetches the size of the filter's bits.
+				* @return The # of bytes.
+				**/
+				std::size_t bytes() const;
+
+			private:
+				/**
+				* @desc The bits that a key may set, all in one cache line.
+				**/
+				struct alignas(64) Block
+				{
+					std::uint64_t words[BLOOMBLOCKWORDS];
+				};
+
+				/**
+				* @desc Finds a key's block, and the bit that it sets in each of the block's words.
+				* @param key The key.
+				* @param masks Set to the bit in each word.
+				* @return The block's index.
+				**/
+				std::size_t locate(std::string_view key, std::uint64_t (&masks)[BLOOMBLOCKWORDS]) const;
+
+				std::vector<Block> blocks;
+				std::size_t nKeys; // # of keys added
+		};
+	};
+};
+
+#endif // MPP_DATA_BLOOMFILTER_HPP
@@ -0,0 +1,134 @@
+#ifndef MPP_DATA_DBPOOL_HPP
+#define MPP_DATA_DBPOOL_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+
+/* Standard C++ */
+#include <vector> // std::vector
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex
+#include <condition_variable> // std::condition_variable
+#include <thread> // std::thread
+#include <chrono> // std::chrono::seconds
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+
+/* Our headers */
+#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information (username, host, etc.)
+#include "mpp/data/DBSession.hpp" // A connection with prepared statements
+
+namespace mpp
+{
+	namespace data
+	{
+		/**
+		* @desc A bounded pool of pre-connected DB sessions, shared by every request handler in the process.
+		*	A handler checks a session out for the duration of one request, and the session goes back into the pool when the Lease is destroyed.
+		*	A background thread periodically pings idle sessions and reconnects those that have gone stale, so that requests don't pay for reconnection.
+		**/
+		class DBPool : private boost::noncopyable
+		{
+			public:
+				/**
+				* @desc A session checked out of the pool. Returns the session to the pool when destroyed.
+				**/
+				class Lease : private boost::noncopyable
+				{
+					public:
+						/**
+						* @desc Constructor. Takes ownership of a checked-out session.
+						* @param p The pool that the session belongs to.
+						* @param s The session.
+						**/
+						Lease(DBPool& p, DBSession* s);
+
+						/**
+						* @desc Move constructor. Leaves the other lease empty.
+						* @param other The lease to take the session from.
+						**/
+						Lease(Lease&& other);
+
+						/**
+						* @desc Destructor. Returns the session to the pool.
+						**/
+						~Lease();
+
+						/**
+						* @desc Accesses the session.
+						* @return The checked-out session.
+						**/
+						DBSession* operator->() const;
+
+						/**
+						* @desc Accesses the session.
+						* @return The checked-out session.
+						**/
+						DBSession& operator*() const;
+
+						/**
+						* @desc Marks the session as broken, so that the pool reconnects it before lending it out again.
+						**/
+						void markBroken();
+
+					private:
+						DBPool* pool; // Pool to return the session to. Null once moved from.
+						DBSession* session; // The checked-out session
+						bool broken; // Whether or not the session must be reconnected before reuse
+				};
+
+				/**
+				* @desc Constructor. Opens every session up front and starts the validation thread.
+				* @param info Information needed to connect to the DB.
+				* @param size The # of sessions in the pool. Requests wait for a free session once this many are checked out.
+				* @param validateEvery How often idle sessions are checked. Zero disables the background thread.
+				**/
+				DBPool(const DBInfo& info, std::size_t size, std::chrono::seconds validateEvery = std::chrono::seconds(30));
+
+				/**
+				* @desc Destructor. Stops the validation thread. Every lease must have been returned by now.
+				**/
+				~DBPool();
+
+				/**
+				* @desc Checks a session out of the pool, waiting for one to be returned if they're all in use.
+				* @return A lease on the session.
+				**/
+				Lease acquire();
+
+				/**
+				* @desc Fetches the # of sessions in the pool.
+				* @return The pool's size.
+				**/
+				std::size_t size() const;
+
+			private:
+				/**
+				* @desc Puts a session back into the pool. Called by Lease.
+				* @param s The session to return.
+				* @param broken Whether or not the session needs to be reconnected.
+				**/
+				void release(DBSession* s, bool broken);
+
+				/**
+				* @desc Body of the validation thread. Pings each idle session, and reconnects stale ones.
+				**/
+				void validate();
+
+				DBInfo dbInfo; // Shared by every session
+				std::vector<std::unique_ptr<DBSession>> sessions; // Every session, whether idle or checked out
+				std::vector<DBSession*> idle; // Sessions that are ready to be lent out
+				std::vector<DBSession*> stale; // Sessions that were returned broken, and that need to be reconnected
+				std::mutex mtx; // Guards idle, stale, repairPending and stopping
+				std::condition_variable available; // Signalled when a session is returned
+				std::condition_variable wake; // Signalled to wake the validation thread early
+				std::chrono::seconds interval; // Time between validation passes
+				bool repairPending; // Set when a session is returned broken, to wake the validation thread early
+				bool stopping; // Set to stop the validation thread
+				std::thread validator; // Runs validate()
+		};
+	};
+};
+
+#endif // MPP_DATA_DBPOOL_HPP
@@ -0,0 +1,109 @@
+#ifndef MPP_DATA_DBSESSION_HPP
+#define MPP_DATA_DBSESSION_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <vector> // std::vector
+#include <unordered_map> // std::unordered_map
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+
+/* MariaDB++ */
+#include <mariadb++/account.hpp> // mariadb::account_ref
+#include <mariadb++/connection.hpp> // mariadb::connection_ref
+#include <mariadb++/statement.hpp> // mariadb::statement_ref
+
+/* Our headers */
+#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information (username, host, etc.)
+#include "mpp/data/NounFacts.hpp" // What a lookup produces
+
+// The most lexiconChanges rows to read in one go
+#define LEXICONCHANGESBATCH 1000
+
+namespace mpp
+{
+	namespace data
+	{
+		/**
+		* @desc A single connection to the DB, along with the statement that ReqHandler needs, already prepared on it.
+		*	Sessions are owned by a DBPool and lent to request handlers one request at a time.
+		**/
+		class DBSession : private boost::noncopyable
+		{
+			public:
+				/**
+				* @desc Constructor. Connects to the DB and prepares the statements.
+				* @param info Information needed to connect to the DB.
+				**/
+				explicit DBSession(const DBInfo& info);
+
+				/**
+				* @desc Throws away the current connection and statements, and opens new ones.
+				**/
+				void reconnect();
+
+				/**
+				* @desc Fetches everything that the DB knows about a noun in a single round-trip.
+				*	If the connection has dropped, it's reopened and the query is retried once.
+				* @param noun The noun to look up. UTF-8 encoded Malayalam text.
+				* @return The noun's facts.
+				**/
+				NounFacts getFacts(const std::string& noun);
+
+				/**
+				* @desc Fetches the id of the newest row in the lexiconChanges table, which triggers on the noun tables fill in (see the server's README).
+				* @return The id, or 0 if the table is empty.
+				* @throws mpp::exceptions::DBError If the table can't be read.
+				**/
+				std::uint64_t latestChange();
+
+				/**
+				* @desc Reads up to LEXICONCHANGESBATCH rows of the lexiconChanges table, oldest first.
+				* @param after Only rows with a later id are read. Set to the id of the last row that was read.
+				* @param nouns Each noun named by the rows is appended, unless it's already there.
+				* @return The # of rows read. If it's LEXICONCHANGESBATCH, there may be more.
+				* @throws mpp::exceptions::DBError If the table can't be read.
+				**/
+				std::size_t changedNouns(std::uint64_t& after, std::vector<std::string>& nouns);
+
+				/**
+				* @desc Reads every string that a lookup could find something about: every noun, and every exceptional plural.
+				* @return The strings, each once.
+				* @throws mpp::exceptions::DBError If the tables can't be read.
+				**/
+				std::vector<std::string> lookupKeys();
+
+				/**
+				* @desc Reads every noun's exceptional plurals, e.g. so that the replies about a plural can be dropped once its singular no longer has it.
+				* @return The plurals, keyed by the noun. Nouns without any are left out.
+				* @throws mpp::exceptions::DBError If the table can't be read.
+				**/
+				std::unordered_map<std::string, std::vector<std::string>> exceptionalPlurals();
+
+				/**
+				* @desc Checks whether or not the connection still works by sending a trivial query over it.
+				* @return True if the query succeeded, false if the connection is stale.
+				**/
+				bool isAlive();
+
+			private:
+				/**
+				* @desc Acquires the resources needed to communicate with the DB.
+				**/
+				void open();
+
+				const DBInfo& dbInfo; // Owned by the pool, which outlives its sessions
+				mariadb::account_ref dbAcc; // Pointer to DB account object
+				mariadb::connection_ref dbConn; // Pointer to DB connection object
+				mariadb::statement_ref factsStmt; // Fetches every fact about a noun, and the singulars it's an exceptional plural of. Takes the noun twice.
+				mariadb::statement_ref changesStmt; // Reads the change log after a given id. Only prepared once it's needed, since only servers that refresh their lexicon need the table to exist.
+		};
+	};
+};
+
+#endif // MPP_DATA_DBSESSION_HPP
@@ -0,0 +1,208 @@
+#ifndef MPP_DATA_LEXICON_HPP
+#define MPP_DATA_LEXICON_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t, std::uint16_t, std::uint8_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+#include <map> // std::map
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+
+/* Our headers */
+#include "bosmacros/filesystem.hpp" // FILESYSTEM_PATH macro
+#include "mpp/data/DBInfo.hpp" // Encapsulates DB connection information (username, host, etc.)
+#include "mpp/data/NounFacts.hpp" // What a lookup produces
+#include "mpp/data/PerfectHash.hpp" // Finds a noun's record
+
+// The first 8 bytes of a lexicon file, including the terminating NUL
+#define LEXICON_FILE_MAGIC "MPPLEXI"
+
+// The version of the lexicon file format. Bump it whenever the layout of the file, NounRecord or PluralRef changes.
+#define LEXICON_FILE_VERSION 2
+
+namespace mpp
+{
+	namespace data
+	{
+		/**
+		* @desc An immutable, in-memory snapshot of the noun tables (nouns, pluralisableNouns, animacies, humanNouns, genders and exceptions).
+		*	It's loaded once, and thereafter answers every question ReqHandler would otherwise have asked MariaDB.
+		*	All strings live in one contiguous arena, and nouns are stored as fixed-size records sorted by noun. A minimal perfect hash over the nouns, built with the records, finds a noun's record with one probe, and turns away almost every unknown noun without comparing strings.
+		*	The same tables can be written to a file by save() (see mpp-lexc), and mapped back in read-only. A mapped lexicon is used in place, so opening it parses nothing, and every process that maps the same file shares its pages.
+		**/
+		class Lexicon : private boost::noncopyable
+		{
+			public:
+				/* Types */
+				enum Flag : std::uint8_t // Bits stored in NounRecord::flags
+				{
+					Pluralisable = 0x01, // AND of every pluralisableNouns.pluralisable row (true if there are none)
+					Animate = 0x02, // AND of every animacies.animate row (false if there are none)
+					Human = 0x04, // AND of every humanNouns.humanity row (false if there are none)
+					Exceptional = 0x08 // The noun has exceptions rows, and every one of them has a non-empty plural
+				};
+
+				/**
+				* @desc A single noun's facts. Strings are stored as (offset, length) pairs into the arena.
+				**/
+				struct NounRecord
+				{
+					std::uint32_t nounOff; // Offset of the noun in the arena
+					std::uint16_t nounLen; // Length of the noun in bytes
+					std::uint8_t flags; // Bitwise OR of Flag values
+					std::uint8_t gender; // A Gender value
+					std::uint32_t pluralIdx; // Index of the noun's first exceptional plural in the plural table
+					std::uint32_t nPlurals; // # of rows the noun has in the exceptions table
+				};
+
+				/**
+				* @desc Constructor. Opens its own connection to the DB, reads every noun table, and builds the snapshot.
+				* @param dbInfo Information needed to connect to the DB.
+				**/
+				explicit Lexicon(const DBInfo& dbInfo);
+
+				/**
+				* @desc Constructor. Maps a file written by save() read-only. Its header, section bounds and checksum are checked once, here; the tables themselves are used as they are.
+				* @param file The file's path.
+				* @throws mpp::exceptions::LexiconFileError If the file can't be mapped, or isn't a valid lexicon file for this build.
+				**/
+				explicit Lexicon(const FILESYSTEM_PATH& file);
+
+				/**
+				* @desc Constructor. Copies another lexicon with some of its nouns' facts replaced, so that changes to the DB can be applied without reading every table again.
+				* @param base The lexicon to copy. It may have been mapped from a file.
+				* @param changes The current facts of every noun that has changed, as DBSession::getFacts returns them. A noun that no longer exists is removed, and one that's new is added.
+				**/
+				Lexicon(const Lexicon& base, const std::vector<NounFacts>& changes);
+
+				/**
+				* @desc Destructor. Unmaps the file, if the lexicon was mapped from one.
+				**/
+				~Lexicon();
+
+				/**
+				* @desc Writes the lexicon to a file that can be mapped by the path constructor.
+				*	The file is written under a temporary name and then renamed, so that servers which already have the old file mapped keep seeing a complete copy of it.
+				* @param file The file's path.
+				* @throws mpp::exceptions::LexiconFileError If the file can't be written.
+				**/
+				void save(const FILESYSTEM_PATH& file) const;
+
+				/**
+				* @desc Finds the record for a noun.
+				* @param noun The noun to look up. UTF-8 encoded Malayalam text.
+				* @return A pointer to the noun's record, or nullptr if the noun isn't in the lexicon.
+				**/
+				const NounRecord* find(std::string_view noun) const;
+
+				/**
+				* @desc Gathers everything known about a noun, in the same form as a DB lookup would.
+				* @param noun The noun to look up. UTF-8 encoded Malayalam text.
+				* @return The noun's facts. If it isn't in the lexicon, only exceptionalSingulars may be filled in.
+				**/
+				NounFacts facts(const std::string& noun) const;
+
+				/**
+				* @desc Fetches the text of a record's noun.
+				* @param rec A record belonging to this lexicon.
+				* @return A view of the noun, which lives as long as the lexicon.
+				**/
+				std::string_view nounOf(const NounRecord& rec) const;
+
+				/**
+				* @desc Fetches a noun's exceptional plurals, in the order that the exceptions table returned them.
+				* @param rec A record belonging to this lexicon.
+				* @return Every exceptions.plural value stored for the noun (possibly none).
+				**/
+				std::vector<std::string> exceptionalPlurals(const NounRecord& rec) const;
+
+				/**
+				* @desc Finds the singular forms of an exceptional plural.
+				* @param plural A plural which may or may not be stored in the exceptions table.
+				* @return The nouns which have the given plural as an exceptional plural (possibly none).
+				**/
+				std::vector<std::string> singularsOf(std::string_view plural) const;
+
+				/**
+				* @desc Fetches the number of nouns in the lexicon.
+				* @return The number of noun records.
+				**/
+				std::size_t size() const;
+
+			private:
+				/**
+				* @desc A (string, noun) pair, used to map an exceptional plural back to its singular.
+				**/
+				struct PluralRef
+				{
+					std::uint32_t off; // Offset of the plural in the arena
+					std::uint32_t len; // Length of the plural in bytes
+					std::uint32_t recIdx; // Index of the singular's record
+				};
+
+				/**
+				* @desc Fetches a view of a string in the arena.
+				* @param off The string's offset.
+				* @param len The string's length.
+				* @return A view of the string.
+				**/
+				std::string_view str(std::uint32_t off, std::uint32_t len) const;
+
+				/**
+				* @desc Appends a string to the arena.
+				* @param s The string to append.
+				* @return The offset at which it was stored.
+				**/
+				std::uint32_t intern(const std::string& s);
+
+				/**
+				* @desc Fetches the facts stored in a record. exceptionalSingulars isn't filled in, since it doesn't come from the record.
+				* @param rec A record belonging to this lexicon.
+				* @return The facts.
+				**/
+				NounFacts factsOf(const NounRecord& rec) const;
+
+				/**
+				* @desc Flattens a set of nouns into the arena, the record and plural tables and the perfect hash, and points lookups at them.
+				* @param nouns Every noun's facts, keyed (and so sorted) by noun.
+				**/
+				void build(const std::map<std::string, NounFacts>& nouns);
+
+				/**
+				* @desc Points the tables that lookups use at the arena and vectors built by build(), including the perfect hash's.
+				**/
+				void useOwnTables();
+
+				/* Built by the DB and copying constructors. Empty if the lexicon was mapped from a file. */
+				std::string arena; // Every noun and plural, back to back
+				std::vector<NounRecord> records; // One per noun, sorted by noun
+				std::vector<PluralRef> plurals; // Exceptional plurals, grouped by noun. NounRecord::pluralIdx indexes this.
+				std::vector<PluralRef> byPlural; // The same entries as plurals, sorted by plural text, for reverse lookups
+				std::vector<std::uint32_t> pilots; // The perfect hash's pilots
+				std::vector<PerfectHash::Slot> slots; // The perfect hash's slots. Slot::index is a record's index.
+				std::uint64_t hashSeed; // The perfect hash's seed
+
+				/* The tables that lookups use, either the ones above or the mapped file's */
+				std::string_view arenaView;
+				const NounRecord* recTable;
+				std::size_t nRecs;
+				const PluralRef* pluralTable;
+				const PluralRef* byPluralTable;
+				std::size_t nPluralRefs; // # of entries in each plural table
+				const std::uint32_t* pilotTable; // PerfectHash::bucketsFor(nRecs) pilots
+				const PerfectHash::Slot* slotTable; // nRecs slots
+				PerfectHash nounIndex; // Maps a noun to its record's index
+
+				void* mapping; // The mapped file, or null
+				std::size_t mappingSize; // The mapped file's size in bytes
+		};
+	};
+};
+
+#endif // MPP_DATA_LEXICON_HPP
@@ -0,0 +1,122 @@
+#ifndef MPP_DATA_LIVELEXICON_HPP
+#define MPP_DATA_LIVELEXICON_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* Standard C++ */
+#include <atomic> // std::atomic
+#include <memory> // std::shared_ptr, std::unique_ptr
+#include <mutex> // std::mutex
+#include <vector> // std::vector
+#include <utility> // std::pair
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+
+/* Our headers */
+#include "mpp/data/Lexicon.hpp" // What's published
+
+namespace mpp
+{
+	namespace data
+	{
+		/**
+		* @desc The lexicon that requests currently see, which can be replaced while they're being answered.
+		*	Readers never block or take a lock: a Snapshot publishes the global epoch in its reader's slot, then loads the current lexicon's address.
+		*	publish() swaps the address atomically and retires the old lexicon under the epoch it was replaced in. reclaim() frees it once every reader's slot is empty or shows a later epoch, i.e. once the last request that could have seen it has finished.
+		*	Each reader is one thread, such as an io_context's, and it may only hold one Snapshot at a time. Writers may be any threads; they're serialised by a mutex that readers never touch.
+		**/
+		class LiveLexicon : private boost::noncopyable
+		{
+			public:
+				/**
+				* @desc Pins the current lexicon for as long as it exists, so that it can't be reclaimed while it's being read.
+				**/
+				class Snapshot : private boost::noncopyable
+				{
+					public:
+						/**
+						* @desc Constructor. Pins the current lexicon.
+						* @param live The lexicon to read.
+						* @param reader The reading thread's slot, from 0 to readers() - 1.
+						* @throws std::out_of_range If there's no such slot.
+						**/
+						Snapshot(const LiveLexicon& live, std::size_t reader);
+
+						/**
+						* @desc Destructor. Unpins the lexicon.
+						**/
+						~Snapshot();
+
+						/**
+						* @desc Fetches the pinned lexicon.
+						* @return The lexicon. Only valid while this snapshot exists.
+						**/
+						const Lexicon* operator->() const;
+
+						/**
+						* @desc Fetches the pinned lexicon.
+						* @return The lexicon. Only valid while this snapshot exists.
+						**/
+						const Lexicon& operator*() const;
+
+					private:
+						std::atomic<std::uint64_t>& pin; // The reader's slot
+						const Lexicon* lex; // The pinned lexicon
+				};
+
+				/**
+				* @desc Constructor.
+				* @param initial The first lexicon to publish. Must not be null.
+				* @param nReaders The # of threads that will read it. Must be positive.
+				**/
+				LiveLexicon(std::shared_ptr<const Lexicon> initial, std::size_t nReaders);
+
+				/**
+				* @desc Makes a new lexicon current. Requests that have already pinned the old one keep using it; every later one sees the new one.
+				*	The old lexicon is retired, and freed by a later call to reclaim().
+				* @param next The lexicon to publish. Must not be null.
+				**/
+				void publish(std::shared_ptr<const Lexicon> next);
+
+				/**
+				* @desc Frees every retired lexicon that no reader can still be using.
+				* @return The # of retired lexicons that are still pinned.
+				**/
+				std::size_t reclaim();
+
+				/**
+				* @desc Fetches the current lexicon, for use outside of the readers' threads.
+				* @return The lexicon. Holding on to it delays its destruction, but not its retirement.
+				**/
+				std::shared_ptr<const Lexicon> current() const;
+
+				/**
+				* @desc Fetches the # of reader slots.
+				* @return The # of slots.
+				**/
+				std::size_t readers() const;
+
+			private:
+				/**
+				* @desc A reader's slot. Each one has a cache line of its own, so that readers on different cores don't slow each other down.
+				**/
+				struct alignas(64) ReaderSlot
+				{
+					std::atomic<std::uint64_t> pinned {0}; // The epoch that the reader's snapshot was taken in, or 0 if it has none
+				};
+
+				std::atomic<const Lexicon*> published; // What new snapshots pin
+				std::atomic<std::uint64_t> epoch; // Incremented by every publish(). Starts at 1, since 0 means "not pinned".
+				std::unique_ptr<ReaderSlot[]> slots;
+				const std::size_t nReaders;
+				mutable std::mutex writerMtx; // Guards owner and retired. Never taken by readers.
+				std::shared_ptr<const Lexicon> owner; // Keeps the published lexicon alive
+				std::vector<std::pair<std::uint64_t, std::shared_ptr<const Lexicon>>> retired; // Replaced lexicons, with the epoch they were replaced in
+		};
+	};
+};
+
+#endif // MPP_DATA_LIVELEXICON_HPP
@@ -0,0 +1,42 @@
+#ifndef MPP_DATA_NOUNFACTS_HPP
+#define MPP_DATA_NOUNFACTS_HPP
+
+/* C++ versions of C headers */
+#include <cstdint> // std::uint8_t
+
+/* Standard C++ */
+#include <string> // std::string
+#include <vector> // std::vector
+
+namespace mpp
+{
+	namespace data
+	{
+		enum Gender : std::uint8_t // A noun's gender, as stored in the genders table
+		{
+			Masculine,
+			Feminine,
+			Neuter,
+			Unknown // The noun has no row in the genders table
+		};
+
+		/**
+		* @desc Everything that the DB knows about a single noun, resolved once per request and then passed to each of ReqHandler's predicates.
+		*	The defaults describe a noun that isn't in the DB.
+		**/
+		struct NounFacts
+		{
+			std::string noun; // The noun these facts are about
+			bool exists = false; // Whether or not the noun is in the nouns table
+			bool pluralisable = true; // AND of every pluralisableNouns.pluralisable row (true if there are none)
+			bool animate = false; // AND of every animacies.animate row (false if there are none)
+			bool human = false; // AND of every humanNouns.humanity row (false if there are none)
+			Gender gender = Unknown; // From the genders table
+			bool exceptional = false; // The noun has exceptions rows, and every one of them has a non-empty plural
+			std::vector<std::string> exceptionalPlurals; // The noun's exceptions.plural values
+			std::vector<std::string> exceptionalSingulars; // Nouns which have this noun as an exceptional plural
+		};
+	};
+};
+
+#endif // MPP_DATA_NOUNFACTS_HPP
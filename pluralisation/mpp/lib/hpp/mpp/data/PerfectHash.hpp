@@ -0,0 +1,128 @@
+#ifndef MPP_DATA_PERFECTHASH_HPP
+#define MPP_DATA_PERFECTHASH_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t, std::uint32_t
+
+/* Standard C++ */
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+
+// The average # of keys per bucket. More means fewer pilots to store, but a longer build.
+#define MPHBUCKETSIZE 4
+
+// The most pilots to try for one bucket before giving up on a seed
+#define MPHMAXPILOT (1U << 24)
+
+// The most seeds to try before giving up on a key set
+#define MPHMAXSEEDS 16
+
+// What find() returns for a key that isn't in the set
+#define MPHNOTFOUND 0xFFFFFFFFU
+
+namespace mpp
+{
+	namespace data
+	{
+		/**
+		* @desc A minimal perfect hash function over a fixed set of strings, built by hash-and-displace (as in CHD and PTHash).
+		*	Each key hashes to a bucket, and each bucket stores a pilot, chosen at build time so that its keys land on slots that no other key uses. n keys fill exactly n slots.
+		*	A slot holds its key's index and a 32-bit fingerprint, so a lookup is one hash and one probe, and almost every key outside the set is turned away without comparing any strings.
+		*	This class doesn't own its tables. They live either in vectors filled by build(), or in a mapped lexicon file.
+		**/
+		class PerfectHash
+		{
+			public:
+				/* Types */
+
+				/**
+				* @desc What a key's slot holds.
+				**/
+				struct Slot
+				{
+					std::uint32_t index; // The key's index in the key list given to build()
+					std::uint32_t fingerprint; // Bits of the key's hash that aren't used to find the slot
+				};
+
+				/**
+				* @desc Builds the tables for a set of keys.
+				* @param keys The keys. They must all be different.
+				* @param pilots Set to one pilot per bucket.
+				* @param slots Set to one slot per key.
+				* @return The seed that the tables were built with.
+				* @throws std::runtime_error If no seed works, which only happens if two keys are the same.
+				**/
+				static std::uint64_t build(const std::vector<std::string_view>& keys, std::vector<std::uint32_t>& pilots, std::vector<Slot>& slots);
+
+				/**
+				* @desc Fetches the # of buckets that build() uses for a # of keys.
+				* @param nKeys The # of keys.
+				* @return The # of buckets.
+				**/
+				static std::size_t bucketsFor(std::size_t nKeys);
+
+				/**
+				* @desc Constructor. Makes an empty function, which finds nothing.
+				**/
+				PerfectHash();
+
+				/**
+				* @desc Constructor. Uses tables made by build().
+				* @param seed The seed returned by build().
+				* @param pilots The pilots. There must be bucketsFor(nSlots) of them.
+				* @param slots The slots.
+				* @param nSlots The # of slots, i.e. the # of keys.
+				**/
+				PerfectHash(std::uint64_t seed, const std::uint32_t* pilots, const Slot* slots, std::size_t nSlots);
+
+				/**
+				* @desc Finds the index of a key.
+				* @param key The key.
+				* @return The index that build() was given the key at, or MPHNOTFOUND if the key's fingerprint doesn't match its slot's. Keys outside the set match with a probability of 1 in 2^32, so the caller must still check the key at the index.
+				**/
+				std::uint32_t find(std::string_view key) const;
+
+				/**
+				* @desc Hashes a key.
+				* @param key The key.
+				* @param seed The seed.
+				* @return The hash.
+				**/
+				static std::uint64_t hash(std::string_view key, std::uint64_t seed);
+
+			private:
+				/**
+				* @desc Finds a hash's bucket.
+				* @param h The hash.
+				* @param nBuckets The # of buckets.
+				* @return The bucket's index.
+				**/
+				static std::size_t bucketOf(std::uint64_t h, std::size_t nBuckets);
+
+				/**
+				* @desc Finds a hash's slot, given its bucket's pilot.
+				* @param h The hash.
+				* @param pilot The pilot.
+				* @param nSlots The # of slots.
+				* @return The slot's index.
+				**/
+				static std::size_t slotOf(std::uint64_t h, std::uint32_t pilot, std::size_t nSlots);
+
+				/**
+				* @desc Computes a hash's fingerprint.
+				* @param h The hash.
+				* @return The fingerprint.
+				**/
+				static std::uint32_t fingerprintOf(std::uint64_t h);
+
+				std::uint64_t seed;
+				const std::uint32_t* pilots; // One per bucket
+				const Slot* slots; // One per key
+				std::size_t nSlots;
+				std::size_t nBuckets;
+		};
+	};
+};
+
+#endif // MPP_DATA_PERFECTHASH_HPP
@@ -0,0 +1,35 @@
+#ifndef MPP_EXCEPTIONS_LEXICONFILEERROR_HPP
+#define MPP_EXCEPTIONS_LEXICONFILEERROR_HPP
+
+/* Standard C++ */
+#include <string> // std::string
+
+/* Our headers */
+#include "mpp/exceptions/Exception.hpp" // Parent of all MPP exceptions
+
+namespace mpp
+{
+	namespace exceptions
+	{
+		/**
+		* @desc Thrown if a lexicon file can't be mapped or written, or isn't a valid lexicon file.
+		**/
+		class LexiconFileError final : public Exception
+		{
+			public:
+				/**
+				* @desc Constructor. Constructs our parent with the given raw string.
+				* @param what A raw string containing the text to store in this exception.
+				**/
+				LexiconFileError(char* what);
+
+				/**
+				* @desc Constructor. Constructs our parent with the given raw string.
+				* @param what A raw string containing the text to store in this exception.
+				**/
+				LexiconFileError(std::string what);
+		}; // class LexiconFileError
+	}; // namespace exceptions
+}; // namespace mpp
+
+#endif // MPP_EXCEPTIONS_LEXICONFILEERROR_HPP
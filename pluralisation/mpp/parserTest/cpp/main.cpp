@@ -2,6 +2,8 @@
 #include <string> // std::string
 #include <iostream> // std::cout, std::wcout, std::boolalpha
 #include <sstream> // std::stringstream
+#include <string_view> // std::string_view
+#include <cstddef> // std::size_t
 
 #include <boost/program_options.hpp> // boost::program_options::options_description, boost::program_options::value, boost::program_options::variables_map, boost::program_options::positional_options_description, boost::program_options::store, boost::program_options::command_line_parser, boost::filesystem::ifstream
 #include <boost/filesystem.hpp> // boost::filesystem::path, boost::filesystem::exists
@@ -13,6 +15,7 @@
 
 #define COMLEN 100 // Length of a command
 #define INPLEN 200 // Length of input
+#define NPIPELINED 3 // # of copies of the request to send back to back when testing pipelining
 
 enum ExitCode
 {
@@ -22,7 +25,9 @@ enum ExitCode
 	COULDNTOPENFILE,
 	BADREQ,
 	NEEDMOREDATA,
-	INPDNE
+	INPDNE,
+	PATHSDISAGREE,
+	PIPELINEFAILED
 };
 
 int main(int argc, char* argv[])
@@ -99,8 +104,96 @@ int main(int argc, char* argv[])
 		boost::tribool result;
 		boost::tie(result, boost::tuples::ignore) = reqParser.parse(req, fConts.cbegin(), fConts.cend());
 
+		/* The bulk parser must agree with the character-by-character one, whether the request arrives in one read or is split across two at any point */
+		for (std::size_t split = 0; split <= fConts.length(); split++)
+		{
+			mpp::Request bulkReq;
+			mpp::ReqParser bulkParser;
+			std::string_view whole(fConts);
+			boost::tribool bulkResult;
+			boost::tie(bulkResult, boost::tuples::ignore) = bulkParser.parse(bulkReq, whole.substr(0, split));
+
+			if (boost::indeterminate(bulkResult))
+			{
+				boost::tie(bulkResult, boost::tuples::ignore) = bulkParser.parse(bulkReq, whole.substr(split));
+			}
+
+			bool agrees; // Whether or not both parsers reached the same result
+
+			if (result)
+			{
+				agrees = (static_cast<bool>(bulkResult) && bulkReq.getNoun() == req.getNoun() && bulkReq.GETCOM_FUNC() == req.GETCOM_FUNC());
+			}
+
+			else if (!result)
+			{
+				agrees = (static_cast<bool>(!bulkResult) && bulkParser.getStatus() == reqParser.getStatus());
+			}
+
+			else
+			{
+				agrees = boost::indeterminate(bulkResult);
+			}
+
+			if (!agrees)
+			{
+				std::cout << ourName << ": the bulk parser disagrees when the request is split after " << split << " bytes: it returned " << bulkResult << ", with status " << bulkParser.getStatus() << std::endl;
+				return PATHSDISAGREE;
+			}
+		}
+
+		/* Several copies of a valid request sent back to back must parse as that many requests, wherever the first read ends */
 		if (result)
 		{
+			std::size_t reqLen; // # of bytes in the request itself, without anything after it in the file
+			mpp::Request lenReq;
+			mpp::ReqParser lenParser;
+			boost::tie(boost::tuples::ignore, reqLen) = lenParser.parse(lenReq, std::string_view(fConts));
+			std::string pipelined; // The copies of the request
+
+			for (std::size_t i = 0; i < NPIPELINED; i++)
+			{
+				pipelined.append(fConts, 0, reqLen);
+			}
+
+			for (std::size_t split = 0; split <= pipelined.length(); split++)
+			{
+				mpp::Request pipeReq;
+				mpp::ReqParser pipeParser;
+				std::string_view whole(pipelined);
+				std::size_t nParsed = 0; // # of requests parsed so far
+				bool agrees = true; // Whether or not every request parsed so far matches the original
+
+				for (std::string_view read : {whole.substr(0, split), whole.substr(split)})
+				{
+					while (!read.empty() && agrees) // Like Connection::handleRead, keep parsing until the read is used up
+					{
+						boost::tribool pipeResult;
+						std::size_t used;
+						boost::tie(pipeResult, used) = pipeParser.parse(pipeReq, read);
+						read.remove_prefix(used);
+
+						if (pipeResult)
+						{
+							agrees = (pipeReq.getNoun() == req.getNoun() && pipeReq.GETCOM_FUNC() == req.GETCOM_FUNC());
+							++nParsed;
+							pipeReq.clear();
+						}
+
+						else if (!pipeResult)
+						{
+							agrees = false;
+						}
+					}
+				}
+
+				if (!agrees || nParsed != NPIPELINED)
+				{
+					std::cout << ourName << ": pipelining failed when " << NPIPELINED << " copies of the request are split after " << split << " bytes: parsed " << nParsed << " requests, with status " << pipeParser.getStatus() << std::endl;
+					return PIPELINEFAILED;
+				}
+			}
+
 			std::cout << ourName << ": successfully parsed request." << std::endl;
 			return NORMAL;
 		}
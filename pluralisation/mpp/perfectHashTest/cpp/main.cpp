@@ -0,0 +1,119 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t, std::uint64_t
+#include <cstdlib> // EXIT_SUCCESS, EXIT_FAILURE
+
+/* Standard C++ */
+#include <iostream> // std::cout
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+#include <set> // std::set
+#include <random> // std::mt19937, std::uniform_int_distribution
+#include <chrono> // std::chrono::steady_clock, std::chrono::duration
+
+/* Our headers */
+#include "mpp/data/PerfectHash.hpp" // The hash under test
+
+#define NKEYS 200000 // # of nouns to hash
+#define NPROBES 1000000 // # of nouns outside the set to look up
+
+/**
+* @desc Makes a random noun out of Malayalam letters, each of which is 3 bytes in UTF-8.
+* @param gen The random number generator.
+* @return The noun.
+**/
+std::string randomNoun(std::mt19937& gen)
+{
+	std::uniform_int_distribution<std::size_t> lenDist(2, 8);
+	std::uniform_int_distribution<unsigned> cpDist(0x0D05, 0x0D4D);
+	std::string toReturn;
+
+	for (std::size_t i = lenDist(gen); i > 0; i--)
+	{
+		unsigned cp = cpDist(gen);
+		toReturn += static_cast<char>(0xE0 | (cp >> 12));
+		toReturn += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		toReturn += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+
+	return toReturn;
+}
+
+int main()
+{
+	std::mt19937 gen(20201016); // Fixed seed, so that failures can be reproduced
+	std::set<std::string> nounSet;
+
+	while (nounSet.size() < NKEYS)
+	{
+		nounSet.insert(randomNoun(gen));
+	}
+
+	std::vector<std::string_view> keys(nounSet.cbegin(), nounSet.cend());
+	std::vector<std::uint32_t> pilots;
+	std::vector<mpp::data::PerfectHash::Slot> slots;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::uint64_t seed = mpp::data::PerfectHash::build(keys, pilots, slots);
+	std::chrono::duration<double> buildTime = std::chrono::steady_clock::now() - start;
+	mpp::data::PerfectHash mph(seed, pilots.data(), slots.data(), slots.size());
+
+	std::size_t nFailures = 0;
+
+	if (slots.size() != keys.size() || pilots.size() != mpp::data::PerfectHash::bucketsFor(keys.size()))
+	{
+		std::cout << "Built " << slots.size() << " slots and " << pilots.size() << " pilots for " << keys.size() << " keys" << std::endl;
+		++nFailures;
+	}
+
+	/* Every key must find its own index */
+	for (std::size_t i = 0; i < keys.size(); i++)
+	{
+		if (mph.find(keys[i]) != i)
+		{
+			std::cout << "Key #" << i << " found index " << mph.find(keys[i]) << std::endl;
+			++nFailures;
+		}
+	}
+
+	/* Keys outside the set should almost never get past the fingerprint, and must never be given an index out of range */
+	std::size_t nProbes = 0;
+	std::size_t nPassed = 0; // # that matched a fingerprint
+
+	while (nProbes < NPROBES)
+	{
+		std::string noun = randomNoun(gen);
+
+		if (nounSet.count(noun) > 0)
+		{
+			continue;
+		}
+
+		std::uint32_t idx = mph.find(noun);
+		++nProbes;
+
+		if (idx != MPHNOTFOUND)
+		{
+			++nPassed;
+
+			if (idx >= keys.size())
+			{
+				std::cout << "A key outside the set found index " << idx << std::endl;
+				++nFailures;
+			}
+		}
+	}
+
+	if (nPassed > 10) // About 1 in 4000 is expected at 2^-32 per probe; anything like this many means the fingerprint is broken
+	{
+		std::cout << nPassed << " of " << nProbes << " keys outside the set got past the fingerprint" << std::endl;
+		++nFailures;
+	}
+
+	std::cout << "Built a perfect hash over " << keys.size() << " keys in " << buildTime.count() << " s, using " << (pilots.size() * sizeof(std::uint32_t) + slots.size() * sizeof(mpp::data::PerfectHash::Slot)) << " bytes" << std::endl
+	<< nPassed << " of " << nProbes << " keys outside the set got past the fingerprint" << std::endl
+	<< nFailures << " failures" << std::endl;
+
+	return (nFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
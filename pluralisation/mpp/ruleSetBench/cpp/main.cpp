@@ -0,0 +1,97 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdlib> // std::strtoul, EXIT_SUCCESS, EXIT_FAILURE
+
+/* Standard C++ */
+#include <iostream> // std::cout, std::cerr
+#include <string> // std::string
+#include <vector> // std::vector
+#include <chrono> // std::chrono::steady_clock, std::chrono::duration_cast
+#include <utility> // std::pair
+
+/* Boost */
+#include <boost/regex.hpp> // boost::smatch
+#include <boost/regex/icu.hpp> // boost::u32regex, boost::u32regex_match, boost::make_u32regex
+
+/* Our headers */
+#include "mpp/RuleSet.hpp" // The precompiled rule set
+
+/* Pointer to one of the rule set's regexes */
+typedef const boost::u32regex mpp::RuleSet::* RulePtr;
+
+int main(int argc, char* argv[])
+{
+	std::size_t nReqs = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000); // # of simulated requests
+
+	if (nReqs == 0)
+	{
+		std::cerr << "Usage: " << argv[0] << " [# of requests]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	/* The regexes that one request for a regular, non-human singular noun ran through, along with the source that ReqHandler used to compile for each one */
+	std::vector<std::pair<std::string, RulePtr>> perReq {
+		{".*\\x{d7e}$", &mpp::RuleSet::endsInRetroflexL},
+		{".*\\x{d15}\\x{d7e}$", &mpp::RuleSet::endsInKaL},
+		{".*[^\\x{d7a}-\\x{d7f}]$", &mpp::RuleSet::doesntEndInChillu},
+		{".*[^\\x{d4d}]$", &mpp::RuleSet::doesntEndInSchwa},
+		{".*\\x{d3e}$", &mpp::RuleSet::endsInLongA},
+		{".*\\x{d43}$", &mpp::RuleSet::endsInSyllabicR},
+		{".*\\x{d7b}$", &mpp::RuleSet::endsInAlveolarN},
+		{".*\\x{d02}$", &mpp::RuleSet::isAmStem},
+		{".*\\x{d4d}$", &mpp::RuleSet::endsInSchwa},
+		{"[\\x{d15}-\\x{d3a}]((?:)|[\\x{d3e}-\\x{d4e}])[\\x{d15}-\\x{d3a}]\\x{d41}", &mpp::RuleSet::cvcuReg},
+		{"[\\x{d15}-\\x{d3a}][\\x{d3e}|\\x{d40}|\\x{d42}|\\x{d44}|\\x{d47}|\\x{d4b}]", &mpp::RuleSet::cLongVReg},
+		{"(.*)\\x{d02}$", &mpp::RuleSet::amStemFinder}
+	};
+
+	/* Test nouns */
+	std::vector<std::string> nouns {
+		u8"\u0d2e\u0d30\u0d02", // maram
+		u8"\u0d35\u0d40\u0d1f\u0d4d", // veed
+		u8"\u0d15\u0d1f\u0d7d", // kadal
+		u8"\u0d2a\u0d42\u0d35\u0d4d" // poov
+	};
+
+	boost::smatch what; // Unused, but a necessary parameter for boost::u32regex_match
+	std::size_t nMatched = 0; // Keeps the matches from being optimised away, and shows that both loops did the same work
+
+	/* Old behaviour: every pattern is compiled while handling the request */
+	auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < nReqs; i++)
+	{
+		const std::string& noun = nouns[i % nouns.size()];
+
+		for (const auto& p : perReq)
+		{
+			nMatched += boost::u32regex_match(noun, what, boost::make_u32regex(p.first));
+		}
+	}
+
+	auto compiledNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	std::size_t compiledMatches = nMatched;
+
+	/* New behaviour: the patterns were compiled once, before the first request */
+	nMatched = 0;
+	const mpp::RuleSet& rules = mpp::RuleSet::get(); // Compile outside of the timed loop, like the server does on its first connection
+	start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < nReqs; i++)
+	{
+		const std::string& noun = nouns[i % nouns.size()];
+
+		for (const auto& p : perReq)
+		{
+			nMatched += boost::u32regex_match(noun, what, rules.*(p.second));
+		}
+	}
+
+	auto precompiledNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << nReqs << " requests, " << perReq.size() << " regexes per request" << std::endl
+	<< "Compiled per request: " << compiledNs / nReqs << " ns/request (" << compiledMatches << " matches)" << std::endl
+	<< "Precompiled rule set: " << precompiledNs / nReqs << " ns/request (" << nMatched << " matches)" << std::endl;
+
+	return (compiledMatches == nMatched ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,261 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <cstdlib> // EXIT_SUCCESS, EXIT_FAILURE
+
+/* Standard C++ */
+#include <iostream> // std::cout
+#include <iomanip> // std::quoted
+#include <string> // std::string, std::u32string
+#include <vector> // std::vector
+#include <random> // std::mt19937, std::uniform_int_distribution
+#include <utility> // std::pair
+
+/* Boost */
+#include <boost/regex.hpp>
+#include <boost/regex/icu.hpp> // boost::u32regex, boost::u32regex_match, boost::u32regex_replace
+
+/* Our headers */
+#include "mpp/RuleSet.hpp" // The regexes
+#include "mpp/SuffixClassifier.hpp" // The classifier under test
+#include "mpp/MalNoun.hpp" // The compact nouns that it also classifies
+
+/**
+* @desc A classifier rule and the regex that it replaces.
+**/
+struct Pair
+{
+	const char* name; // For printing
+	std::uint32_t rules; // Classifier rule(s). The regex matches if any of them do.
+	const boost::u32regex& reg; // The regex
+};
+
+/**
+* @desc Encodes a string of code points as UTF-8.
+* @param cps The code points.
+* @return The UTF-8 text.
+**/
+std::string toUTF8(const std::u32string& cps)
+{
+	std::string toReturn;
+
+	for (char32_t cp : cps)
+	{
+		if (cp < 0x80)
+		{
+			toReturn += static_cast<char>(cp);
+		}
+
+		else if (cp < 0x800)
+		{
+			toReturn += static_cast<char>(0xC0 | (cp >> 6));
+			toReturn += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+
+		else
+		{
+			toReturn += static_cast<char>(0xE0 | (cp >> 12));
+			toReturn += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			toReturn += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+	}
+
+	return toReturn;
+}
+
+int main()
+{
+	const mpp::RuleSet& rules = mpp::RuleSet::get();
+	const mpp::SuffixClassifier& classifier = mpp::SuffixClassifier::get();
+	typedef mpp::SuffixClassifier SC;
+
+	std::vector<Pair> pairs {
+		{"an-stem", SC::EndsInAn, rules.declRegs[0]},
+		{"am-stem", SC::EndsInAm, rules.declRegs[1]},
+		{"ruh-stem", SC::EndsInRuh, rules.declRegs[2]},
+		{"duh-stem", SC::EndsInDuh, rules.declRegs[3]},
+		{"schwa-stem", SC::EndsInVirama, rules.declRegs[4]},
+		{"endsInRetroflexL", SC::EndsInRetroflexL, rules.endsInRetroflexL},
+		{"endsInKaL", SC::EndsInKaL, rules.endsInKaL},
+		{"doesntEndInChillu", SC::EndsInNonChillu, rules.doesntEndInChillu},
+		{"doesntEndInSchwa", SC::EndsInNonVirama, rules.doesntEndInSchwa},
+		{"endsInKaar", SC::EndsInKaaran | SC::EndsInKaari, rules.endsInKaar},
+		{"endsInKaaran", SC::EndsInKaaran, rules.endsInKaaran},
+		{"endsInKaari", SC::EndsInKaari, rules.endsInKaari},
+		{"endsInLongA", SC::EndsInLongA, rules.endsInLongA},
+		{"endsInSyllabicR", SC::EndsInSyllabicR, rules.endsInSyllabicR},
+		{"endsInA", SC::EndsInConsonant, rules.endsInA},
+		{"endsInShortI", SC::EndsInShortI, rules.endsInShortI},
+		{"endsInAlveolarN", SC::EndsInAn, rules.endsInAlveolarN},
+		{"isAmStem", SC::EndsInAm, rules.isAmStem},
+		{"endsInSchwa", SC::EndsInVirama, rules.endsInSchwa},
+		{"cvcuReg", SC::IsCVCu, rules.cvcuReg},
+		{"cLongVReg", SC::IsCLongV, rules.cLongVReg},
+		{"endsInMaar", SC::EndsInMaar, rules.endsInMaar},
+		{"endsInKkaL", SC::EndsInKkaL, rules.endsInKkaL},
+		{"endsInKaarPlural", SC::EndsInKaarPlural, rules.endsInKaarPlural},
+		{"ivarAvar", SC::IsIvarAvar, rules.ivarAvar}
+	};
+
+	/* Every code point that a rule mentions, the ones either side of each range, and a couple that no rule cares about */
+	const std::u32string alphabet = U"\u0d02\u0d05\u0d07\u0d14\u0d15\u0d1f\u0d2e\u0d30\u0d31\u0d35\u0d3a\u0d3b\u0d3e\u0d3f\u0d40\u0d41\u0d42\u0d43\u0d44\u0d47\u0d4b\u0d4d\u0d4e\u0d7a\u0d7b\u0d7c\u0d7e\u0d7f\u0d80|a";
+
+	/* Build the corpus: every string of up to 4 code points, then random longer ones */
+	std::vector<std::u32string> corpus {U""};
+
+	for (std::size_t start = 0, len = 1; len <= 4; len++)
+	{
+		std::size_t end = corpus.size();
+
+		for (std::size_t i = start; i < end; i++)
+		{
+			for (char32_t cp : alphabet)
+			{
+				corpus.push_back(corpus[i] + cp);
+			}
+		}
+
+		start = end;
+	}
+
+	std::mt19937 gen(20201016); // Fixed seed, so that failures can be reproduced
+	std::uniform_int_distribution<std::size_t> lenDist(5, 9);
+	std::uniform_int_distribution<std::size_t> cpDist(0, alphabet.size() - 1);
+
+	for (std::size_t i = 0; i < 200000; i++)
+	{
+		std::u32string s;
+		std::size_t len = lenDist(gen);
+
+		for (std::size_t j = 0; j < len; j++)
+		{
+			s += alphabet[cpDist(gen)];
+		}
+
+		corpus.push_back(s);
+	}
+
+	std::size_t nFailures = 0; // # of disagreements
+	std::size_t nRiSkipped = 0; // # of -kaari nouns with another -ri in them
+	std::size_t nCompact = 0; // # of nouns that were also classified in compact form
+	boost::smatch what; // Unused, but a necessary parameter for boost::u32regex_match
+
+	for (const std::u32string& cps : corpus)
+	{
+		std::string noun = toUTF8(cps);
+		SC::Result res = classifier.classify(noun);
+		mpp::MalNoun compact;
+
+		if (mpp::MalNoun::encode(noun, compact)) // Only Malayalam code points, so the compact form must classify the same way
+		{
+			SC::Result compactRes = classifier.classify(compact);
+			++nCompact;
+
+			if (compactRes.rules != res.rules || compactRes.stem != res.stem)
+			{
+				std::cout << "The compact form of " << std::quoted(noun) << " classifies differently: rules 0x" << std::hex << compactRes.rules << " instead of 0x" << res.rules << std::dec << std::endl;
+				++nFailures;
+			}
+
+			if (compact.toUtf8() != noun)
+			{
+				std::cout << "The compact form of " << std::quoted(noun) << " converts back to " << std::quoted(compact.toUtf8()) << std::endl;
+				++nFailures;
+			}
+		}
+
+		/* Predicates */
+		for (const Pair& p : pairs)
+		{
+			bool regMatched = boost::u32regex_match(noun, what, p.reg);
+
+			if (regMatched != res.has(p.rules))
+			{
+				std::cout << "Rule " << p.name << " disagrees on " << std::quoted(noun) << ": regex " << (regMatched ? "matched" : "didn't match") << std::endl;
+				++nFailures;
+			}
+		}
+
+		/* Rewrites */
+		std::vector<std::pair<std::string, std::string>> rewrites; // (classifier, regex) pairs
+
+		switch (res.stem)
+		{
+			case SC::AmStem:
+			{
+				rewrites.emplace_back(SC::apply(noun, res.rewrites[0]), boost::u32regex_replace(noun, rules.amStemFinder, u8"$1\u0d19\u0d4d\u0d19\u0d7e"));
+				break;
+			}
+
+			case SC::SchwaStem:
+			{
+				rewrites.emplace_back(SC::apply(noun, res.rewrites[0]), boost::u32regex_replace(noun, rules.schwaFinder, u8"$1\u0d41") + u8"\u0d15\u0d7e");
+				break;
+			}
+
+			case SC::KaaranStem:
+			{
+				rewrites.emplace_back(SC::apply(noun, res.rewrites[0]), noun + u8"\u0d2e\u0d3e\u0d7c");
+				rewrites.emplace_back(SC::apply(noun, res.rewrites[1]), boost::u32regex_replace(noun, rules.ranFinder, u8"$1\u0d7c"));
+				break;
+			}
+
+			case SC::KaariStem:
+			{
+				rewrites.emplace_back(SC::apply(noun, res.rewrites[0]), noun + u8"\u0d2e\u0d3e\u0d7c");
+
+				if (noun.find(u8"\u0d30\u0d3f") == noun.size() - std::string(u8"\u0d30\u0d3f").size()) // The regex replaces every -ri, not just the last one
+				{
+					rewrites.emplace_back(SC::apply(noun, res.rewrites[1]), boost::u32regex_replace(noun, rules.riFinder, u8"\u0d7c"));
+				}
+
+				else
+				{
+					++nRiSkipped;
+				}
+
+				break;
+			}
+
+			case SC::ShortStem:
+			{
+				rewrites.emplace_back(SC::apply(noun, res.rewrites[0]), noun + u8"\u0d15\u0d4d\u0d15\u0d7e");
+				break;
+			}
+
+			default:
+			{
+				break;
+			}
+		}
+
+		if (res.has(SC::EndsInKaL))
+		{
+			rewrites.emplace_back(SC::withoutSuffix(noun, SC::EndsInKaL), boost::u32regex_replace(noun, rules.kaLFinder, "$1"));
+		}
+
+		if (res.has(SC::EndsInMaar))
+		{
+			rewrites.emplace_back(SC::withoutSuffix(noun, SC::EndsInMaar), boost::u32regex_replace(noun, rules.maarFinder, "$1"));
+		}
+
+		if (res.has(SC::EndsInKkaL))
+		{
+			rewrites.emplace_back(SC::withoutSuffix(noun, SC::EndsInKkaL), boost::u32regex_replace(noun, rules.kkaLFinder, "$1"));
+		}
+
+		for (const auto& rw : rewrites)
+		{
+			if (rw.first != rw.second)
+			{
+				std::cout << "Rewrite of " << std::quoted(noun) << " disagrees: classifier gave " << std::quoted(rw.first) << ", regex gave " << std::quoted(rw.second) << std::endl;
+				++nFailures;
+			}
+		}
+	}
+
+	std::cout << "Checked " << corpus.size() << " strings against " << pairs.size() << " rules, " << nCompact << " of them in compact form too: " << nFailures << " disagreements" << std::endl
+	<< "Skipped the -ri rewrite for " << nRiSkipped << " -kaari nouns with an earlier -ri, which the regex also rewrites" << std::endl;
+
+	return (nFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
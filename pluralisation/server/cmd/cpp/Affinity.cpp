@@ -0,0 +1,142 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+
+/* C headers */
+#include <sched.h> // cpu_set_t, CPU_ZERO, CPU_SET, CPU_ISSET, CPU_SETSIZE, sched_getaffinity
+#include <pthread.h> // pthread_self, pthread_setaffinity_np
+
+/* STL */
+#include <string> // std::string, std::stoi
+#include <vector> // std::vector
+#include <sstream> // std::stringstream, std::ostringstream
+#include <stdexcept> // std::invalid_argument
+#include <exception> // std::exception
+#include <algorithm> // std::find
+
+/* Our headers */
+#include "Affinity.hpp" // Function def'ns
+
+/**
+* @desc Reads a list of CPUs, in the form that taskset and /sys/devices/system/cpu use, e.g. "2-5,8".
+* @param list The list.
+* @return The CPUs, in the order that they're listed.
+* @throws std::invalid_argument If the list is empty, or isn't in that form.
+**/
+std::vector<int> affinity::parseCpuList(const std::string& list)
+{
+	std::vector<int> toReturn;
+	std::stringstream listStrm(list);
+	std::string item; // One CPU, or a range of them
+
+	while (std::getline(listStrm, item, ','))
+	{
+		std::size_t dash = item.find('-');
+		std::size_t firstLen = 0, lastLen = 0; // # of characters that std::stoi read
+		int first = -1, last = -1;
+
+		try
+		{
+			first = std::stoi(item.substr(0, dash), &firstLen);
+			last = (dash == std::string::npos ? first : std::stoi(item.substr(dash + 1), &lastLen));
+		}
+
+		catch (std::exception&) // Not a number. Caught below, since first is still negative.
+		{
+		}
+
+		bool whole = (firstLen == item.substr(0, dash).size() && (dash == std::string::npos || lastLen == item.size() - dash - 1)); // Nothing after either number
+
+		if (first < 0 || last < first || last >= CPU_SETSIZE || !whole)
+		{
+			std::ostringstream ess;
+			ess << "affinity::parseCpuList: \"" << item << "\" in the CPU list \"" << list << "\" isn't a CPU # or a range of them, like 2 or 2-5.";
+			throw std::invalid_argument(ess.str());
+		}
+
+		for (int cpu = first; cpu <= last; cpu++)
+		{
+			toReturn.push_back(cpu);
+		}
+	}
+
+	if (toReturn.empty())
+	{
+		throw std::invalid_argument("affinity::parseCpuList: the CPU list is empty.");
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Lets the calling thread run only on some CPUs.
+* @param cpus The CPUs.
+* @return True if the thread was moved, false if the OS refused, e.g. because a CPU doesn't exist.
+**/
+bool affinity::pinThisThread(const std::vector<int>& cpus)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	for (int cpu : cpus)
+	{
+		CPU_SET(cpu, &set);
+	}
+
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/**
+* @desc Lists the CPUs that the calling thread may run on, apart from some. Call it before that thread is pinned, so that it sees every CPU that the process was started with.
+* @param excluded The CPUs to leave out.
+* @return The rest, which is empty if there aren't any.
+**/
+std::vector<int> affinity::allCpusExcept(const std::vector<int>& excluded)
+{
+	std::vector<int> toReturn;
+	cpu_set_t set;
+
+	if (sched_getaffinity(0, sizeof(set), &set) != 0) // Pid 0 is the calling thread, not the whole process
+	{
+		return toReturn;
+	}
+
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+	{
+		if (CPU_ISSET(cpu, &set) && std::find(excluded.cbegin(), excluded.cend(), cpu) == excluded.cend())
+		{
+			toReturn.push_back(cpu);
+		}
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Writes a list of CPUs in the form that parseCpuList() reads, for logging.
+* @param cpus The CPUs.
+* @return The list.
+**/
+std::string affinity::toString(const std::vector<int>& cpus)
+{
+	std::ostringstream toReturn;
+
+	for (std::size_t i = 0; i < cpus.size(); i++)
+	{
+		std::size_t j = i; // The end of a run of consecutive CPUs
+
+		while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+		{
+			++j;
+		}
+
+		toReturn << (i > 0 ? "," : "") << cpus[i];
+
+		if (j > i)
+		{
+			toReturn << "-" << cpus[j];
+			i = j;
+		}
+	}
+
+	return toReturn.str();
+}
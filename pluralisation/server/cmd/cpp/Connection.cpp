@@ -3,22 +3,27 @@
 #include <cstddef> // std::size_t
 
 /* Standard C++ */
+#include <iostream> // std::clog
+#include <chrono> // std::chrono::steady_clock
 #ifdef DEBUG
-#include <iostream> // std::cout, std::cerr
 #include <iomanip> // std::quoted
 #endif
+#include <exception> // std::exception_ptr, std::rethrow_exception
 #include <bitset> // std::bitset
 #include <vector> // std::vector
 #include <algorithm> // std::for_each_n
+#include <string_view> // std::string_view
 
 /* Boost */
 #include <boost/asio/io_context.hpp> // boost::asio::io_context
 #include <boost/asio/buffer.hpp> // boost::asio::buffer, boost::asio::const_buffer
 #include <boost/asio/write.hpp> // boost::asio::async_write
 #include <boost/asio/ip/tcp.hpp> // boost::asio::ip::tcp::socket::shutdown_both
+#include <boost/asio/steady_timer.hpp> // boost::asio::steady_timer
+#include <boost/asio/error.hpp> // boost::asio::error::operation_aborted
 #include <boost/logic/tribool.hpp> // boost::tribool
 #include <boost/logic/tribool_io.hpp> // operator<< for boost::tribool
-#include <boost/tuple/tuple.hpp> // boost::tie, boost::tuples::ignore
+#include <boost/tuple/tuple.hpp> // boost::tie
 #include <boost/system/error_code.hpp> // boost::system::error_code
 
 /* Our headers */
@@ -28,12 +33,22 @@
 #include "Connection.hpp" // Class def
 
 /**
-* @desc Constructs a Connection with the givne io_context & request handler.
-* @param io_context The io_context to use.
-* @param dbConfFilePath Path to configuration file containing DB vars. Used to construct ReqHandler.
+* @desc Constructs a Connection on a shard, whose io_context it runs on and whose handler, reply cache and counters it uses.
+* @param home The shard. The connection keeps it alive, and only ever uses it from its io_context's thread.
+* @param idleTimeout How long to wait for the next request before closing the connection. Zero means forever. Server passes --idletimeout.
+* @param maxReqs The # of requests to answer before closing the connection. Zero means no limit, and 1 closes it after the first reply. Server passes --maxrequests.
 **/
-Connection::Connection(boost::asio::io_context& io_context, std::string dbConfFilePath) : socket(io_context), // Create our socket
-	reqHandler(dbConfFilePath) // Construct our own ReqHandler so that it won't try to maintain a connection to the DB for too long
+Connection::Connection(ShardPtr home, std::chrono::seconds idleTimeout, std::size_t maxReqs) : socket(home->ioc), // Create our socket
+	shard(home),
+	reqHandler(nullptr),
+	idleTimer(home->ioc),
+	idleTimeout(idleTimeout),
+	maxReqs(maxReqs),
+	nReqs(0),
+	keepAlive(true),
+	cacheGen(0),
+	awaitingReply(false),
+	parsing(false)
 {
 	#ifdef DEBUG
 	std::cout << "Connection::Connection running" << std::endl;
@@ -50,13 +65,37 @@ boost::asio::ip::tcp::socket& Connection::getSocket()
 }
 
 /**
-* @desc Starts the first asynchronous operation for the connection.
+* @desc Picks a handler for the connection, and starts its first asynchronous operation. Only call this from its shard's thread.
 **/
 void Connection::start()
 {
 	#ifdef DEBUG
 	std::cout << "Connection::start called." << std::endl;
 	#endif
+	reqHandler = &shard->nextHandler(); // Handlers are built once per DB session, rather than once per Connection
+	++shard->metrics.connections;
+	startRead();
+	#ifdef DEBUG
+	std::cout << "Connection::start ending." << std::endl;
+	#endif
+}
+
+/**
+* @desc Starts reading the next request, and restarts the idle timer.
+**/
+void Connection::startRead()
+{
+	if (idleTimeout.count() > 0)
+	{
+		idleTimer.expires_after(idleTimeout); // Cancels the previous wait, if any
+		idleTimer.async_wait(
+			[lifetime = shared_from_this(), this](const ERROR_CODE& e)
+			{
+				handleIdle(e);
+			}
+		);
+	}
+
 	socket.async_read_some(
 		boost::asio::buffer(
 			buffer
@@ -66,9 +105,26 @@ void Connection::start()
 			handleRead(e, bTrans);
 		}
 	);
-	#ifdef DEBUG
-	std::cout << "Connection::start ending." << std::endl;
-	#endif
+}
+
+/**
+* @desc Closes the connection if the idle timer expired.
+* @param e Set if the wait was cancelled, i.e. if the timer was restarted or stopped.
+**/
+void Connection::handleIdle(const ERROR_CODE& e)
+{
+	/* The timer may have been restarted after this wait completed but before this handler ran, so check the expiry time as well */
+	if (e != boost::asio::error::operation_aborted && idleTimer.expiry() <= boost::asio::steady_timer::clock_type::now())
+	{
+		#ifdef DEBUG
+		std::cout << "Connection::handleIdle: no request within " << idleTimeout.count() << " seconds, closing the connection." << std::endl;
+		#endif
+
+		/* Closing the socket makes the pending read fail, which drops the last reference to this Connection */
+		ERROR_CODE ignoredEc;
+		socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignoredEc);
+		socket.close(ignoredEc);
+	}
 }
 
 /**
@@ -137,113 +193,250 @@ void Connection::handleRead(const ERROR_CODE& e, std::size_t bytesTransferred)
 		<< "Connection::handleRead: size of file " << binReqPath << " after writing is " << FILESYSTEM_SIZE(binReqPath) << std::endl;
 		#endif
 
-		/* Parse a request and check what state the parser is in */
-		boost::tribool result;
-		boost::tie(result, boost::tuples::ignore) = reqParser.parse(
-			req,
-			buffer.data(),
-			buffer.data() + bytesTransferred
-		);
+		if (shard->latency) // Replies are only written once a read completes a request, so the last read before a write is the one that it answers
+		{
+			readAt = std::chrono::steady_clock::now();
+		}
+
+		unparsed = std::string_view(buffer.data(), bytesTransferred); // If the buffer ends part-way through a request, the parser keeps those bytes and finishes the request on the next read
+		outBuf.clear();
+		processRequests();
+	}
+	
+	else
+	{
+		idleTimer.cancel(); // The client closed the connection, or the idle timer did. Either way, the timer mustn't keep us alive.
+
+		#ifdef DEBUG
+		std::cerr << "Connection::handleRead: an error occurred while handling the previous read operation." << std::endl
+		<< "\tError value = " << e.value() << std::endl
+		<< "\tError message = " << std::quoted(e.message()) << std::endl
+		<< "\tThe operation " << (e.failed() ? "failed" : "didn't fail") << std::endl;
+		#endif
+	}
+
+	/*
+	* No new async. ops. are started if an error occurs. Thus, all shared_ptr
+	* references to the connection object will disappear and the object will be
+	* destroyed automatically after this handler returns. The Connection class'
+	* destructor closes the socket.
+	*/
+}
+
+/**
+* @desc Handles every complete request in the unparsed bytes, in the order that they arrived, so that a client can send several without waiting for each reply.
+*	A request's header and noun slices point into buffer, so each one is handled before the next is parsed, and buffer isn't read into again until the replies have been written.
+*	If the handler has to wait for the DB, this returns, and handleReply() calls it again once the reply is ready. Once every request has been handled, the replies are written, or more bytes are read if there were none.
+**/
+void Connection::processRequests()
+{
+	boost::tribool result = true;
+	std::size_t used; // # of bytes of unparsed that the parser used
+	parsing = true;
+
+	while (result && keepAlive && !unparsed.empty()) // Any requests after the last one that this client may send are dropped along with the connection
+	{
+		boost::tie(result, used) = reqParser.parse(req, unparsed);
+		unparsed.remove_prefix(used);
+
+		if (!boost::indeterminate(result)) // A reply is owed now, so the idle timer mustn't close the connection while the DB or the write is slow. startRead() arms it again.
+		{
+			idleTimer.cancel();
+		}
 
 		#ifdef DEBUG
-		std::cout << "Connection::handleRead: parse result was " << result << std::endl;
+		std::cout << "Connection::processRequests: parse result was " << result << ", " << unparsed.size() << " bytes left in the buffer" << std::endl;
 		#endif
 
 		if (result) // The parser successfully parsed an entire request
 		{
 			#ifdef DEBUG
-			std::cout << "Connection::handleRead: the parser successfully parsed an entire request" << std::endl;
-			#endif
-			reqHandler.handleReq(req, rep); // Handle a request - generate a reply according to what the client requested
-			#ifdef DEBUG
-			std::cout << "Connection::handleRead: reply to send is: " << std::endl
-			<< rep << std::endl;
+			std::cout << "Connection::processRequests: the parser successfully parsed an entire request" << std::endl;
 			#endif
-			repBufs = rep.toBuffers(); // Fetch the buffers to write
-			#ifdef DEBUG
-			std::cout << "Connection::handleRead: # of reply buffers = " << repBufs.size() << std::endl
-			<< "Connection::handleRead: reply buffer contents: " << std::endl;
-			unsigned short bufNum = 1;
+			const std::string* cached = (shard->replyCache ? shard->replyCache->find(req.GETCOM_FUNC(), req.getCompactNoun()) : nullptr);
 
-			for (auto buf : repBufs)
+			if (cached) // Answered before, so the handler can be skipped
 			{
-				const char* bufDat = static_cast<const char*>(buf.data());
-				std::size_t bufSiz = buf.size();
-				std::cout << bufNum << ")\t";
+				#ifdef DEBUG
+				std::cout << "Connection::processRequests: found the reply in the cache" << std::endl;
+				#endif
+				outBuf.append(*cached);
+				finishRequest();
+			}
 
-				for (std::size_t i = 0; i < bufSiz; i++)
+			else
+			{
+				std::size_t repStart = outBuf.size(); // Where this reply's bytes will start
+				cacheGen = (shard->replyCache ? shard->replyCache->getGeneration() : 0); // The noun may change while the handler waits for the DB
+				awaitingReply = true;
+				reqHandler->asyncHandleReq(req, rep, [lifetime = shared_from_this(), this, repStart](std::exception_ptr err) // Handle a request - generate a reply according to what the client requested
+					{
+						handleReply(err, repStart);
+					}
+				);
+
+				if (awaitingReply) // The handler is waiting for the DB, and handleReply() will carry on from here
 				{
-					std::cout << bufDat[i];
+					parsing = false;
+					return;
 				}
-
-				std::cout << std::endl;
-				++bufNum;
 			}
-	
-			std::cout << "server::Connection::handleRead: finished writing buffers to cout" << std::endl;
-			#endif
-			boost::asio::async_write(
-				socket,
-				repBufs,
-				[lifetime = shared_from_this(), this](const ERROR_CODE& err, std::size_t bytesTrans)
-				{
-					handleWrite(err, bytesTrans);
-				}
-			);
 		}
 
 		else if (!result) // Malformed request
 		{
 			#ifdef DEBUG
-			std::cout << "Connection::handleRead: the request was malformed." << std::endl;
+			std::cout << "Connection::processRequests: the request was malformed." << std::endl;
 			#endif
 
-			rep = mpp::Reply::stockReply(reqParser.getStatus()); // Generate a stock reply using the error code which the parser identified
-			rep.setContent(""); // Clear the reply's content
-			rep.clearHeaders(); // Clear the reply's headers
-			repBufs = rep.toBuffers();
-			boost::asio::async_write(
-				socket,
-				repBufs,
-				[lifetime = shared_from_this(), this](const ERROR_CODE& err, std::size_t bTrans)
-				{
-					handleWrite(err, bTrans);
-				}
-			);
+			++shard->metrics.badRequests;
+			keepAlive = false; // We can't tell where the next request would start, so close the connection after the error reply
+			rep.setFixed(reqParser.getStatus()); // Send the prebuilt reply for the error code which the parser identified
+			queueReply();
 		}
+	}
+
+	parsing = false;
+
+	if (!outBuf.empty()) // Send every reply in one write
+	{
+		#ifdef DEBUG
+		std::cout << "Connection::processRequests: writing " << outBuf.size() << " bytes of replies" << std::endl;
+		#endif
 
-		else // Need more data
+		boost::asio::async_write(
+			socket,
+			boost::asio::buffer(outBuf),
+			[lifetime = shared_from_this(), this](const ERROR_CODE& err, std::size_t bTrans)
+			{
+				handleWrite(err, bTrans);
+			}
+		);
+	}
+
+	else if (keepAlive) // Need more data
+	{
+		#ifdef DEBUG
+		std::cout << "Connection::processRequests: we need more data" << std::endl;
+		#endif
+
+		socket.async_read_some(
+			boost::asio::buffer(buffer),
+			[lifetime = shared_from_this(), this](const ERROR_CODE& err, std::size_t bTrans)
+			{
+				handleRead(err, bTrans);
+			}
+		);
+	}
+
+	else // The only request failed, so there's nothing to send
+	{
+		idleTimer.cancel();
+		ERROR_CODE ignoredEc;
+		socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignoredEc);
+	}
+}
+
+/**
+* @desc Handles completion of a request handler, possibly after it waited for the DB.
+* @param err Set if the noun couldn't be looked up, in which case there's no reply, and the connection is closed once the earlier replies have been written.
+* @param repStart Where the reply's bytes start in outBuf.
+**/
+void Connection::handleReply(std::exception_ptr err, std::size_t repStart)
+{
+	awaitingReply = false;
+
+	if (err)
+	{
+		try
 		{
-			#ifdef DEBUG
-			std::cout << "Connection::handleRead: we need more data" << std::endl;
-			#endif
+			std::rethrow_exception(err);
+		}
 
-			socket.async_read_some(
-				boost::asio::buffer(buffer),
-				[lifetime = shared_from_this(), this](const ERROR_CODE& err, std::size_t bTrans)
-				{
-					handleRead(err, bTrans);
-				}
-			);
+		catch (std::exception& e) // There's no status for a server error, so the client can only tell from the connection closing
+		{
+			std::clog << "Connection::handleReply: couldn't answer a request: " << e.what() << std::endl;
 		}
+
+		++shard->metrics.failedLookups;
+		keepAlive = false;
+		rep.clearHeaders();
+		rep.setContent("");
+		rep.setStatus(mpp::Reply::invalid);
+		req.clear();
 	}
-	
+
 	else
 	{
-		#ifdef DEBUG
-		std::cerr << "Connection::handleRead: an error occurred while handling the previous read operation." << std::endl
-		<< "\tError value = " << e.value() << std::endl
-		<< "\tError message = " << std::quoted(e.message()) << std::endl
-		<< "\tThe operation " << (e.failed() ? "failed" : "didn't fail") << std::endl;
-		#endif
+		queueReply();
+
+		if (shard->replyCache) // Every reply that the handler produces depends only on the verb and the noun, so the negative ones can be cached too
+		{
+			shard->replyCache->insert(req.GETCOM_FUNC(), req.getCompactNoun(), std::string_view(outBuf).substr(repStart), cacheGen); // Skipped if the cache was invalidated while the handler waited
+		}
+
+		finishRequest();
 	}
 
-	/*
-	* No new async. ops. are started if an error occurs. Thus, all shared_ptr
-	* references to the connection object will disappear and the object will be
-	* destroyed automatically after this handler returns. The Connection class'
-	* destructor closes the socket.
-	*/
+	if (!parsing) // Called by the DB session, so processRequests() has already returned
+	{
+		processRequests();
+	}
+}
+
+/**
+* @desc Counts an answered request, and clears it for the next one.
+**/
+void Connection::finishRequest()
+{
+	++nReqs;
+	++shard->metrics.requests;
+	keepAlive = (maxReqs == 0 || nReqs < maxReqs); // Leave the connection open for another request, unless this client has had its share
+	req.clear();
+}
+
+/**
+* @desc Appends the current reply to the replies waiting to be written, then clears it for the next request.
+**/
+void Connection::queueReply()
+{
+	const std::vector<boost::asio::const_buffer>& repBufs = rep.toBuffers(); // Fetch the buffers to write. A fixed reply is a single buffer of prebuilt bytes.
+
+	#ifdef DEBUG
+	std::cout << "Connection::queueReply: reply to send is: " << std::endl
+	<< rep << std::endl
+	<< "Connection::queueReply: # of reply buffers = " << repBufs.size() << std::endl
+	<< "Connection::queueReply: reply buffer contents: " << std::endl;
+	unsigned short bufNum = 1;
+
+	for (auto buf : repBufs)
+	{
+		const char* bufDat = static_cast<const char*>(buf.data());
+		std::size_t bufSiz = buf.size();
+		std::cout << bufNum << ")\t";
+
+		for (std::size_t i = 0; i < bufSiz; i++)
+		{
+			std::cout << bufDat[i];
+		}
+
+		std::cout << std::endl;
+		++bufNum;
+	}
+
+	std::cout << "server::Connection::queueReply: finished writing buffers to cout" << std::endl;
+	#endif
+
+	/* The buffers point into rep, which is about to be reused, so copy them out */
+	for (const boost::asio::const_buffer& buf : repBufs)
+	{
+		outBuf.append(static_cast<const char*>(buf.data()), buf.size());
+	}
+
+	/* clearHeaders() and setContent("") keep rep's storage, so the next reply doesn't allocate */
+	rep.clearHeaders();
+	rep.setContent("");
+	rep.setStatus(mpp::Reply::invalid);
 }
 
 /**
@@ -256,13 +449,29 @@ void Connection::handleWrite(const ERROR_CODE& e, std::size_t bytesTransferred)
 	std::cout << "Connection::handleWrite: wrote " << bytesTransferred << " bytes" << std::endl;
 	#endif
 
-	if (!e) // No error
+	if (!e && shard->latency)
+	{
+		shard->latency->record(std::chrono::steady_clock::now() - readAt);
+	}
+
+	if (!e && keepAlive) // Wait for the client's next request on the same socket
+	{
+		#ifdef DEBUG
+		std::cout << "Connection::handleWrite: no error occurred. Keeping the connection alive after " << nReqs << " requests." << std::endl;
+		#endif
+
+		/* req and rep were cleared as each reply was queued. The parser isn't reset, since it may hold the start of the client's next request. */
+		startRead();
+	}
+
+	else if (!e) // No error, but this was the last request
 	{
 		#ifdef DEBUG
 		std::cout << "Connection::handleWrite: no error occurred." << std::endl;
 		#endif
 
 		/* Close the connection gracefully */
+		idleTimer.cancel();
 		ERROR_CODE ignoredEc;
 		socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignoredEc);
 
@@ -273,6 +482,8 @@ void Connection::handleWrite(const ERROR_CODE& e, std::size_t bytesTransferred)
 
 	else
 	{
+		idleTimer.cancel();
+
 		#ifdef DEBUG
 		std::cerr << "Connection::handleWrite: an error occurred while handling the previous write operation." << std::endl
 		<< "\tError value = " << e.value() << std::endl
@@ -282,9 +493,9 @@ void Connection::handleWrite(const ERROR_CODE& e, std::size_t bytesTransferred)
 	}
 
 	/*
-	* No new async. ops. are started. Thus, all shared_ptr references to the
-	* Connection object will disappear, and the object will be destroyed
-	* automatically after this handler returns. The connection class'
-	* (automatic) destructor closes the socket.
+	* Unless the connection is being kept alive, no new async. ops. are started.
+	* Thus, all shared_ptr references to the Connection object will disappear,
+	* and the object will be destroyed automatically after this handler returns.
+	* The connection class' (automatic) destructor closes the socket.
 	*/
 }
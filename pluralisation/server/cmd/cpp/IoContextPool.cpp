@@ -4,9 +4,7 @@
 /* STL */
 #include <stdexcept> // std::runtime_error
 #include <vector> // std::vector
-#ifdef DEBUG
-#include <iostream> // std::cout
-#endif
+#include <iostream> // std::cout, std::clog
 #include <sstream> // std::stringstream
 
 /* Boost */
@@ -16,13 +14,15 @@
 #include "bosmacros/shared_ptr.hpp" // SHARED_PTR macro
 #include "bosmacros/thread.hpp" // THREAD_CLASS macro
 #include "bosmacros/bind.hpp" // BIND_FUNCTION macro
+#include "Affinity.hpp" // affinity::pinThisThread, affinity::toString
 #include "IoContextPool.hpp" // Class def
 
 /**
 * @desc Constructor. Creates a pool of the specified size.
 * @param poolSize The size of the pool.
+* @param cpus The CPUs that each io_context's thread may run on, in the pool's order. Empty lets them run anywhere.
 **/
-IoContextPool::IoContextPool(std::size_t poolSize) : nextIoCon(0)
+IoContextPool::IoContextPool(std::size_t poolSize, std::vector<std::vector<int>> cpus) : nextIoCon(0), threadCpus(cpus)
 {
 	#ifdef DEBUG
 	std::cout << "IoContextPool::IoContextPool: pool size = " << poolSize << std::endl;
@@ -34,6 +34,13 @@ IoContextPool::IoContextPool(std::size_t poolSize) : nextIoCon(0)
 		ess << "IoContextPool::IoContextPool(std::size_t poolSize): pool size (" << poolSize << ") is <= 0.";
 		throw std::runtime_error(ess.str());
 	}
+
+	if (!threadCpus.empty() && threadCpus.size() != poolSize)
+	{
+		std::stringstream ess;
+		ess << "IoContextPool::IoContextPool(std::size_t poolSize, std::vector<std::vector<int>> cpus): " << cpus.size() << " CPU sets were given for " << poolSize << " threads.";
+		throw std::runtime_error(ess.str());
+	}
 	
 	/*
 	* Give all the io_contexts work to do so that their run() f'ns won't exit until
@@ -72,7 +79,7 @@ void IoContextPool::run()
 	#endif
 
 	/* Create the threads */
-	for (auto ptr : ioContexts)
+	for (std::size_t i = 0; i < ioContexts.size(); i++)
 	{
 		SHARED_PTR<THREAD_CLASS> thread(
 			new THREAD_CLASS(
@@ -80,8 +87,13 @@ void IoContextPool::run()
 					&boost::asio::io_context::run,
 					ptr
 				)*/
-				[&ptr]() // Lambda that takes the pointer by reference
+				[ptr = ioContexts[i], this, i]() // Lambda that takes its own copy of the pointer, since the loop moves on before the thread starts
 				{
+					if (!threadCpus.empty() && !affinity::pinThisThread(threadCpus[i])) // Pinned by the thread itself, before it touches any of its io_context's state
+					{
+						std::clog << "IoContextPool::run: couldn't pin thread #" << (i + 1) << " to CPUs " << affinity::toString(threadCpus[i]) << ", so it may run on any of them" << std::endl;
+					}
+
 					ptr->run(); // Run the I/O context
 				}
 			)
@@ -130,11 +142,23 @@ void IoContextPool::stop()
 * @return A reference to an io_context that can be used.
 **/
 boost::asio::io_context& IoContextPool::getIoc()
+{
+	std::size_t ignoredIndex;
+	return getIoc(ignoredIndex);
+}
+
+/**
+* @desc Fetches an io_context to use, along with its position in the pool, so that per-io_context state can be kept alongside it.
+* @param index Set to the io_context's index, from 0 to size() - 1.
+* @return A reference to an io_context that can be used.
+**/
+boost::asio::io_context& IoContextPool::getIoc(std::size_t& index)
 {
 	/* Use a round-robin scheme to choose the next io_context to use */
 	#ifdef DEBUG
 	std::cout << "IoContextPool::getIoc: current index is " << nextIoCon << std::endl;
 	#endif
+	index = nextIoCon;
 	boost::asio::io_context& ioc = *ioContexts.at(nextIoCon);
 	nextIoCon = (nextIoCon + 1) % ioContexts.size(); // Increment index, but reset to 0 if it passes the size of the vector
 	#ifdef DEBUG
@@ -142,3 +166,22 @@ boost::asio::io_context& IoContextPool::getIoc()
 	#endif
 	return ioc;
 }
+
+/**
+* @desc Fetches the io_context at a position in the pool, e.g. to post work to a particular thread.
+* @param index The io_context's index, from 0 to size() - 1.
+* @return A reference to the io_context.
+**/
+boost::asio::io_context& IoContextPool::at(std::size_t index)
+{
+	return *ioContexts.at(index);
+}
+
+/**
+* @desc Fetches the # of io_contexts in the pool.
+* @return The pool's size.
+**/
+std::size_t IoContextPool::size() const
+{
+	return ioContexts.size();
+}
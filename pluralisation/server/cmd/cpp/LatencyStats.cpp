@@ -0,0 +1,121 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <cmath> // std::ceil
+
+/* STL */
+#include <chrono> // std::chrono::nanoseconds
+#include <algorithm> // std::max, std::min
+
+/* Our headers */
+#include "LatencyStats.hpp" // Class def'n
+
+/**
+* @desc Constructor. Makes an empty histogram.
+**/
+LatencyStats::LatencyStats() : counts(), n(0), largest(0)
+{
+}
+
+/**
+* @desc Counts a latency.
+* @param took The latency.
+**/
+void LatencyStats::record(std::chrono::nanoseconds took)
+{
+	std::uint64_t ns = (took.count() > 0 ? took.count() : 0);
+	++counts[bucketOf(ns)];
+	++n;
+	largest = std::max(largest, ns);
+}
+
+/**
+* @desc Adds another histogram's counts to this one's.
+* @param other The other histogram.
+**/
+void LatencyStats::merge(const LatencyStats& other)
+{
+	for (std::size_t b = 0; b < LATENCYBUCKETS; b++)
+	{
+		counts[b] += other.counts[b];
+	}
+
+	n += other.n;
+	largest = std::max(largest, other.largest);
+}
+
+/**
+* @desc Fetches the # of latencies counted.
+* @return The count.
+**/
+std::uint64_t LatencyStats::count() const
+{
+	return n;
+}
+
+/**
+* @desc Finds a percentile.
+* @param q The fraction of latencies that must be at most the result, from 0 to 1, e.g. 0.99 for the 99th percentile.
+* @return The top of the bucket that the percentile falls in, or zero if nothing has been counted.
+**/
+std::chrono::nanoseconds LatencyStats::percentile(double q) const
+{
+	std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * n))); // How many latencies must be at most the result
+	std::uint64_t seen = 0;
+
+	for (std::size_t b = 0; b < LATENCYBUCKETS && n > 0; b++)
+	{
+		seen += counts[b];
+
+		if (seen >= rank)
+		{
+			return std::chrono::nanoseconds(std::min(bucketTop(b), largest)); // The top of the last bucket may be well past anything that was seen
+		}
+	}
+
+	return std::chrono::nanoseconds(largest);
+}
+
+/**
+* @desc Fetches the largest latency counted.
+* @return The latency.
+**/
+std::chrono::nanoseconds LatencyStats::max() const
+{
+	return std::chrono::nanoseconds(largest);
+}
+
+/**
+* @desc Works out which bucket a latency goes in.
+* @param ns The latency, in ns.
+* @return The bucket's index.
+**/
+std::size_t LatencyStats::bucketOf(std::uint64_t ns)
+{
+	if (ns < 16) // One bucket per ns
+	{
+		return ns;
+	}
+
+	std::size_t e = 63 - __builtin_clzll(ns); // The top bit's position, at least 4
+	std::size_t sub = (ns >> (e - 3)) & 0x7; // The 3 bits below it
+	return 16 + (e - 4) * 8 + sub;
+}
+
+/**
+* @desc Works out the largest latency that goes in a bucket.
+* @param b The bucket's index.
+* @return The latency, in ns.
+**/
+std::uint64_t LatencyStats::bucketTop(std::size_t b)
+{
+	if (b < 16)
+	{
+		return b;
+	}
+
+	std::size_t e = (b - 16) / 8 + 4;
+	std::uint64_t sub = (b - 16) % 8;
+	std::uint64_t width = static_cast<std::uint64_t>(1) << (e - 3);
+	return ((8 + sub) << (e - 3)) + width - 1;
+}
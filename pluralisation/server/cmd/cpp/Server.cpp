@@ -1,33 +1,98 @@
 /* C++ versions of C headers */
-#include <csignal> // SIGINT, SIGTERM, SIGQUIT
+#include <csignal> // SIGINT, SIGTERM, SIGQUIT, SIGHUP
+
+/* C headers */
+#include <sys/socket.h> // SOL_SOCKET, SO_REUSEPORT
 
 /* STL */
 #include <sstream> // std::stringstream
 #include <string> // std::string
-#ifdef DEBUG
+#include <memory> // std::make_shared
+#include <algorithm> // std::max
 #include <iostream> // std::clog
+#include <thread> // std::thread, std::this_thread::sleep_for
+#include <chrono> // std::chrono::milliseconds, std::chrono::microseconds
+#include <exception> // std::exception
+#include <vector> // std::vector
+#include <unordered_map> // std::unordered_map
+#include <mutex> // std::lock_guard, std::unique_lock
+#ifdef DEBUG
 #include <iomanip> // std::quoted
 #endif
 
 /* Our headers */
 #include "bosmacros/bind.hpp" // Defines the macro BIND_FUNCTION, that resolves to either boost::bind or std::bind
 #include "bosmacros/error_code.hpp" // ERROR_CODE macro
+#include "mpp/data/DBInfo.hpp" // Needed to load the lexicon
+#include "bosmacros/filesystem.hpp" // FILESYSTEM_PATH macro
+#include "mpp/data/Lexicon.hpp" // In-memory snapshot of the noun tables
+#include "mpp/data/LiveLexicon.hpp" // Publishes the current snapshot to every thread
+#include "mpp/data/AsyncDBSession.hpp" // Non-blocking DB sessions, each shared by the Connections on one io_context
+#include "mpp/data/DBSession.hpp" // Reads the change log
+#include "mpp/data/NounFacts.hpp" // A changed noun's facts
+#include "mpp/data/BloomFilter.hpp" // Turns away nouns that the DB knows nothing about
+#include "mpp/ReplyCache.hpp" // Cache of ready-to-send replies
+#include "Affinity.hpp" // Keeps threads on particular CPUs
+#include "LatencyStats.hpp" // Histogram of how long replies take
+#include "Shard.hpp" // The state of one io_context's thread
 #include "Connection.hpp" // Connection class
 #include "Server.hpp" // Class definition
 
+namespace
+{
+	#ifdef SO_REUSEPORT
+	typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> ReusePort; // Asio has no option for this, but takes any socket option in this form
+	#endif
+
+	/**
+	* @desc Works out which CPUs each io_context's thread may run on.
+	* @param cpuList The CPUs to run the threads on. Empty lets them run anywhere.
+	* @param numThreads The # of threads.
+	* @param share If true, every thread may run on any of the CPUs. Otherwise each gets one, in order, going round again if there are more threads than CPUs.
+	* @return The CPUs for each thread, or nothing if they aren't pinned.
+	* @throws std::invalid_argument If cpuList isn't a valid list of CPUs.
+	**/
+	std::vector<std::vector<int>> threadCpus(const std::string& cpuList, std::size_t numThreads, bool share)
+	{
+		std::vector<std::vector<int>> toReturn;
+
+		if (!cpuList.empty())
+		{
+			std::vector<int> cpus = affinity::parseCpuList(cpuList);
+
+			for (std::size_t i = 0; i < numThreads; i++)
+			{
+				toReturn.push_back(share ? cpus : std::vector<int>(1, cpus[i % cpus.size()]));
+			}
+		}
+
+		return toReturn;
+	}
+}
+
 /**
 * @desc Creates a server that listens on the given port, and uses a pool of io_contexts of the given size.
 * @param port Port to listen on.
 * @param numThreads # of threads to use.
 * @param progName The program's name.
 * @param dbConfPath The path to the DB config file.
+* @param options Everything else that can be set from the command line.
 **/
-Server::Server(const std::string& address, int port, std::size_t numThreads, std::string progName, std::string dbConfPath)
-	: 	iocp(numThreads),
+Server::Server(const std::string& address, int port, std::size_t numThreads, std::string progName, std::string dbConfPath, const Options& options)
+	: 	iocp(numThreads, threadCpus(options.cpuList, numThreads, options.shareCpus)),
 		signals(iocp.getIoc()),
-		acceptor(iocp.getIoc()),
+		reloadSignals(iocp.getIoc()),
+		acceptPerThread(options.reusePort),
 		pName(progName),
-		dbCnfFlPth(dbConfPath)
+		dbCnfFlPth(dbConfPath),
+		lexFile(options.lexiconFile),
+		connIdleTimeout(options.idleTimeout),
+		connMaxReqs(options.maxReqs),
+		keyFilterBits(0),
+		reloading(false),
+		refreshEvery(0),
+		lastChange(0),
+		stopping(false)
 		#ifdef DEBUG
 		,sigNames {
 			{SIGINT, "SIGINT"},
@@ -36,6 +101,112 @@ Server::Server(const std::string& address, int port, std::size_t numThreads, std
 		}
 		#endif
 {
+	for (std::size_t i = 0; i < iocp.size(); i++) // Each thread gets its own cache shard, counters and, below, DB sessions and handlers, so that answering a request never needs a lock
+	{
+		shards.push_back(ShardPtr(new Shard(iocp.at(i), i, (options.cacheSize > 0 ? std::max<std::size_t>(1, options.cacheSize / iocp.size()) : 0), options.measureLatency)));
+	}
+
+	if (!options.lexiconFile.empty()) // Map the compiled tables. This needs neither the DB nor any parsing, and every server process on the machine shares the file's pages.
+	{
+		lexicon = std::make_shared<mpp::data::LiveLexicon>(std::make_shared<const mpp::data::Lexicon>(FILESYSTEM_PATH(options.lexiconFile)), iocp.size());
+		#ifdef DEBUG
+		std::cout << pName << ":Server::Server: mapped " << lexicon->current()->size() << " nouns from " << options.lexiconFile << std::endl;
+		#endif
+	}
+
+	else if (options.useLexicon) // Load the noun tables before accepting any connections, so that no request ever waits for them
+	{
+		if (options.refreshInterval > 0)
+		{
+			openChangeLog(options.refreshInterval);
+		}
+
+		lexicon = std::make_shared<mpp::data::LiveLexicon>(std::make_shared<const mpp::data::Lexicon>(mpp::data::DBInfo(dbCnfFlPth)), iocp.size());
+		#ifdef DEBUG
+		std::cout << pName << ":Server::Server: loaded " << lexicon->current()->size() << " nouns into the lexicon" << std::endl;
+		#endif
+	}
+
+	else // Connect to the DB now, rather than while handling the first requests. A thread never waits for its sessions, so by default each gets one, which queues its lookups.
+	{
+		mpp::data::DBInfo dbInfo(dbCnfFlPth);
+		std::size_t perThread = options.dbSessions / iocp.size();
+		std::size_t extra = options.dbSessions % iocp.size(); // The first this many threads get one more
+		std::size_t opened = 0;
+
+		for (const ShardPtr& shard : shards)
+		{
+			std::size_t n = std::max<std::size_t>(1, perThread + (shard->index < extra ? 1 : 0));
+
+			for (std::size_t j = 0; j < n; j++)
+			{
+				shard->dbSessions.push_back(std::make_shared<mpp::data::AsyncDBSession>(shard->ioc, dbInfo, options.batchSize, std::chrono::microseconds(options.batchWindow)));
+			}
+
+			opened += n;
+		}
+
+		if (options.dbSessions > 0 && opened != options.dbSessions) // Every thread needs at least one
+		{
+			std::clog << pName << ": opened " << opened << " DB sessions rather than " << options.dbSessions << ", so that each of the " << iocp.size() << " threads has one" << std::endl;
+		}
+
+		#ifdef DEBUG
+		std::cout << pName << ":Server::Server: opened " << opened << " DB sessions for " << iocp.size() << " threads" << std::endl;
+		#endif
+
+		if (options.refreshInterval > 0 && (options.filterBits > 0 || options.cacheSize > 0)) // Nouns added to the DB are added to the filter, and the replies about changed nouns dropped, as they're logged, rather than only on SIGHUP
+		{
+			openChangeLog(options.refreshInterval);
+		}
+
+		if (options.filterBits > 0 || changeSess)
+		{
+			mpp::data::DBSession keySess(dbInfo);
+
+			if (options.filterBits > 0) // Most lookups of plurals, and of words that aren't nouns, find nothing, and the filter answers those without a query
+			{
+				keyFilterBits = options.filterBits;
+				publishKeyFilter(buildKeyFilter(keySess));
+				std::clog << pName << ": built a key filter of " << keyFilter->size() << " nouns and plurals in " << keyFilter->bytes() << " bytes" << std::endl;
+			}
+
+			if (changeSess) // Needed to drop the replies about a plural that a change takes away
+			{
+				knownPlurals = keySess.exceptionalPlurals();
+			}
+		}
+	}
+
+	for (const ShardPtr& shard : shards)
+	{
+		shard->makeHandlers(lexicon);
+	}
+
+	if (options.refreshInterval > 0 && !changeSess)
+	{
+		std::clog << pName << ": not polling the change log, since nothing read from the DB is being kept: there's no lexicon, key filter or reply cache" << std::endl;
+	}
+
+	if (options.isolateCpus && options.cpuList.empty())
+	{
+		std::clog << pName << ": not isolating any CPUs, since no CPUs were given for the io_context threads" << std::endl;
+	}
+
+	else if (options.isolateCpus)
+	{
+		otherCpus = affinity::allCpusExcept(affinity::parseCpuList(options.cpuList)); // run() hasn't pinned this thread yet, so it still has the process's CPUs
+
+		if (otherCpus.empty())
+		{
+			std::clog << pName << ": not isolating CPUs " << options.cpuList << ", since the other threads would have nowhere left to run" << std::endl;
+		}
+	}
+
+	#ifdef DEBUG
+	std::cout << pName << ":Server::Server: created " << shards.size() << " shards" << std::endl;
+	#endif
+
 	/*
 	* Register to handle signals that indicate that the server should exit.
 	* It is safe to register for the same signal multiple times in a program,
@@ -55,6 +226,9 @@ Server::Server(const std::string& address, int port, std::size_t numThreads, std
 		}
 	);
 
+	reloadSignals.add(SIGHUP);
+	waitForReload();
+
 	#ifdef DEBUG
 	std::cout << pName << ":Server::Server: registered signals" << std::endl;
 	#endif
@@ -67,30 +241,58 @@ Server::Server(const std::string& address, int port, std::size_t numThreads, std
 	std::cout << pName << ":Server::Server: port # stringstream's contents are " << std::quoted(portNumSS.str()) << std::endl;
 	#endif
 
-	/* Open the acceptor with the option to reuse the address */
-	boost::asio::ip::tcp::resolver resolver(acceptor.get_executor());
-	boost::asio::ip::tcp::endpoint endPoint = *(resolver.resolve(address, portNumSS.str()).begin()); // Use the first endpoint found that corresponds to the given address & port #
-	acceptor.open(endPoint.protocol());
-	#ifdef DEBUG
-	if (acceptor.is_open())
+	#ifndef SO_REUSEPORT
+	if (acceptPerThread)
 	{
-		std::cout << pName << ":Server::Server: listening on " << address << ":" << port << std::endl
-		<< "\tusing " << numThreads << " threads" << std::endl;
+		std::clog << pName << ": SO_REUSEPORT isn't supported here, so one thread will accept every connection" << std::endl;
+		acceptPerThread = false;
 	}
+	#endif
 
-	else
+	/* Open the acceptors with the option to reuse the address */
+	boost::asio::ip::tcp::resolver resolver(iocp.at(0));
+	boost::asio::ip::tcp::endpoint endPoint = *(resolver.resolve(address, portNumSS.str()).begin()); // Use the first endpoint found that corresponds to the given address & port #
+	std::size_t nAcceptors = (acceptPerThread ? iocp.size() : 1);
+	acceptors.reserve(nAcceptors); // Never moved once they're listening
+
+	for (std::size_t i = 0; i < nAcceptors; i++)
 	{
-		std::cout << pName << ":Server::Server: acceptor failed to open." << std::endl;
+		acceptors.emplace_back(acceptPerThread ? iocp.at(i) : iocp.getIoc()); // Each thread accepts its own connections, so that they never leave the core that they arrived on
+		boost::asio::ip::tcp::acceptor& acceptor = acceptors.back();
+		acceptor.open(endPoint.protocol());
+		#ifdef DEBUG
+		if (acceptor.is_open())
+		{
+			std::cout << pName << ":Server::Server: listening on " << address << ":" << port << " with acceptor #" << i << std::endl
+			<< "\tusing " << numThreads << " threads" << std::endl;
+		}
+
+		else
+		{
+			std::cout << pName << ":Server::Server: acceptor #" << i << " failed to open." << std::endl;
+		}
+		#endif
+		acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+		#ifdef SO_REUSEPORT
+		if (acceptPerThread) // Lets every acceptor bind to the port. The kernel then hashes each new connection to one of them.
+		{
+			acceptor.set_option(ReusePort(true));
+		}
+		#endif
+		acceptor.bind(endPoint);
+		acceptor.listen();
 	}
-	#endif
-	acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-	acceptor.bind(endPoint);
-	acceptor.listen();
+
+	newConns.resize(nAcceptors);
 
 	#ifdef DEBUG
 	std::cout << pName << ":Server::Server: calling startAccept." << std::endl;
 	#endif
-	startAccept();
+
+	for (std::size_t i = 0; i < nAcceptors; i++)
+	{
+		startAccept(i);
+	}
 }
 
 /**
@@ -102,43 +304,578 @@ void Server::handleStop()
 	std::cout << pName << ":Server::handleStop called" << std::endl;
 	#endif
 	iocp.stop();
+
+	{
+		std::lock_guard<std::mutex> lock(refreshMtx);
+		stopping = true;
+	}
+
+	refreshCv.notify_all(); // Joined by run(), since this runs on one of the pool's threads
+}
+
+/**
+* @desc Destructor. Waits for a lexicon reload or refresh that's still running.
+**/
+Server::~Server()
+{
+	if (reloader.joinable())
+	{
+		reloader.join();
+	}
+
+	stopRefresher();
+}
+
+/**
+* @desc Waits for the next SIGHUP, asynchronously.
+**/
+void Server::waitForReload()
+{
+	reloadSignals.async_wait([this](const ERROR_CODE& e, int sigNo)
+		{
+			if (!e)
+			{
+				handleReload();
+				waitForReload(); // SIGHUP can be sent any number of times
+			}
+		}
+	);
+}
+
+/**
+* @desc Handles SIGHUP by starting a lexicon reload in the background, unless one is already running. If requests are answered from the DB, the reload rebuilds the key filter and clears the reply caches instead, if there are any.
+**/
+void Server::handleReload()
+{
+	if (!lexicon && keyFilterBits == 0 && !shards.front()->replyCache)
+	{
+		std::clog << pName << ": ignoring SIGHUP, since every request is answered from the DB, and no replies are cached" << std::endl;
+	}
+
+	else if (reloading.exchange(true))
+	{
+		std::clog << pName << ": ignoring SIGHUP, since the last one is still being handled" << std::endl;
+	}
+
+	else
+	{
+		if (reloader.joinable()) // The last reload cleared reloading just before it returned, so this doesn't wait
+		{
+			reloader.join();
+		}
+
+		reloader = std::thread([this]()
+			{
+				if (!otherCpus.empty()) // Started by an io_context thread, so it would otherwise share that thread's CPU
+				{
+					affinity::pinThisThread(otherCpus);
+				}
+
+				reloadLexicon();
+			}
+		);
+	}
 }
 
 /**
-* @desc Runs the server's io_context loop.
+* @desc Builds a new lexicon from wherever the first one came from, and publishes it. If requests are answered from the DB, rebuilds the key filter instead, if there is one. Runs on the reloader thread, so that no io_context waits for it.
+*	Once it's published, every thread's reply cache is cleared, and the old lexicon is freed as soon as the last request using it finishes.
+**/
+void Server::reloadLexicon()
+{
+	if (!lexicon)
+	{
+		try
+		{
+			std::lock_guard<std::mutex> rebuild(rebuildMtx);
+
+			if (keyFilterBits > 0 || changeSess) // With only a reply cache, and no refresher, there's nothing to reread
+			{
+				mpp::data::DBInfo info(dbCnfFlPth);
+				mpp::data::DBSession keySess(info);
+
+				if (keyFilterBits > 0)
+				{
+					publishKeyFilter(buildKeyFilter(keySess)); // Every session stops using the old filter before its next lookup, and the last one to drop it frees it
+				}
+
+				if (changeSess)
+				{
+					knownPlurals = keySess.exceptionalPlurals();
+				}
+			}
+
+			for (const ShardPtr& shard : shards) // The DB may have changed in ways that the change log didn't cover
+			{
+				shard->send([](Shard& s)
+					{
+						if (s.replyCache)
+						{
+							s.replyCache->clear();
+						}
+					}
+				);
+			}
+
+			if (keyFilter)
+			{
+				std::clog << pName << ": rebuilt the key filter, which now has " << keyFilter->size() << " nouns and plurals" << std::endl;
+			}
+
+			else
+			{
+				std::clog << pName << ": cleared the reply cache" << std::endl;
+			}
+		}
+
+		catch (std::exception& e) // Keep using the old filter and cache
+		{
+			std::clog << pName << ": couldn't reread the DB, so the old key filter and cached replies are still in use: " << e.what() << std::endl;
+		}
+
+		reloading = false;
+		return;
+	}
+
+	try
+	{
+		std::lock_guard<std::mutex> rebuild(rebuildMtx); // The refresher can apply its changes to this lexicon once it's published. Changes made while it's built are applied again, which does no harm.
+		std::shared_ptr<const mpp::data::Lexicon> next = (lexFile.empty() ?
+			std::make_shared<const mpp::data::Lexicon>(mpp::data::DBInfo(dbCnfFlPth)) :
+			std::make_shared<const mpp::data::Lexicon>(FILESYSTEM_PATH(lexFile))
+		);
+		lexicon->publish(next);
+
+		/* Cached replies were made from the old lexicon. Each cache is cleared by its own thread, after any request there that pinned the old lexicon. */
+		for (const ShardPtr& shard : shards)
+		{
+			shard->send([](Shard& s)
+				{
+					if (s.replyCache)
+					{
+						s.replyCache->clear();
+					}
+				}
+			);
+		}
+
+		while (lexicon->reclaim() > 0) // A request only pins the lexicon while it looks a noun up, so this is never a long wait
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		std::clog << pName << ": reloaded the lexicon, which now has " << next->size() << " nouns" << std::endl;
+	}
+
+	catch (std::exception& e) // Keep answering from the old lexicon
+	{
+		std::clog << pName << ": couldn't reload the lexicon, so the old one is still in use: " << e.what() << std::endl;
+	}
+
+	reloading = false;
+}
+
+/**
+* @desc Polls the change log every refreshEvery until the server stops. Runs on the refresher thread.
+**/
+void Server::pollChanges()
+{
+	std::unique_lock<std::mutex> lock(refreshMtx);
+
+	while (!refreshCv.wait_for(lock, refreshEvery, [this]() { return stopping; }))
+	{
+		lock.unlock(); // handleStop() mustn't wait for a poll
+		applyChanges();
+		lock.lock();
+	}
+}
+
+/**
+* @desc Reads the change log since the last poll. If any nouns have changed, fetches their current facts, publishes a copy of the lexicon with them applied, and drops the replies about them from every thread's reply cache.
+*	If requests are answered from the DB, the changed nouns and their plurals are added to a copy of the key filter instead, if there is one, and their replies are dropped.
+**/
+void Server::applyChanges()
+{
+	try
+	{
+		std::vector<std::string> nouns; // Every noun that has changed since the last poll
+		std::uint64_t readUpTo = lastChange; // Only made lastChange once the changes have been published, so that a failure retries them
+
+		while (changeSess->changedNouns(readUpTo, nouns) == LEXICONCHANGESBATCH) // A bulk update can leave more rows than one read returns
+		{
+		}
+
+		if (nouns.empty())
+		{
+			return;
+		}
+
+		std::vector<mpp::data::NounFacts> changes;
+
+		for (const std::string& noun : nouns) // Read after the log, so that the facts are at least as new as the last change read
+		{
+			changes.push_back(changeSess->getFacts(noun));
+		}
+
+		std::lock_guard<std::mutex> rebuild(rebuildMtx);
+
+		if (!lexicon) // The key filter, if there is one, can't forget a noun, so only the added ones matter. The replies about the changed nouns are dropped too, since the cache can't tell that the DB has changed.
+		{
+			std::shared_ptr<mpp::data::BloomFilter> next = (keyFilter ? std::make_shared<mpp::data::BloomFilter>(*keyFilter) : nullptr);
+			std::vector<std::string> stale(nouns);
+
+			for (const mpp::data::NounFacts& nf : changes)
+			{
+				if (nf.exists && next)
+				{
+					next->insert(nf.noun);
+				}
+
+				/* The DB has already changed, so the plurals that the noun had come from what was read before */
+				std::unordered_map<std::string, std::vector<std::string>>::iterator old = knownPlurals.find(nf.noun);
+
+				if (old != knownPlurals.end())
+				{
+					stale.insert(stale.end(), old->second.cbegin(), old->second.cend());
+					knownPlurals.erase(old);
+				}
+
+				for (const std::string& plural : nf.exceptionalPlurals)
+				{
+					if (!plural.empty())
+					{
+						if (next)
+						{
+							next->insert(plural);
+						}
+
+						stale.push_back(plural);
+						knownPlurals[nf.noun].push_back(plural);
+					}
+				}
+			}
+
+			if (next)
+			{
+				publishKeyFilter(next);
+			}
+
+			invalidateReplies(stale);
+			lastChange = readUpTo;
+			std::clog << pName << ": applied changes to " << nouns.size() << " nouns, up to change #" << lastChange;
+
+			if (next)
+			{
+				std::clog << "; the key filter now has " << next->size() << " nouns and plurals";
+			}
+
+			std::clog << std::endl;
+			return;
+		}
+
+		std::shared_ptr<const mpp::data::Lexicon> base = lexicon->current();
+		std::shared_ptr<const mpp::data::Lexicon> next = std::make_shared<const mpp::data::Lexicon>(*base, changes);
+
+		/*
+		* A reply only depends on the facts of the noun that was asked about, and those include the singulars that the noun is an exceptional plural of.
+		* So the stale replies are the changed nouns', and those of every exceptional plural they had or have now.
+		*/
+		std::vector<std::string> stale(nouns);
+
+		for (const mpp::data::NounFacts& nf : changes)
+		{
+			mpp::data::NounFacts old = base->facts(nf.noun);
+			stale.insert(stale.end(), old.exceptionalPlurals.cbegin(), old.exceptionalPlurals.cend());
+			stale.insert(stale.end(), nf.exceptionalPlurals.cbegin(), nf.exceptionalPlurals.cend());
+		}
+
+		lexicon->publish(next);
+		invalidateReplies(stale); // Each cache is updated after any request on its thread that pinned the old lexicon
+
+		while (lexicon->reclaim() > 0) // A request only pins the lexicon while it looks a noun up, so this is never a long wait
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		lastChange = readUpTo;
+		std::clog << pName << ": applied changes to " << nouns.size() << " nouns, up to change #" << lastChange << "; the lexicon now has " << next->size() << " nouns" << std::endl;
+	}
+
+	catch (std::exception& e) // Keep answering from the current lexicon, and try again at the next poll
+	{
+		std::clog << pName << ": couldn't apply the latest changes to the lexicon: " << e.what() << std::endl;
+
+		try
+		{
+			changeSess->reconnect();
+		}
+
+		catch (std::exception& re) // The DB is probably down, so the next poll will try again
+		{
+			std::clog << pName << ": couldn't reconnect to the DB: " << re.what() << std::endl;
+		}
+	}
+}
+
+/**
+* @desc Opens the refresher's DB session, and notes the newest change, so that later ones can be applied. Call it before the data that the changes apply to is read.
+* @param refreshInterval The # of seconds between polls.
+**/
+void Server::openChangeLog(unsigned refreshInterval)
+{
+	changeDBInfo = std::make_unique<mpp::data::DBInfo>(dbCnfFlPth);
+	changeSess = std::make_unique<mpp::data::DBSession>(*changeDBInfo);
+	lastChange = changeSess->latestChange(); // Before the tables are read, so that a change made while they're being read is applied again rather than missed
+	refreshEvery = std::chrono::seconds(refreshInterval);
+}
+
+/**
+* @desc Builds a key filter from the DB.
+* @param sess The session to read the keys with.
+* @return The filter.
+**/
+std::shared_ptr<const mpp::data::BloomFilter> Server::buildKeyFilter(mpp::data::DBSession& sess) const
+{
+	std::vector<std::string> keys = sess.lookupKeys();
+	std::shared_ptr<mpp::data::BloomFilter> toReturn = std::make_shared<mpp::data::BloomFilter>(keys.size(), keyFilterBits);
+
+	for (const std::string& key : keys)
+	{
+		toReturn->insert(key);
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Makes a key filter current, and hands it to every DB session on its own thread. Only call this with rebuildMtx held, or before the pool runs.
+* @param f The filter.
+**/
+void Server::publishKeyFilter(std::shared_ptr<const mpp::data::BloomFilter> f)
+{
+	keyFilter = f;
+
+	for (const ShardPtr& shard : shards)
+	{
+		shard->send([f](Shard& s)
+			{
+				for (const std::shared_ptr<mpp::data::AsyncDBSession>& sess : s.dbSessions)
+				{
+					sess->setFilter(f);
+				}
+			}
+		);
+	}
+}
+
+/**
+* @desc Drops the replies about some nouns from every thread's reply cache. Each cache is updated by its own thread.
+* @param stale The nouns.
+**/
+void Server::invalidateReplies(const std::vector<std::string>& stale)
+{
+	if (!shards.front()->replyCache)
+	{
+		return;
+	}
+
+	for (const ShardPtr& shard : shards)
+	{
+		shard->send([stale](Shard& s)
+			{
+				for (const std::string& noun : stale)
+				{
+					s.replyCache->invalidate(noun);
+				}
+			}
+		);
+	}
+}
+
+/**
+* @desc Stops the refresher, if it's running, and waits for it to finish.
+**/
+void Server::stopRefresher()
+{
+	if (refresher.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(refreshMtx);
+			stopping = true;
+		}
+
+		refreshCv.notify_all();
+		refresher.join();
+	}
+}
+
+/**
+* @desc Runs the server's io_context loop, and the lexicon refresher if there is one. Once they stop, prints the reply cache's counters.
 **/
 void Server::run()
 {
 	#ifdef DEBUG
 	std::cout << pName << ":Server::run called" << std::endl;
 	#endif
+
+	if (!otherCpus.empty()) // The refresher inherits this, and the pool's threads pin themselves
+	{
+		if (affinity::pinThisThread(otherCpus))
+		{
+			std::clog << pName << ": keeping threads outside the pool on CPUs " << affinity::toString(otherCpus) << std::endl;
+		}
+
+		else
+		{
+			std::clog << pName << ": couldn't move threads outside the pool to CPUs " << affinity::toString(otherCpus) << std::endl;
+		}
+	}
+
+	if (changeSess) // Started here rather than in the constructor, so that a constructor that throws never leaves it running
+	{
+		refresher = std::thread([this]()
+			{
+				pollChanges();
+			}
+		);
+	}
+
 	iocp.run(); // Run the pool
+
+	if (reloader.joinable()) // Let a reload that's still running finish, so that its message isn't lost
+	{
+		reloader.join();
+	}
+
+	stopRefresher(); // The pool can stop without handleStop(), e.g. if a handler throws
+
+	/* Every thread has been joined, so the counters can be read */
+	for (const ShardPtr& shard : shards)
+	{
+		const Shard::Metrics& m = shard->metrics;
+		std::clog << pName << ": thread " << shard->index << ": " << m.connections << " connections, " << m.requests << " requests, " << m.badRequests << " bad requests, " << m.failedLookups << " failed lookups" << std::endl;
+	}
+
+	if (shards.front()->replyCache)
+	{
+		mpp::ReplyCache::Stats stats = getCacheStats();
+		std::clog << pName << ": reply cache: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.evictions << " evictions (" << stats.rejections << " rejected on admission)" << std::endl;
+	}
+
+	if (keyFilterBits > 0)
+	{
+		mpp::data::AsyncDBSession::FilterStats stats = getFilterStats();
+		std::uint64_t absent = stats.rejected + stats.falsePositives; // Lookups that the filter could have ruled out
+		std::clog << pName << ": key filter: " << stats.checked << " lookups, " << stats.rejected << " answered without the DB, " << stats.falsePositives << " false positives (a rate of " << (absent > 0 ? 100.0 * stats.falsePositives / absent : 0.0) << "%)" << std::endl;
+	}
+
+	if (shards.front()->latency)
+	{
+		LatencyStats stats = getLatencyStats();
+		std::clog << pName << ": reply latency: " << stats.count() << " writes, p50 " << stats.percentile(0.5).count() / 1000.0 << " us, p99 " << stats.percentile(0.99).count() / 1000.0 << " us, p99.9 " << stats.percentile(0.999).count() / 1000.0 << " us, max " << stats.max().count() / 1000.0 << " us" << std::endl;
+	}
+}
+
+/**
+* @desc Adds up the counters of every thread's reply cache. Only call this while the pool isn't running, since each cache is updated by its own thread without locking.
+* @return The totals.
+**/
+mpp::ReplyCache::Stats Server::getCacheStats() const
+{
+	mpp::ReplyCache::Stats toReturn;
+
+	for (const ShardPtr& shard : shards)
+	{
+		if (!shard->replyCache)
+		{
+			continue;
+		}
+
+		const mpp::ReplyCache::Stats& s = shard->replyCache->getStats();
+		toReturn.hits += s.hits;
+		toReturn.misses += s.misses;
+		toReturn.evictions += s.evictions;
+		toReturn.rejections += s.rejections;
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Adds up the key filter's counters from every DB session. Only call this while the pool isn't running, since each session is updated by its own thread without locking.
+* @return The totals.
+**/
+mpp::data::AsyncDBSession::FilterStats Server::getFilterStats() const
+{
+	mpp::data::AsyncDBSession::FilterStats toReturn;
+
+	for (const ShardPtr& shard : shards)
+	{
+		for (const std::shared_ptr<mpp::data::AsyncDBSession>& sess : shard->dbSessions)
+		{
+			const mpp::data::AsyncDBSession::FilterStats& s = sess->getFilterStats();
+			toReturn.checked += s.checked;
+			toReturn.rejected += s.rejected;
+			toReturn.falsePositives += s.falsePositives;
+		}
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Adds up every thread's latency histogram. Only call this while the pool isn't running, since each histogram is updated by its own thread without locking.
+* @return The totals.
+**/
+LatencyStats Server::getLatencyStats() const
+{
+	LatencyStats toReturn;
+
+	for (const ShardPtr& shard : shards)
+	{
+		if (shard->latency)
+		{
+			toReturn.merge(*shard->latency);
+		}
+	}
+
+	return toReturn;
 }
 
 /**
 * @desc Initiates an asynchronous accept operation.
+* @param acc The index of the acceptor to accept on.
 **/
-void Server::startAccept()
+void Server::startAccept(std::size_t acc)
 {
+	std::size_t shard = acc; // The index of the io_context that the connection will run on. With an acceptor per io_context, it's the acceptor's own.
+
+	if (!acceptPerThread)
+	{
+		iocp.getIoc(shard); // Takes turns between the io_contexts
+	}
+
+	ConnectionPtr& newConn = newConns[acc];
 	newConn.reset(
 		new Connection(
-			iocp.getIoc(),
-			dbCnfFlPth // Connection needs this to construct its request handler object
+			shards[shard], // The connection stays on this shard's thread, and only uses its state
+			connIdleTimeout,
+			connMaxReqs
 		)
 	);
 	#ifdef DEBUG
 	std::cout << pName << ":Server::startAccept: reset newConn" << std::endl;
 	#endif
-	acceptor.async_accept(
+	acceptors[acc].async_accept(
 		newConn->getSocket(),
 		/*BIND_FUNCTION(
 			&Server::handleAccept,
 			this,
 			boost::asio::placeholders::error
 		)*/
-		[this](const boost::system::error_code& e)
+		[this, acc](const boost::system::error_code& e)
 		{
-			handleAccept(e);
+			handleAccept(acc, e);
 		}
 	);
 	#ifdef DEBUG
@@ -147,10 +884,11 @@ void Server::startAccept()
 }
 
 /**
-* @desc Handles completion of an asynchronous accept operation.
+* @desc Handles completion of an asynchronous accept operation. The new connection is started on its shard's thread, which needn't be the acceptor's.
+* @param acc The index of the acceptor that accepted.
 * @param e An error object, if any occurred.
 **/
-void Server::handleAccept(const boost::system::error_code& e)
+void Server::handleAccept(std::size_t acc, const boost::system::error_code& e)
 {
 	#ifdef DEBUG
 	std::cout << pName << ":Server::handleAccept called" << std::endl;
@@ -161,11 +899,11 @@ void Server::handleAccept(const boost::system::error_code& e)
 		#ifdef DEBUG
 		std::cout << pName << ":Server::handleAccept: no error" << std::endl;
 		#endif
-		newConn->start(); // Start the new connection
+		newConns[acc]->start(); // Start the new connection
 	}
 
 	#ifdef DEBUG
 	std::cout << pName << ":Server::handleAccept: calling startAccept" << std::endl;
 	#endif
-	startAccept();
+	startAccept(acc);
 }
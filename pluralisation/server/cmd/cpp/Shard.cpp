@@ -0,0 +1,49 @@
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+
+/* STL */
+#include <memory> // std::shared_ptr, std::make_unique
+
+/* Our headers */
+#include "Shard.hpp" // Class def'n
+
+/**
+* @desc Constructor. Creates an empty shard, with no DB sessions or handlers.
+* @param io_context The io_context whose thread owns the shard.
+* @param index The io_context's place in the pool, which is also its thread's lexicon reader slot.
+* @param cacheSize The # of replies to cache. Zero turns caching off.
+* @param measureLatency Whether or not to keep a latency histogram.
+**/
+Shard::Shard(boost::asio::io_context& io_context, std::size_t index, std::size_t cacheSize, bool measureLatency) : ioc(io_context),
+	index(index),
+	replyCache(cacheSize > 0 ? std::make_unique<mpp::ReplyCache>(cacheSize) : nullptr),
+	latency(measureLatency ? std::make_unique<LatencyStats>() : nullptr),
+	nAccepted(0)
+{
+}
+
+/**
+* @desc Creates a request handler for each DB session, or a single one that uses the lexicon if there are no sessions. Call this once, after the sessions have been opened.
+* @param lex The server's in-memory noun tables, or null if the DB should be queried for every request.
+**/
+void Shard::makeHandlers(std::shared_ptr<mpp::data::LiveLexicon> lex)
+{
+	if (dbSessions.empty())
+	{
+		handlers.push_back(std::make_unique<mpp::ReqHandler>(std::shared_ptr<mpp::data::AsyncDBSession>(), lex, index));
+	}
+
+	for (const std::shared_ptr<mpp::data::AsyncDBSession>& sess : dbSessions)
+	{
+		handlers.push_back(std::make_unique<mpp::ReqHandler>(sess, lex, index));
+	}
+}
+
+/**
+* @desc Picks the handler for a new connection, taking turns so that connections are spread over the shard's DB sessions. Only call this from the shard's thread.
+* @return The handler, which lives as long as the shard does.
+**/
+mpp::ReqHandler& Shard::nextHandler()
+{
+	return *handlers[nAccepted++ % handlers.size()];
+}
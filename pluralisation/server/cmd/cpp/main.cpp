@@ -41,13 +41,29 @@ int main(int argc, char* argv[])
 	std::size_t threads; // # of threads
 	std::string address; // Address to run on
 	std::string dbConfigFilePath;
+	Server::Options serverOpts; // Everything else. The options below are read straight into it.
 
 	opts.add_options()
 		("help,h", "Print this help message")
 		("port,p", boost::program_options::value<int>(&port)->default_value(50001), "Set the port to listen on.")
 		("threads,t", boost::program_options::value<std::size_t>(&threads)->default_value(5), "Set the number of threads to use.")
 		("address,a", boost::program_options::value<std::string>(&address)->default_value("127.0.0.1"), "Set the address which the server will run on")
-		("dbconfigfilepath,d", boost::program_options::value<std::string>(&dbConfigFilePath)->default_value("/home/victor/info/pluraliser.dbinfo"), "The path to the file containing DB config info");
+		("dbconfigfilepath,d", boost::program_options::value<std::string>(&dbConfigFilePath)->default_value("/home/victor/info/pluraliser.dbinfo"), "The path to the file containing DB config info")
+		("lexicon,l", boost::program_options::bool_switch(&serverOpts.useLexicon), "Load the noun tables into memory at startup, and answer every request without querying the DB. Changes to the DB aren't seen until the server is sent SIGHUP, which reloads the tables without stopping it.")
+		("lexiconfile,f", boost::program_options::value<std::string>(&serverOpts.lexiconFile), "Map the noun tables from a lexicon file written by mpp-lexc, instead of reading them from the DB. The DB isn't used at all. Send the server SIGHUP to map the file again after recompiling it.")
+		("dbsessions,s", boost::program_options::value<std::size_t>(&serverOpts.dbSessions)->default_value(0), "Set the number of DB sessions, split as evenly as possible between the threads, with at least one each. 0 means one per thread.")
+		("idletimeout,i", boost::program_options::value<unsigned>(&serverOpts.idleTimeout)->default_value(30), "Close a connection after this many seconds without a request. 0 means never.")
+		("maxrequests,m", boost::program_options::value<std::size_t>(&serverOpts.maxReqs)->default_value(1000), "Close a connection after answering this many requests on it. 0 means no limit, and 1 turns keep-alive off.")
+		("cachesize,c", boost::program_options::value<std::size_t>(&serverOpts.cacheSize)->default_value(65536), "Cache this many replies, split between the threads. Cached replies aren't refreshed when the DB changes, until the server is sent SIGHUP, which clears them, or unless --refreshinterval is given. 0 turns the cache off.")
+		("refreshinterval,r", boost::program_options::value<unsigned>(&serverOpts.refreshInterval)->default_value(0), "Poll the DB's lexiconChanges table every this many seconds, and apply the changes it lists to the lexicon or the key filter without reloading it. Only the cached replies about changed nouns are dropped. Without --lexicon, --lexiconfile or --keyfilter, this only keeps the reply cache up to date, so it needs --cachesize. 0 turns polling off.")
+		("batchsize,b", boost::program_options::value<std::size_t>(&serverOpts.batchSize)->default_value(64), "Look up at most this many nouns in one DB query. Lookups that queue up behind a query are sent together once it finishes. 1 turns batching off.")
+		("batchwindow,w", boost::program_options::value<unsigned>(&serverOpts.batchWindow)->default_value(0), "Make a lookup that finds its thread's DB session idle wait up to this many microseconds for others to join its query. Trades a little latency for fewer queries at peak. 0 sends it straight away.")
+		("keyfilter,k", boost::program_options::value<unsigned>(&serverOpts.filterBits)->default_value(0), "When answering from the DB, build a filter of every noun and exceptional plural, using this many bits for each, and answer lookups of anything else without a query. 10 turns away about 99% of them. Nouns added to the DB are only seen once the server is sent SIGHUP, or once they're logged, with --refreshinterval. 0 turns the filter off.")
+		("reuseport,u", boost::program_options::bool_switch(&serverOpts.reusePort), "Give each thread its own SO_REUSEPORT socket on the port, so that the kernel spreads new connections between the threads, and each connection is handled by the thread that accepted it. Otherwise one thread accepts every connection and hands them out in turn.")
+		("cpus,C", boost::program_options::value<std::string>(&serverOpts.cpuList), "Pin the threads that handle connections to these CPUs, e.g. 2-5,8. Each thread gets one, in order, going round again if there are more threads than CPUs.")
+		("sharecpus,S", boost::program_options::bool_switch(&serverOpts.shareCpus), "With --cpus, let every thread that handles connections run on any of the CPUs, instead of pinning each to one.")
+		("isolatecpus,I", boost::program_options::bool_switch(&serverOpts.isolateCpus), "With --cpus, keep every other thread, such as the ones that reload and refresh the lexicon, off those CPUs.")
+		("latency,L", boost::program_options::bool_switch(&serverOpts.measureLatency), "Measure how long each reply takes, from the read that completes its request to the end of its write, and print the percentiles when the server stops.");
 
 	try
 	{
@@ -87,12 +103,25 @@ int main(int argc, char* argv[])
 	#ifdef DEBUG
 	std::clog << ourName << ": main: Port #:" << port << std::endl
 		<< "\t# of threads: " << threads << std::endl
-		<< "\tAddress: " << address << std::endl;
+		<< "\tAddress: " << address << std::endl
+		<< "\tIn-memory lexicon: " << (serverOpts.useLexicon ? "yes" : "no") << std::endl
+		<< "\tLexicon file: " << (serverOpts.lexiconFile.empty() ? "none" : serverOpts.lexiconFile) << std::endl
+		<< "\tDB sessions: " << serverOpts.dbSessions << std::endl
+		<< "\tIdle timeout: " << serverOpts.idleTimeout << " s" << std::endl
+		<< "\tRequests per connection: " << serverOpts.maxReqs << std::endl
+		<< "\tReply cache size: " << serverOpts.cacheSize << std::endl
+		<< "\tRefresh interval: " << serverOpts.refreshInterval << " s" << std::endl
+		<< "\tLookup batch size: " << serverOpts.batchSize << std::endl
+		<< "\tLookup batch window: " << serverOpts.batchWindow << " us" << std::endl
+		<< "\tKey filter: " << serverOpts.filterBits << " bits per key" << std::endl
+		<< "\tAcceptor per thread: " << (serverOpts.reusePort ? "yes" : "no") << std::endl
+		<< "\tCPUs: " << (serverOpts.cpuList.empty() ? "any" : serverOpts.cpuList) << (serverOpts.shareCpus ? ", shared" : "") << (serverOpts.isolateCpus ? ", isolated" : "") << std::endl
+		<< "\tMeasure latency: " << (serverOpts.measureLatency ? "yes" : "no") << std::endl;
 	#endif
 
 	try
 	{	
-		Server s(address, port, threads, ourName, dbConfigFilePath); // Create the server
+		Server s(address, port, threads, ourName, dbConfigFilePath, serverOpts); // Create the server
 		s.run(); // Run the server until stopped
 	}
 
@@ -0,0 +1,43 @@
+#ifndef AFFINITY_HPP
+#define AFFINITY_HPP
+
+/* STL */
+#include <string> // std::string
+#include <vector> // std::vector
+
+/**
+* Helpers for keeping threads on particular CPUs.
+**/
+namespace affinity
+{
+	/**
+	* @desc Reads a list of CPUs, in the form that taskset and /sys/devices/system/cpu use, e.g. "2-5,8".
+	* @param list The list.
+	* @return The CPUs, in the order that they're listed.
+	* @throws std::invalid_argument If the list is empty, or isn't in that form.
+	**/
+	std::vector<int> parseCpuList(const std::string& list);
+
+	/**
+	* @desc Lets the calling thread run only on some CPUs.
+	* @param cpus The CPUs.
+	* @return True if the thread was moved, false if the OS refused, e.g. because a CPU doesn't exist.
+	**/
+	bool pinThisThread(const std::vector<int>& cpus);
+
+	/**
+	* @desc Lists the CPUs that the calling thread may run on, apart from some. Call it before that thread is pinned, so that it sees every CPU that the process was started with.
+	* @param excluded The CPUs to leave out.
+	* @return The rest, which is empty if there aren't any.
+	**/
+	std::vector<int> allCpusExcept(const std::vector<int>& excluded);
+
+	/**
+	* @desc Writes a list of CPUs in the form that parseCpuList() reads, for logging.
+	* @param cpus The CPUs.
+	* @return The list.
+	**/
+	std::string toString(const std::vector<int>& cpus);
+}
+
+#endif // AFFINITY_HPP
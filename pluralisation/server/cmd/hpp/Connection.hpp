@@ -3,17 +3,20 @@
 
 /* C++ versions of C headers */
 #include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
 
 /* STL */
 #include <array> // std::array
 #include <string> // std::string
-#include <vector> // std::vector
+#include <chrono> // std::chrono::seconds, std::chrono::steady_clock
+#include <string_view> // std::string_view
+#include <exception> // std::exception_ptr
 
 /* Boost */
 #include <boost/noncopyable.hpp> // boost::noncopyable
 #include <boost/asio/io_context.hpp> // boost::asio::io_context
 #include <boost/asio/ip/tcp.hpp> // boost::asio::ip::tcp::socket
-#include <boost/asio/buffer.hpp> // boost::asio::const_buffer
+#include <boost/asio/steady_timer.hpp> // boost::asio::steady_timer
 
 /* Our headers - Malayalam Pluralisation Protocol library */
 #include "mpp/ReqHandler.hpp" // Request handler
@@ -21,6 +24,9 @@
 #include "mpp/Request.hpp" // Represents a request
 #include "mpp/Reply.hpp" // Represents a reply
 
+/* Our headers - server */
+#include "Shard.hpp" // The state of the io_context's thread
+
 /* Our headers - macros to choose between Boost and std implementations */
 #include "bosmacros/enable_shared_from_this.hpp" // ENABLE_SHARED_FROM_THIS macro
 #include "bosmacros/error_code.hpp" // ERROR_CODE macro
@@ -34,11 +40,12 @@ class Connection : public ENABLE_SHARED_FROM_THIS<Connection>,
 {
 	public:
 		/**
-		* @desc Constructs a Connection with the givne io_context & request handler.
-		* @param io_context The io_context to use.
-		* @param dbConfFilePath Path to configuration file containing DB vars. Used to construct ReqHandler.
+		* @desc Constructs a Connection on a shard, whose io_context it runs on and whose handler, reply cache and counters it uses.
+		* @param home The shard. The connection keeps it alive, and only ever uses it from its io_context's thread.
+		* @param idleTimeout How long to wait for the next request before closing the connection. Zero means forever. Server passes --idletimeout.
+		* @param maxReqs The # of requests to answer before closing the connection. Zero means no limit, and 1 closes it after the first reply. Server passes --maxrequests.
 		**/
-		explicit Connection(boost::asio::io_context& io_context, std::string dbConfFilePath);
+		explicit Connection(ShardPtr home, std::chrono::seconds idleTimeout, std::size_t maxReqs);
 	
 		/**
 		* @desc Fetches the socket associated with this Connection.
@@ -47,11 +54,21 @@ class Connection : public ENABLE_SHARED_FROM_THIS<Connection>,
 		boost::asio::ip::tcp::socket& getSocket();
 
 		/**
-		* @desc Starts the first asynchronous operation for the connection.
+		* @desc Picks a handler for the connection, and starts its first asynchronous operation. Only call this from its shard's thread.
 		**/
 		void start();
 
 	private:
+		/**
+		* @desc Starts reading the next request, and restarts the idle timer.
+		**/
+		void startRead();
+
+		/**
+		* @desc Closes the connection if the idle timer expired.
+		* @param e Set if the wait was cancelled, i.e. if the timer was restarted or stopped.
+		**/
+		void handleIdle(const ERROR_CODE& e);
 
 		/**
 		* @desc Handles completion of a read operation.
@@ -60,6 +77,30 @@ class Connection : public ENABLE_SHARED_FROM_THIS<Connection>,
 		**/
 		void handleRead(const ERROR_CODE& e, std::size_t bytesTransferred);
 
+		/**
+		* @desc Handles every complete request in the unparsed bytes, in the order that they arrived, so that a client can send several without waiting for each reply.
+		*	A request's header and noun slices point into buffer, so each one is handled before the next is parsed, and buffer isn't read into again until the replies have been written.
+		*	If the handler has to wait for the DB, this returns, and handleReply() calls it again once the reply is ready. Once every request has been handled, the replies are written, or more bytes are read if there were none.
+		**/
+		void processRequests();
+
+		/**
+		* @desc Handles completion of a request handler, possibly after it waited for the DB.
+		* @param err Set if the noun couldn't be looked up, in which case there's no reply, and the connection is closed once the earlier replies have been written.
+		* @param repStart Where the reply's bytes start in outBuf.
+		**/
+		void handleReply(std::exception_ptr err, std::size_t repStart);
+
+		/**
+		* @desc Counts an answered request, and clears it for the next one.
+		**/
+		void finishRequest();
+
+		/**
+		* @desc Appends the current reply to the replies waiting to be written, then clears it for the next request.
+		**/
+		void queueReply();
+
 		/**
 		* @desc Handles completion of a write operation.
 		* @param e Describes what error occurred, if any.
@@ -67,12 +108,23 @@ class Connection : public ENABLE_SHARED_FROM_THIS<Connection>,
 		void handleWrite(const ERROR_CODE& e, std::size_t bytesTransferred);
 
 		boost::asio::ip::tcp::socket socket; // We listen on this
-		mpp::ReqHandler reqHandler; // Parses requests. Each Connection object constructs its own copy because the connection to the DB will time out if the object lasts for too long.
+		ShardPtr shard; // The shard that owns our io_context. Only used from its thread.
+		mpp::ReqHandler* reqHandler; // Handles requests. Owned by shard, and shared with other Connections on it. Null until start().
 		std::array<char, 8192> buffer; // Stores data read from the socket
 		mpp::ReqParser reqParser;
 		mpp::Request req;
 		mpp::Reply rep;
-		std::vector<boost::asio::const_buffer> repBufs;
+		std::string outBuf; // Replies to every request in the last read, in the order that the requests arrived
+		boost::asio::steady_timer idleTimer; // Closes the connection if no request arrives in time. Only runs while we wait for the client's bytes, never while a reply is owed.
+		const std::chrono::seconds idleTimeout; // How long idleTimer waits. Zero means that it's never started.
+		const std::size_t maxReqs; // # of requests to answer before closing. Zero means no limit.
+		std::size_t nReqs; // # of requests answered so far
+		bool keepAlive; // Whether or not to read another request once the current reply has been written
+		std::chrono::steady_clock::time_point readAt; // When the read that completed the requests being answered finished
+		std::string_view unparsed; // The bytes of buffer that haven't been parsed yet
+		std::uint64_t cacheGen; // The reply cache's generation when the request being handled was looked up
+		bool awaitingReply; // Set while the handler is waiting for the DB
+		bool parsing; // Set while processRequests() is running, so that a handler which completes straight away doesn't re-enter it
 };
 
 typedef SHARED_PTR<Connection> ConnectionPtr;
@@ -21,8 +21,9 @@ class IoContextPool : private boost::noncopyable
 		/**
 		* @desc Constructor. Creates a pool of the specified size.
 		* @param poolSize The size of the pool.
+		* @param cpus The CPUs that each io_context's thread may run on, in the pool's order. Empty lets them run anywhere.
 		**/
-		explicit IoContextPool(std::size_t poolSize);
+		explicit IoContextPool(std::size_t poolSize, std::vector<std::vector<int>> cpus = {});
 
 		/**
 		* @desc Runs all io_context objects in the pool.
@@ -40,6 +41,26 @@ class IoContextPool : private boost::noncopyable
 		**/
 		boost::asio::io_context& getIoc();
 
+		/**
+		* @desc Fetches an io_context to use, along with its position in the pool, so that per-io_context state can be kept alongside it.
+		* @param index Set to the io_context's index, from 0 to size() - 1.
+		* @return A reference to an io_context that can be used.
+		**/
+		boost::asio::io_context& getIoc(std::size_t& index);
+
+		/**
+		* @desc Fetches the io_context at a position in the pool, e.g. to post work to a particular thread.
+		* @param index The io_context's index, from 0 to size() - 1.
+		* @return A reference to the io_context.
+		**/
+		boost::asio::io_context& at(std::size_t index);
+
+		/**
+		* @desc Fetches the # of io_contexts in the pool.
+		* @return The pool's size.
+		**/
+		std::size_t size() const;
+
 	private:
 		/* Types */
 		typedef SHARED_PTR<boost::asio::io_context> iocPtr;
@@ -49,6 +70,7 @@ class IoContextPool : private boost::noncopyable
 		std::size_t nextIoCon; // Index of the next io_context to use for a connection
 		std::vector<iocPtr> ioContexts; // Pool of io_contexts
 		std::list<iocWork> work; // The work that keeps the I/O contexts running
+		std::vector<std::vector<int>> threadCpus; // The CPUs that each thread is pinned to. Empty if they aren't pinned.
 };
 
 #endif // IOCONTEXTPOOL_HPP
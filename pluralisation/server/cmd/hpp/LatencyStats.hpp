@@ -0,0 +1,78 @@
+#ifndef LATENCYSTATS_HPP
+#define LATENCYSTATS_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* STL */
+#include <array> // std::array
+#include <chrono> // std::chrono::nanoseconds
+
+// # of buckets: 16 for 0-15 ns, then 8 for each power of 2 above that
+#define LATENCYBUCKETS 496
+
+/**
+* A histogram of latencies, precise to within 1/8 of each one, that can be added to without allocating.
+* Each io_context's thread keeps its own, so that they're never locked. They're only added together once the pool has stopped.
+**/
+class LatencyStats
+{
+	public:
+		/**
+		* @desc Constructor. Makes an empty histogram.
+		**/
+		LatencyStats();
+
+		/**
+		* @desc Counts a latency.
+		* @param took The latency.
+		**/
+		void record(std::chrono::nanoseconds took);
+
+		/**
+		* @desc Adds another histogram's counts to this one's.
+		* @param other The other histogram.
+		**/
+		void merge(const LatencyStats& other);
+
+		/**
+		* @desc Fetches the # of latencies counted.
+		* @return The count.
+		**/
+		std::uint64_t count() const;
+
+		/**
+		* @desc Finds a percentile.
+		* @param q The fraction of latencies that must be at most the result, from 0 to 1, e.g. 0.99 for the 99th percentile.
+		* @return The top of the bucket that the percentile falls in, or zero if nothing has been counted.
+		**/
+		std::chrono::nanoseconds percentile(double q) const;
+
+		/**
+		* @desc Fetches the largest latency counted.
+		* @return The latency.
+		**/
+		std::chrono::nanoseconds max() const;
+
+	private:
+		/**
+		* @desc Works out which bucket a latency goes in.
+		* @param ns The latency, in ns.
+		* @return The bucket's index.
+		**/
+		static std::size_t bucketOf(std::uint64_t ns);
+
+		/**
+		* @desc Works out the largest latency that goes in a bucket.
+		* @param b The bucket's index.
+		* @return The latency, in ns.
+		**/
+		static std::uint64_t bucketTop(std::size_t b);
+
+		std::array<std::uint64_t, LATENCYBUCKETS> counts; // # of latencies in each bucket
+		std::uint64_t n; // # of latencies counted
+		std::uint64_t largest; // The largest latency counted, in ns
+};
+
+#endif // LATENCYSTATS_HPP
@@ -3,9 +3,18 @@
 
 /* C++ Versions of C headers */
 #include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
 
 /* STL */
 #include <string> // std::string
+#include <memory> // std::shared_ptr
+#include <vector> // std::vector
+#include <unordered_map> // std::unordered_map
+#include <chrono> // std::chrono::seconds
+#include <thread> // std::thread
+#include <atomic> // std::atomic
+#include <mutex> // std::mutex
+#include <condition_variable> // std::condition_variable
 #ifdef DEBUG
 #include <map> // std::map
 #endif
@@ -18,6 +27,14 @@
 
 /* Our headers */
 #include "IoContextPool.hpp" // IoContextPool
+#include "mpp/data/LiveLexicon.hpp" // In-memory noun tables that can be replaced while running
+#include "mpp/data/AsyncDBSession.hpp" // Non-blocking DB sessions, each shared by the Connections on one io_context
+#include "mpp/data/DBInfo.hpp" // Needed by the refresher's DB session
+#include "mpp/data/DBSession.hpp" // Reads the change log
+#include "mpp/data/BloomFilter.hpp" // Turns away nouns that the DB knows nothing about
+#include "mpp/ReplyCache.hpp" // Cache of ready-to-send replies
+#include "LatencyStats.hpp" // Histogram of how long replies take
+#include "Shard.hpp" // ShardPtr
 #include "Connection.hpp" // ConnectionPtr
 
 /**
@@ -26,43 +43,168 @@
 class Server : private boost::noncopyable
 {
 	public:
+		/* Types */
+		struct Options // The server's settings, apart from where it listens and how many threads it runs. Each one has a command line option in main.cpp.
+		{
+			bool useLexicon = false; // If true, the noun tables are loaded into memory here, and requests never query the DB. SIGHUP reloads them.
+			std::string lexiconFile; // A lexicon file written by mpp-lexc. If given, it's mapped instead of reading the noun tables from the DB, and the DB isn't used at all. SIGHUP maps it again.
+			std::size_t dbSessions = 0; // The # of DB sessions to keep open, split evenly between the threads, with at least one each. Zero means one per thread.
+			unsigned idleTimeout = 30; // The # of seconds that a connection may wait for its next request before it's closed. Zero means forever.
+			std::size_t maxReqs = 1000; // The # of requests to answer on one connection before closing it. Zero means no limit.
+			std::size_t cacheSize = 0; // The # of replies to cache, split evenly between the threads. Zero turns the cache off.
+			unsigned refreshInterval = 0; // The # of seconds between polls of the DB's change log, whose changes are then applied to the lexicon. Zero turns polling off. Only used if the lexicon is read from the DB.
+			std::size_t batchSize = 64; // The most nouns that a DB session looks up in one query.
+			unsigned batchWindow = 0; // The # of microseconds that a lookup which finds its DB session idle waits for others to join it. Zero sends it straight away.
+			unsigned filterBits = 0; // The # of bits per key of a filter of every noun and exceptional plural in the DB, which answers lookups of anything else without a query. Zero turns the filter off. Only used if requests are answered from the DB.
+			bool reusePort = false; // If true, each thread listens on the port with its own SO_REUSEPORT socket, and keeps every connection that it accepts. Otherwise one thread accepts them all, and hands them out round-robin.
+			std::string cpuList; // The CPUs to run the io_context threads on, e.g. "2-5,8". Empty lets them run anywhere.
+			bool shareCpus = false; // If true, every io_context thread may run on any of cpuList's CPUs. Otherwise each is pinned to one of them, in order, going round again if there are more threads than CPUs.
+			bool isolateCpus = false; // If true, every other thread is kept off cpuList's CPUs.
+			bool measureLatency = false; // If true, each thread measures how long its replies take, from the read that completes a request to the end of the write of its reply. The percentiles are printed when the server stops.
+		};
+
 		/**
 		* @desc Creates a server that listens on the given port, and uses a pool of io_contexts of the given size.
 		* @param port Port to listen on.
 		* @param numThreads # of threads to use.
 		* @param progName The program's name.
 		* @param dbConfPath The path to the DB config file.
+		* @param options Everything else that can be set from the command line.
+		**/
+		explicit Server(const std::string& address, int port, std::size_t numThreads, std::string progName, std::string dbConfPath, const Options& options);
+
+		/**
+		* @desc Destructor. Waits for a lexicon reload or refresh that's still running.
 		**/
-		explicit Server(const std::string& address, int port, std::size_t numThreads, std::string progName, std::string dbConfPath);
+		~Server();
 
 		/**
-		* @desc Runs the server's io_context loop.
+		* @desc Runs the server's io_context loop, and the lexicon refresher if there is one. Once they stop, prints the reply cache's counters.
 		**/
 		void run();
 
+		/**
+		* @desc Adds up the counters of every thread's reply cache. Only call this while the pool isn't running, since each cache is updated by its own thread without locking.
+		* @return The totals.
+		**/
+		mpp::ReplyCache::Stats getCacheStats() const;
+
+		/**
+		* @desc Adds up the key filter's counters from every DB session. Only call this while the pool isn't running, since each session is updated by its own thread without locking.
+		* @return The totals.
+		**/
+		mpp::data::AsyncDBSession::FilterStats getFilterStats() const;
+
+		/**
+		* @desc Adds up every thread's latency histogram. Only call this while the pool isn't running, since each histogram is updated by its own thread without locking.
+		* @return The totals.
+		**/
+		LatencyStats getLatencyStats() const;
+
 	private:
 		/**
 		* @desc Handles a request to stop the server.
 		**/
 		void handleStop();
 
+		/**
+		* @desc Waits for the next SIGHUP, asynchronously.
+		**/
+		void waitForReload();
+
+		/**
+		* @desc Handles SIGHUP by starting a lexicon reload in the background, unless one is already running. If requests are answered from the DB, the reload rebuilds the key filter and clears the reply caches instead, if there are any.
+		**/
+		void handleReload();
+
+		/**
+		* @desc Builds a new lexicon from wherever the first one came from, and publishes it. If requests are answered from the DB, rebuilds the key filter instead, if there is one. Runs on the reloader thread, so that no io_context waits for it.
+		*	Once it's published, every thread's reply cache is cleared, and the old lexicon is freed as soon as the last request using it finishes.
+		**/
+		void reloadLexicon();
+
+		/**
+		* @desc Opens the refresher's DB session, and notes the newest change, so that later ones can be applied. Call it before the data that the changes apply to is read.
+		* @param refreshInterval The # of seconds between polls.
+		**/
+		void openChangeLog(unsigned refreshInterval);
+
+		/**
+		* @desc Builds a key filter from the DB.
+		* @param sess The session to read the keys with.
+		* @return The filter.
+		**/
+		std::shared_ptr<const mpp::data::BloomFilter> buildKeyFilter(mpp::data::DBSession& sess) const;
+
+		/**
+		* @desc Makes a key filter current, and hands it to every DB session on its own thread. Only call this with rebuildMtx held, or before the pool runs.
+		* @param f The filter.
+		**/
+		void publishKeyFilter(std::shared_ptr<const mpp::data::BloomFilter> f);
+
+		/**
+		* @desc Drops the replies about some nouns from every thread's reply cache. Each cache is updated by its own thread.
+		* @param stale The nouns.
+		**/
+		void invalidateReplies(const std::vector<std::string>& stale);
+
+		/**
+		* @desc Polls the change log every refreshEvery until the server stops. Runs on the refresher thread.
+		**/
+		void pollChanges();
+
+		/**
+		* @desc Reads the change log since the last poll. If any nouns have changed, fetches their current facts, publishes a copy of the lexicon with them applied, and drops the replies about them from every thread's reply cache.
+		*	If requests are answered from the DB, the changed nouns and their plurals are added to a copy of the key filter instead, if there is one, and their replies are dropped.
+		**/
+		void applyChanges();
+
+		/**
+		* @desc Stops the refresher, if it's running, and waits for it to finish.
+		**/
+		void stopRefresher();
+
 		/**
 		* @desc Initiates an asynchronous accept operation.
+		* @param acc The index of the acceptor to accept on.
 		**/
-		void startAccept();
+		void startAccept(std::size_t acc);
 
 		/**
-		* @desc Handles completion of an asynchronous accept operation.
+		* @desc Handles completion of an asynchronous accept operation. The new connection is started on its shard's thread, which needn't be the acceptor's.
+		* @param acc The index of the acceptor that accepted.
 		* @param e An error object, if any occurred.
 		**/
-		void handleAccept(const boost::system::error_code& e);
+		void handleAccept(std::size_t acc, const boost::system::error_code& e);
 
 		IoContextPool iocp; // Pool of io_contexts used for async ops
 		boost::asio::signal_set signals; // Used to receive signals
-		boost::asio::ip::tcp::acceptor acceptor; // Used to listen for incoming connections
-		ConnectionPtr newConn; // Pointer to a new connection
+		boost::asio::signal_set reloadSignals; // Used to receive SIGHUP
+		std::vector<boost::asio::ip::tcp::acceptor> acceptors; // Used to listen for incoming connections. With SO_REUSEPORT, one per io_context, in the pool's order, and each only used on its io_context's thread. Otherwise just one.
+		bool acceptPerThread; // Whether or not there's an acceptor for each io_context
+		std::vector<ConnectionPtr> newConns; // The connection that each acceptor will accept next
 		std::string pName; // Program name
 		std::string dbCnfFlPth; // DB configuration file path
+		std::string lexFile; // The lexicon file that was mapped, or empty if the lexicon came from the DB
+		std::shared_ptr<mpp::data::LiveLexicon> lexicon; // The noun tables shared by every Connection, with one reader slot per io_context. Null unless the server was asked to load or map them.
+		std::vector<ShardPtr> shards; // One per io_context, in the pool's order. Each is only used on its io_context's thread while the pool runs, and other threads reach it through Shard::send().
+		std::chrono::seconds connIdleTimeout; // Passed to every Connection
+		std::size_t connMaxReqs; // Passed to every Connection
+		unsigned keyFilterBits; // Bits per key of the key filter. Zero if there's no filter.
+		std::shared_ptr<const mpp::data::BloomFilter> keyFilter; // The filter that the DB sessions use. Replaced, never changed, under rebuildMtx. Null if there's no filter.
+		std::unordered_map<std::string, std::vector<std::string>> knownPlurals; // Each noun's exceptional plurals, as of the last time the filter was built or changes were applied. Only kept while the filter or the reply cache is refreshed, and only used under rebuildMtx.
+		std::vector<int> otherCpus; // The CPUs that every thread outside the pool runs on. Empty if they may run anywhere.
+		std::thread reloader; // Runs reloadLexicon()
+		std::atomic<bool> reloading; // Set while reloader is running
+		std::mutex rebuildMtx; // Held while a new lexicon is built and published, so that a reload and a refresh can't undo each other
+		std::chrono::seconds refreshEvery; // Time between polls of the change log. Zero if nothing is refreshed.
+		std::unique_ptr<mpp::data::DBInfo> changeDBInfo; // Used by changeSess, which refers to it
+		std::unique_ptr<mpp::data::DBSession> changeSess; // The refresher's own DB session. Null if nothing is refreshed.
+		std::uint64_t lastChange; // The id of the last change log row that has been applied
+		std::thread refresher; // Runs pollChanges()
+		std::mutex refreshMtx; // Guards stopping
+		std::condition_variable refreshCv; // Wakes the refresher early when the server stops
+		bool stopping; // Set once the server has been told to stop
 		#ifdef DEBUG
 		std::map<int, std::string> sigNames; // Signal names for debugging
 		#endif
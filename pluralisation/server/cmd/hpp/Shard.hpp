@@ -0,0 +1,98 @@
+#ifndef SHARD_HPP
+#define SHARD_HPP
+
+/* C++ versions of C headers */
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+/* STL */
+#include <vector> // std::vector
+#include <memory> // std::shared_ptr, std::unique_ptr
+
+/* Boost */
+#include <boost/noncopyable.hpp> // boost::noncopyable
+#include <boost/asio/io_context.hpp> // boost::asio::io_context
+#include <boost/asio/post.hpp> // boost::asio::post
+
+/* Our headers - Malayalam Pluralisation Protocol library */
+#include "mpp/ReqHandler.hpp" // Request handler
+#include "mpp/ReplyCache.hpp" // Cache of ready-to-send replies
+#include "mpp/data/LiveLexicon.hpp" // In-memory noun tables that can be replaced while running
+#include "mpp/data/AsyncDBSession.hpp" // Non-blocking DB session
+
+/* Our headers - server */
+#include "LatencyStats.hpp" // Histogram of how long replies take
+
+/* Our headers - macros to choose between Boost and std implementations */
+#include "bosmacros/enable_shared_from_this.hpp" // ENABLE_SHARED_FROM_THIS macro
+#include "bosmacros/shared_ptr.hpp" // SHARED_PTR macro
+
+/**
+* Everything that one io_context's thread uses to answer requests: its request handlers, DB sessions, reply cache, and counters.
+* Only that thread ever touches a shard while the pool is running, so none of its state is locked or atomic. Other threads hand it work through send().
+* A shard is held by shared_ptr, so each Connection that refers to it costs one atomic increment and decrement of its reference count.
+**/
+class Shard : public ENABLE_SHARED_FROM_THIS<Shard>,
+			private boost::noncopyable
+{
+	public:
+		/* Types */
+		struct Metrics // Plain counters, since only the shard's thread changes them
+		{
+			std::uint64_t connections = 0; // # of connections accepted
+			std::uint64_t requests = 0; // # of requests answered
+			std::uint64_t badRequests = 0; // # of requests that couldn't be parsed
+			std::uint64_t failedLookups = 0; // # of requests whose noun couldn't be looked up
+		};
+
+		/**
+		* @desc Constructor. Creates an empty shard, with no DB sessions or handlers.
+		* @param io_context The io_context whose thread owns the shard.
+		* @param index The io_context's place in the pool, which is also its thread's lexicon reader slot.
+		* @param cacheSize The # of replies to cache. Zero turns caching off.
+		* @param measureLatency Whether or not to keep a latency histogram.
+		**/
+		Shard(boost::asio::io_context& io_context, std::size_t index, std::size_t cacheSize = 0, bool measureLatency = false);
+
+		/**
+		* @desc Creates a request handler for each DB session, or a single one that uses the lexicon if there are no sessions. Call this once, after the sessions have been opened.
+		* @param lex The server's in-memory noun tables, or null if the DB should be queried for every request.
+		**/
+		void makeHandlers(std::shared_ptr<mpp::data::LiveLexicon> lex);
+
+		/**
+		* @desc Picks the handler for a new connection, taking turns so that connections are spread over the shard's DB sessions. Only call this from the shard's thread.
+		* @return The handler, which lives as long as the shard does.
+		**/
+		mpp::ReqHandler& nextHandler();
+
+		/**
+		* @desc Runs a function on the shard's thread, and passes it the shard. This is how other threads change a shard's state.
+		* @param f The function. It's copied, so anything that it captures must be safe to use from the shard's thread.
+		**/
+		template<typename Function>
+		void send(Function f)
+		{
+			boost::asio::post(ioc, [self = shared_from_this(), f]()
+				{
+					f(*self);
+				}
+			);
+		}
+
+		/* Properties */
+		boost::asio::io_context& ioc; // The io_context whose thread owns the shard
+		const std::size_t index; // ioc's place in the pool
+		std::vector<std::shared_ptr<mpp::data::AsyncDBSession>> dbSessions; // Each belongs to ioc. Empty if the lexicon is in use.
+		std::unique_ptr<mpp::ReplyCache> replyCache; // Null if caching is off
+		std::unique_ptr<LatencyStats> latency; // Null if latencies aren't measured
+		Metrics metrics;
+
+	private:
+		std::vector<std::unique_ptr<mpp::ReqHandler>> handlers; // One per DB session, shared by the connections that use it. Several requests can wait on a handler at once.
+		std::size_t nAccepted; // # of connections handed a handler so far
+};
+
+typedef SHARED_PTR<Shard> ShardPtr;
+
+#endif // SHARD_HPP
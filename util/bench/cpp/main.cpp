@@ -0,0 +1,136 @@
+/* STL */
+#include <cstddef> // std::size_t
+#include <cstdlib> // EXIT_SUCCESS, EXIT_FAILURE
+#include <string> // std::string
+#include <vector> // std::vector
+#include <algorithm> // std::all_of, std::for_each
+#include <chrono> // std::chrono::steady_clock, std::chrono::duration
+#include <random> // std::mt19937, std::uniform_int_distribution
+#include <iostream> // std::cout
+#include <iomanip> // std::setw, std::setprecision
+#include <functional> // std::function
+
+/* Our headers */
+#include "vuu/UTF8Validator.hpp" // Old: validates one byte per call
+#include "vuu/CodepointFinder.hpp" // Old: decodes through a stringstream into a list
+#include "vuu/LenCounter.hpp" // Counts one byte per call
+#include "vuu/CodepointsInRange.hpp" // Checks each code point's range
+#include "vuu/Codepoints.hpp" // New: decodes in place
+#include "vuu/RangeValidator.hpp" // New: validates and checks the range in one pass
+
+#define NNOUNS 10000 // # of nouns in the corpus
+#define NROUNDS 20 // # of times that each contender goes through the corpus
+
+/**
+* @desc Times a contender over the corpus.
+* @param name The contender's name, for printing.
+* @param corpus The nouns.
+* @param f Checks one noun, and returns true if it's valid.
+* @return False if the contender rejected a noun, which they're all meant to accept.
+**/
+bool time(const char* name, const std::vector<std::string>& corpus, std::function<bool(const std::string&)> f)
+{
+	std::size_t nAccepted = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (std::size_t round = 0; round < NROUNDS; round++)
+	{
+		for (const std::string& noun : corpus)
+		{
+			nAccepted += f(noun);
+		}
+	}
+
+	std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+	std::cout << std::setw(40) << std::left << name << std::fixed << std::setprecision(1) << took.count() / (NROUNDS * corpus.size()) << " ns/noun" << std::endl;
+	return nAccepted == NROUNDS * corpus.size();
+}
+
+int main()
+{
+	/* Malayalam nouns of 3 to 12 code points, which is what the server sees */
+	std::vector<std::string> corpus;
+	std::mt19937 gen(20201017); // Fixed seed, so that runs can be compared
+	std::uniform_int_distribution<std::size_t> lenDist(3, 12);
+	std::uniform_int_distribution<unsigned> cpDist(0x0D00, 0x0D7F);
+
+	for (std::size_t i = 0; i < NNOUNS; i++)
+	{
+		std::string noun;
+		std::size_t len = lenDist(gen);
+
+		for (std::size_t j = 0; j < len; j++)
+		{
+			unsigned cp = cpDist(gen);
+			noun += static_cast<char>(0xE0 | (cp >> 12));
+			noun += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			noun += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+
+		corpus.push_back(noun);
+	}
+
+	const vuu::RangeValidator malayalam(0x0D00, 0x0D7F);
+	bool ok = true;
+
+	std::cout << "Validating UTF-8:" << std::endl;
+	ok &= time("UTF8Validator + std::all_of", corpus, [](const std::string& s)
+		{
+			return std::all_of(s.cbegin(), s.cend(), vuu::UTF8Validator());
+		}
+	);
+	ok &= time("countCodepoints", corpus, [](const std::string& s)
+		{
+			std::size_t n;
+			return vuu::countCodepoints(s.data(), s.size(), n);
+		}
+	);
+
+	std::cout << std::endl << "Validating UTF-8 and checking the range:" << std::endl;
+	ok &= time("UTF8Validator + CodepointFinder", corpus, [](const std::string& s)
+		{
+			vuu::CodepointFinder vcf = std::for_each(s.cbegin(), s.cend(), vuu::CodepointFinder());
+			return std::all_of(s.cbegin(), s.cend(), vuu::UTF8Validator()) && std::all_of(vcf.cbegin(), vcf.cend(), vuu::CodepointsInRange(0x0D00, 0x0D7F));
+		}
+	);
+	ok &= time("Codepoints (lazy)", corpus, [](const std::string& s)
+		{
+			vuu::Codepoints cps(s.data(), s.size());
+			std::size_t n;
+			return vuu::countCodepoints(s.data(), s.size(), n) && std::all_of(cps.begin(), cps.end(), vuu::CodepointsInRange(0x0D00, 0x0D7F));
+		}
+	);
+	ok &= time("decode into a buffer", corpus, [](const std::string& s)
+		{
+			char32_t buf[64];
+			vuu::DecodeResult res = vuu::decode(s.data(), s.size(), buf, 64);
+			return res.valid && res.nBytes == s.size() && std::all_of(buf, buf + res.nCodepoints, vuu::CodepointsInRange(0x0D00, 0x0D7F));
+		}
+	);
+	ok &= time("RangeValidator", corpus, [&malayalam](const std::string& s)
+		{
+			return malayalam(s.data(), s.size()) == vuu::RangeValidator::Valid;
+		}
+	);
+
+	std::cout << std::endl << "Counting code points:" << std::endl;
+	ok &= time("LenCounter + std::for_each", corpus, [](const std::string& s)
+		{
+			vuu::LenCounter ulc = std::for_each(s.cbegin(), s.cend(), vuu::LenCounter());
+			return ulc.getNumCodePoints() > 0;
+		}
+	);
+	ok &= time("countCodepoints", corpus, [](const std::string& s)
+		{
+			std::size_t n = 0;
+			return vuu::countCodepoints(s.data(), s.size(), n) && n > 0;
+		}
+	);
+
+	if (!ok)
+	{
+		std::cout << "A contender rejected a valid noun!" << std::endl;
+	}
+
+	return (ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
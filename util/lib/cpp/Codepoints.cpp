@@ -0,0 +1,255 @@
+/* STL */
+#include <cstddef> // std::size_t
+
+/* Our headers */
+#include "vuu/Codepoints.hpp" // Class & function def'ns
+
+/**
+* @desc Decodes the code point at the start of some UTF-8 bytes, with shifts and masks.
+* @param p The first byte.
+* @param end The end of the bytes. Must be after p.
+* @param cp Set to the code point, if it's valid.
+* @return The # of bytes in the code point, or 0 if they aren't valid UTF-8 (a stray continuation byte, a truncated or overlong sequence, a surrogate, or past U+10FFFF).
+**/
+std::size_t vuu::decodeNext(const char* p, const char* end, char32_t& cp)
+{
+	static const char32_t smallest[5] = {0, 0, 0x80, 0x800, 0x10000}; // The smallest code point that needs each # of bytes. Anything less is overlong.
+	const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+	char32_t decoded;
+	std::size_t n;
+
+	if (b[0] < 0x80) // 0xxxxxxx
+	{
+		cp = b[0];
+		return 1;
+	}
+
+	else if ((b[0] & 0xE0) == 0xC0) // 110xxxxx
+	{
+		decoded = b[0] & 0x1F;
+		n = 2;
+	}
+
+	else if ((b[0] & 0xF0) == 0xE0) // 1110xxxx
+	{
+		decoded = b[0] & 0x0F;
+		n = 3;
+	}
+
+	else if ((b[0] & 0xF8) == 0xF0) // 11110xxx
+	{
+		decoded = b[0] & 0x07;
+		n = 4;
+	}
+
+	else // A continuation byte, or a byte that's never in UTF-8
+	{
+		return 0;
+	}
+
+	if (static_cast<std::size_t>(end - p) < n) // Truncated
+	{
+		return 0;
+	}
+
+	for (std::size_t i = 1; i < n; i++)
+	{
+		if ((b[i] & 0xC0) != 0x80) // Not 10xxxxxx
+		{
+			return 0;
+		}
+
+		decoded = (decoded << 6) | (b[i] & 0x3F);
+	}
+
+	if (decoded < smallest[n] || (decoded >= 0xD800 && decoded <= 0xDFFF) || decoded > 0x10FFFF)
+	{
+		return 0;
+	}
+
+	cp = decoded;
+	return n;
+}
+
+/**
+* @desc Decodes UTF-8 into a buffer that the caller owns. Nothing is allocated.
+* @param data The bytes.
+* @param len The # of bytes.
+* @param out The buffer.
+* @param cap The # of code points that the buffer holds. Decoding stops once it's full, and can be continued from data + nBytes.
+* @return How many code points and bytes were decoded, and whether decoding stopped at invalid UTF-8.
+**/
+vuu::DecodeResult vuu::decode(const char* data, std::size_t len, char32_t* out, std::size_t cap)
+{
+	DecodeResult toReturn = {0, 0, true};
+	const char* end = data + len;
+
+	while (toReturn.nBytes < len && toReturn.nCodepoints < cap)
+	{
+		std::size_t n = decodeNext(data + toReturn.nBytes, end, out[toReturn.nCodepoints]);
+
+		if (n == 0)
+		{
+			toReturn.valid = false;
+			break;
+		}
+
+		toReturn.nBytes += n;
+		++toReturn.nCodepoints;
+	}
+
+	return toReturn;
+}
+
+/**
+* @desc Counts the code points in some UTF-8 bytes, checking that they're valid as it goes.
+* @param data The bytes.
+* @param len The # of bytes.
+* @param n Set to the # of code points, if the bytes are valid UTF-8.
+* @return True if the bytes are valid UTF-8.
+**/
+bool vuu::countCodepoints(const char* data, std::size_t len, std::size_t& n)
+{
+	std::size_t count = 0;
+	const char* end = data + len;
+	char32_t cp;
+
+	for (const char* p = data; p < end; count++)
+	{
+		std::size_t used = decodeNext(p, end, cp);
+
+		if (used == 0)
+		{
+			return false;
+		}
+
+		p += used;
+	}
+
+	n = count;
+	return true;
+}
+
+/**
+* @desc Default constructor. Makes an iterator that's at the end of nothing.
+**/
+vuu::CodepointIterator::CodepointIterator() : pos(nullptr), end(nullptr), cp(0), len(0)
+{
+}
+
+/**
+* @desc Constructor. Decodes the code point at a position.
+* @param pos The position. Must be the start of a code point, or end.
+* @param end The end of the bytes.
+**/
+vuu::CodepointIterator::CodepointIterator(const char* pos, const char* end) : pos(pos), end(end), cp(0), len(0)
+{
+	load();
+}
+
+/**
+* @desc Fetches the current code point.
+* @return The code point, or U+FFFD if the bytes at the current position aren't valid UTF-8.
+**/
+vuu::CodepointIterator::reference vuu::CodepointIterator::operator*() const
+{
+	return cp;
+}
+
+/**
+* @desc Moves to the next code point.
+* @return This.
+**/
+vuu::CodepointIterator& vuu::CodepointIterator::operator++()
+{
+	pos += len;
+	load();
+	return *this;
+}
+
+/**
+* @desc Moves to the next code point.
+* @return A copy of this from before it moved.
+**/
+vuu::CodepointIterator vuu::CodepointIterator::operator++(int)
+{
+	CodepointIterator toReturn(*this);
+	++(*this);
+	return toReturn;
+}
+
+/**
+* @desc Compares two iterators over the same bytes.
+* @param other The other iterator.
+* @return True if they're at the same position.
+**/
+bool vuu::CodepointIterator::operator==(const CodepointIterator& other) const
+{
+	return pos == other.pos;
+}
+
+/**
+* @desc Compares two iterators over the same bytes.
+* @param other The other iterator.
+* @return True if they're at different positions.
+**/
+bool vuu::CodepointIterator::operator!=(const CodepointIterator& other) const
+{
+	return pos != other.pos;
+}
+
+/**
+* @desc Fetches the position of the current code point's first byte.
+* @return The position.
+**/
+const char* vuu::CodepointIterator::position() const
+{
+	return pos;
+}
+
+/**
+* @desc Decodes the code point at pos into cp and len.
+**/
+void vuu::CodepointIterator::load()
+{
+	if (pos >= end) // At the end, so there's nothing to decode
+	{
+		len = 0;
+		return;
+	}
+
+	len = decodeNext(pos, end, cp);
+
+	if (len == 0) // Invalid, so skip just this byte
+	{
+		cp = U'\ufffd';
+		len = 1;
+	}
+}
+
+/**
+* @desc Constructor.
+* @param data The bytes. Must outlive this object and its iterators.
+* @param len The # of bytes.
+**/
+vuu::Codepoints::Codepoints(const char* data, std::size_t len) : first(data), last(data + len)
+{
+}
+
+/**
+* @desc Fetches an iterator at the first code point.
+* @return The iterator.
+**/
+vuu::CodepointIterator vuu::Codepoints::begin() const
+{
+	return CodepointIterator(first, last);
+}
+
+/**
+* @desc Fetches an iterator past the last code point.
+* @return The iterator.
+**/
+vuu::CodepointIterator vuu::Codepoints::end() const
+{
+	return CodepointIterator(last, last);
+}
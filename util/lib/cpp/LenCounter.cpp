@@ -72,12 +72,12 @@ short vuu::LenCounter::getNumCodePoints() const
 **/
 void vuu::LenCounter::operator()(char c)
 {
-	std::bitset<8> charBits(static_cast<unsigned long>(c)); // Convert char to unsigned long so that bitset's constructor can accept it
+	unsigned char b = static_cast<unsigned char>(c); // The byte's bits are tested with masks. std::bitset is only built to print them.
 
 	#ifdef DEBUG	
 	std::cerr << "vuu::LenCounter::operator(): current byte = " << c << std::endl
-	<< "\tBits = " << charBits << std::endl
-	<< "\tByte value as int = " << charBits.to_ulong() << std::endl
+	<< "\tBits = " << std::bitset<8>(b) << std::endl
+	<< "\tByte value as int = " << static_cast<unsigned>(b) << std::endl
 	<< "\tCurrent state = " << static_cast<short>(curStat) << std::endl;
 
 	try
@@ -99,7 +99,7 @@ void vuu::LenCounter::operator()(char c)
 	{
 		case codepoint_start: // Expecting the start of the next code point
 		{
-			if (!charBits.test(7)) // Byte 1: 0xxxxxxx
+			if (b < 0x80) // Byte 1: 0xxxxxxx
 			{
 				#ifdef DEBUG
 				std::cerr << "\tSingle-byte codepoint" << std::endl;
@@ -107,7 +107,7 @@ void vuu::LenCounter::operator()(char c)
 				++ncp; // Single-byte code-point
 			}
 
-			else if (charBits.test(7) && charBits.test(6) && !charBits.test(5)) // Byte 1: 110xxxxx
+			else if ((b & 0xE0) == 0xC0) // Byte 1: 110xxxxx
 			{
 				#ifdef DEBUG
 				std::cerr << "\t2-byte codepoint" << std::endl;
@@ -115,7 +115,7 @@ void vuu::LenCounter::operator()(char c)
 				curStat = twobyte_second; // Waiting for the second byte of a 2-byte code point
 			}
 
-			else if (charBits.test(7) && charBits.test(6) && charBits.test(5) && !charBits.test(4)) // Byte 1: 1110xxxx
+			else if ((b & 0xF0) == 0xE0) // Byte 1: 1110xxxx
 			{
 				#ifdef DEBUG
 				std::cerr << "\t3-byte codepoint" << std::endl;
@@ -123,7 +123,7 @@ void vuu::LenCounter::operator()(char c)
 				curStat = threebyte_second; // Waiting for the second byte of a 3-byte character
 			}
 
-			else if (charBits.test(7) && charBits.test(6) && charBits.test(5) && charBits.test(4) && !charBits.test(3)) // Byte 1: 11110xxx
+			else if ((b & 0xF8) == 0xF0) // Byte 1: 11110xxx
 			{
 				#ifdef DEBUG
 				std::cerr << "\t4-byte codepoint" << std::endl;
@@ -136,7 +136,7 @@ void vuu::LenCounter::operator()(char c)
 
 		case twobyte_second: // Expecting second byte of 2-byte code point
 		{
-			if (charBits.test(7) && !charBits.test(6)) // Second byte should be of the form 10xxxxxx
+			if ((b & 0xC0) == 0x80) // Second byte should be of the form 10xxxxxx
 			{
 				/* Valid 2-byte code point */
 				++ncp;
@@ -149,7 +149,7 @@ void vuu::LenCounter::operator()(char c)
 				etbs << "The second byte of a 2-byte code-point is invalid." << std::endl
 					<< "\tCodepoint # [not including this one = " << ncp << std::endl
 					<< "\t# of bytes processed (not including this one) = " << charPos << std::endl
-					<< "\tThe value of this byte is: " << charBits << std::endl;
+					<< "\tThe value of this byte is: " << std::bitset<8>(b) << std::endl;
 				vuu::InvByteInCodePoint err(etbs.str()); // Construct the error to throw using the generated string as the message
 				throw err; // Throw it to halt execution/be caught
 			}
@@ -159,7 +159,7 @@ void vuu::LenCounter::operator()(char c)
 
 		case threebyte_second: // Expecting the second byte of a 3-byte UTF-8 code point
 		{
-			if (charBits.test(7) && !charBits.test(6)) // Second byte should be of the form 10xxxxxx
+			if ((b & 0xC0) == 0x80) // Second byte should be of the form 10xxxxxx
 			{
 				/* Valid second byte */
 				curStat = threebyte_third; // Need to check the 3rd byte
@@ -171,7 +171,7 @@ void vuu::LenCounter::operator()(char c)
 				etbs << "The second byte of a 3-byte code-point is invalid." << std::endl
 					<< "\tCodepoint # [not including this one = " << ncp << std::endl
 					<< "# of bytes processed (not including this one) = " << charPos << std::endl
-					<< "\tThe value of this byte is: " << charBits << std::endl;
+					<< "\tThe value of this byte is: " << std::bitset<8>(b) << std::endl;
 				vuu::InvByteInCodePoint err(etbs.str()); // Construct the error to throw using the generated string as the message
 				throw err; // Throw it to halt execution/be caught
 			}
@@ -181,7 +181,7 @@ void vuu::LenCounter::operator()(char c)
 
 		case threebyte_third: // Expecting the 3rd byte of a 3-byte UTF-8 code point
 		{
-			if (charBits.test(7) && !charBits.test(6)) // The third byte should be of the form 10xxxxxx
+			if ((b & 0xC0) == 0x80) // The third byte should be of the form 10xxxxxx
 			{
 				/* Valid third byte, thus -> valid code point */
 				++ncp; // Count this code point
@@ -194,7 +194,7 @@ void vuu::LenCounter::operator()(char c)
 				etbs << "The third byte of a 3-byte code-point is invalid." << std::endl
 					<< "\tCodepoint # [not including this one = " << ncp << std::endl
 					<< "# of bytes processed (not including this one) = " << charPos << std::endl
-					<< "\tThe value of this byte is: " << charBits << std::endl;
+					<< "\tThe value of this byte is: " << std::bitset<8>(b) << std::endl;
 				vuu::InvByteInCodePoint err(etbs.str()); // Construct the error to throw using the generated string as the message
 				throw err; // Throw it to halt execution/be caught
 			}
@@ -204,7 +204,7 @@ void vuu::LenCounter::operator()(char c)
 
 		case fourbyte_second:
 		{
-			if (charBits.test(7) && !charBits.test(6)) // The second byte should be of the form 10xxxxxx
+			if ((b & 0xC0) == 0x80) // The second byte should be of the form 10xxxxxx
 			{
 				/* Valid second byte */
 				curStat = fourbyte_third; // Need to check the next byte
@@ -216,7 +216,7 @@ void vuu::LenCounter::operator()(char c)
 				etbs << "The second byte of a 4-byte code-point is invalid." << std::endl
 					<< "\tCodepoint # [not including this one = " << ncp << std::endl
 					<< "# of bytes processed (not including this one) = " << charPos << std::endl
-					<< "\tThe value of this byte is: " << charBits << std::endl;
+					<< "\tThe value of this byte is: " << std::bitset<8>(b) << std::endl;
 				vuu::InvByteInCodePoint err(etbs.str()); // Construct the error to throw using the generated string as the message
 				throw err; // Throw it to halt execution/be caught
 			}
@@ -226,7 +226,7 @@ void vuu::LenCounter::operator()(char c)
 
 		case fourbyte_third:
 		{
-			if (charBits.test(7) && !charBits.test(6)) // The second byte should be of the form 10xxxxxx
+			if ((b & 0xC0) == 0x80) // The second byte should be of the form 10xxxxxx
 			{
 				/* Valid third byte */
 				curStat = fourbyte_fourth; // Need to check the next byte
@@ -238,7 +238,7 @@ void vuu::LenCounter::operator()(char c)
 				etbs << "The third byte of a 4-byte code-point is invalid." << std::endl
 					<< "\tCodepoint # [not including this one = " << ncp << std::endl
 					<< "# of bytes processed (not including this one) = " << charPos << std::endl
-					<< "\tThe value of this byte is: " << charBits << std::endl;
+					<< "\tThe value of this byte is: " << std::bitset<8>(b) << std::endl;
 				vuu::InvByteInCodePoint err(etbs.str()); // Construct the error to throw using the generated string as the message
 				throw err; // Throw it to halt execution/be caught
 			}
@@ -248,7 +248,7 @@ void vuu::LenCounter::operator()(char c)
 
 		case fourbyte_fourth:
 		{
-			if (charBits.test(7) && !charBits.test(6)) // The second byte should be of the form 10xxxxxx
+			if ((b & 0xC0) == 0x80) // The second byte should be of the form 10xxxxxx
 			{
 				/* Valid fourth byte -> valid 4-byte UTF-8 code point*/
 				curStat = codepoint_start; // Need to check the next code point
@@ -261,7 +261,7 @@ void vuu::LenCounter::operator()(char c)
 				etbs << "The fourth byte of a 4-byte code-point is invalid." << std::endl
 					<< "\tCodepoint # [not including this one = " << ncp << std::endl
 					<< "# of bytes processed (not including this one) = " << charPos << std::endl
-					<< "\tThe value of this byte is: " << charBits << std::endl;
+					<< "\tThe value of this byte is: " << std::bitset<8>(b) << std::endl;
 				vuu::InvByteInCodePoint err(etbs.str()); // Construct the error to throw using the generated string as the message
 				throw err; // Throw it to halt execution/be caught
 			}
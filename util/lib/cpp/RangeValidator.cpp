@@ -0,0 +1,170 @@
+/* STL */
+#include <cstddef> // std::size_t
+
+/* Intrinsics */
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // _mm_*, _mm256_*
+#endif
+
+/* Our headers */
+#include "vuu/Codepoints.hpp" // vuu::decodeNext
+#include "vuu/RangeValidator.hpp" // Class def'n
+
+/**
+* @desc Constructor. Creates a validator for the range [minimum, maximum].
+* @param minimum The minimum valid code point.
+* @param maximum The maximum valid code point.
+**/
+vuu::RangeValidator::RangeValidator(char32_t minimum, char32_t maximum) : min(minimum),
+	max(maximum),
+	blockable(
+		minimum >= 0x800 && maximum <= 0xFFFF && minimum <= maximum // 3-byte code points
+		&& (minimum >> 12) == (maximum >> 12) // with the same first byte
+		&& (minimum & 0x3F) == 0 && (maximum & 0x3F) == 0x3F // and whole runs of last bytes, so that the last byte never decides whether or not a code point is in the range
+		&& (maximum < 0xD800 || minimum > 0xDFFF) // and no surrogates, which aren't valid UTF-8
+	),
+	hasAVX2(false),
+	lo(),
+	hi()
+{
+	#if defined(__x86_64__) || defined(__i386__)
+	hasAVX2 = __builtin_cpu_supports("avx2");
+	#endif
+
+	if (blockable)
+	{
+		for (std::size_t i = 0; i < VUU_RANGEBLOCK; i += 3)
+		{
+			lo[i] = hi[i] = static_cast<unsigned char>(0xE0 | (minimum >> 12)); // First byte: 1110xxxx
+			lo[i + 1] = static_cast<unsigned char>(0x80 | ((minimum >> 6) & 0x3F)); // Second byte: 10xxxxxx, from the range's first run of 64 to its last
+			hi[i + 1] = static_cast<unsigned char>(0x80 | ((maximum >> 6) & 0x3F));
+			lo[i + 2] = 0x80; // Last byte: any 10xxxxxx
+			hi[i + 2] = 0xBF;
+		}
+	}
+}
+
+/**
+* @desc Checks a string.
+* @param data The string's bytes.
+* @param len The # of bytes.
+* @return Whether the string is valid UTF-8 with every code point in the range, and if not, what's wrong with the first code point that isn't.
+**/
+vuu::RangeValidator::Result vuu::RangeValidator::operator()(const char* data, std::size_t len) const
+{
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+	const unsigned char* end = p + len;
+
+	if (blockable) // Skip the blocks that are certainly fine. A block that isn't is left for scalar(), which works out what's wrong with it.
+	{
+		p = (hasAVX2 ? blocksAVX2(p, end) : blocksSSE2(p, end));
+	}
+
+	return scalar(p, end);
+}
+
+/**
+* @desc Decodes and checks a string one code point at a time.
+* @param p The first byte to check. Must be the start of a code point.
+* @param end The end of the string.
+* @return Whether the bytes are valid UTF-8 with every code point in the range, and if not, what's wrong with the first code point that isn't.
+**/
+vuu::RangeValidator::Result vuu::RangeValidator::scalar(const unsigned char* p, const unsigned char* end) const
+{
+	const char* pos = reinterpret_cast<const char*>(p);
+	const char* stop = reinterpret_cast<const char*>(end);
+	while (pos < stop)
+	{
+		char32_t cp;
+		std::size_t n = decodeNext(pos, stop, cp);
+
+		if (n == 0)
+		{
+			return InvalidUTF8;
+		}
+
+		if (cp < min || cp > max)
+		{
+			return OutOfRange;
+		}
+
+		pos += n;
+	}
+
+	return Valid;
+}
+
+/**
+* @desc Checks as many whole blocks of VUU_RANGEBLOCK bytes as pass, 16 bytes at a time.
+* @param p The first byte to check.
+* @param end The end of the string.
+* @return The first byte that wasn't checked.
+**/
+const unsigned char* vuu::RangeValidator::blocksSSE2(const unsigned char* p, const unsigned char* end) const
+{
+	#ifdef __SSE2__
+	const std::size_t period = 48; // 3 registers hold 16 whole code points
+
+	while (static_cast<std::size_t>(end - p) >= period)
+	{
+		__m128i bad = _mm_setzero_si128(); // 0xFF in each byte that's out of its range
+
+		for (std::size_t i = 0; i < period; i += 16)
+		{
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+			__m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo.data() + i));
+			__m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi.data() + i));
+			__m128i clamped = _mm_min_epu8(_mm_max_epu8(x, l), h); // Unchanged if and only if lo <= x <= hi
+			bad = _mm_or_si128(bad, _mm_xor_si128(_mm_cmpeq_epi8(clamped, x), _mm_set1_epi8(-1)));
+		}
+
+		if (_mm_movemask_epi8(bad) != 0)
+		{
+			break;
+		}
+
+		p += period;
+	}
+	#endif
+
+	return p;
+}
+
+/**
+* @desc Checks as many whole blocks of VUU_RANGEBLOCK bytes as pass, 32 bytes at a time. Only called if the CPU has AVX2.
+* @param p The first byte to check.
+* @param end The end of the string.
+* @return The first byte that wasn't checked.
+**/
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+#endif
+const unsigned char* vuu::RangeValidator::blocksAVX2(const unsigned char* p, const unsigned char* end) const
+{
+	#if defined(__x86_64__) || defined(__i386__)
+	while (static_cast<std::size_t>(end - p) >= VUU_RANGEBLOCK)
+	{
+		__m256i bad = _mm256_setzero_si256();
+
+		for (std::size_t i = 0; i < VUU_RANGEBLOCK; i += 32)
+		{
+			__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+			__m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo.data() + i));
+			__m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi.data() + i));
+			__m256i clamped = _mm256_min_epu8(_mm256_max_epu8(x, l), h);
+			bad = _mm256_or_si256(bad, _mm256_xor_si256(_mm256_cmpeq_epi8(clamped, x), _mm256_set1_epi8(-1)));
+		}
+
+		if (_mm256_movemask_epi8(bad) != 0)
+		{
+			break;
+		}
+
+		p += VUU_RANGEBLOCK;
+	}
+
+	_mm256_zeroupper(); // The compiler doesn't do this before a tail call, and SSE code after AVX code that left the upper halves dirty is very slow
+	#endif
+
+	return blocksSSE2(p, end); // The rest may still hold a 48-byte block
+}
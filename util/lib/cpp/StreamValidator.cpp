@@ -0,0 +1,145 @@
+/* STL */
+#include <cstddef> // std::size_t
+
+/* Our headers */
+#include "vuu/StreamValidator.hpp" // Class def'n
+
+namespace
+{
+	/**
+	* @desc Works out how long a code point is from its first byte.
+	* @param lead The first byte.
+	* @return The # of bytes, or 0 if lead can't start a code point.
+	**/
+	std::size_t seqLen(unsigned char lead)
+	{
+		if (lead < 0x80) // 0xxxxxxx
+		{
+			return 1;
+		}
+
+		else if ((lead & 0xE0) == 0xC0) // 110xxxxx
+		{
+			return 2;
+		}
+
+		else if ((lead & 0xF0) == 0xE0) // 1110xxxx
+		{
+			return 3;
+		}
+
+		else if ((lead & 0xF8) == 0xF0) // 11110xxx
+		{
+			return 4;
+		}
+
+		return 0;
+	}
+
+	/**
+	* @desc Finds where the last whole code point in a chunk ends.
+	* @param p The chunk's first byte.
+	* @param end The end of the chunk.
+	* @return The first byte of a code point that's cut off by the end of the chunk, or end if there isn't one.
+	**/
+	const unsigned char* wholeEnd(const unsigned char* p, const unsigned char* end)
+	{
+		for (const unsigned char* q = end; q > p && end - q < 4;)
+		{
+			--q;
+
+			if ((*q & 0xC0) != 0x80) // The last first byte. Anything wrong with it is left for the validator.
+			{
+				std::size_t n = seqLen(*q);
+				return (n > static_cast<std::size_t>(end - q) ? q : end);
+			}
+		}
+
+		return end;
+	}
+}
+
+/**
+* @desc Constructor. Creates a validator for the range [minimum, maximum], ready for the start of a string.
+* @param minimum The minimum valid code point.
+* @param maximum The maximum valid code point.
+**/
+vuu::StreamValidator::StreamValidator(char32_t minimum, char32_t maximum) : check(minimum, maximum),
+	verdict(RangeValidator::Valid),
+	pending(),
+	nPending(0),
+	nNeeded(0)
+{
+}
+
+/**
+* @desc Checks the next chunk of the string.
+* @param data The chunk's bytes. They needn't start or end on a code point boundary.
+* @param len The # of bytes.
+* @return InvalidUTF8 or OutOfRange if a code point that's been fed so far is, or Valid if they've all been fine.
+**/
+vuu::RangeValidator::Result vuu::StreamValidator::feed(const char* data, std::size_t len)
+{
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+	const unsigned char* end = p + len;
+
+	/* Finish off a code point that the last chunk started */
+	while (verdict == RangeValidator::Valid && nPending > 0 && p < end)
+	{
+		if ((*p & 0xC0) != 0x80) // Not 10xxxxxx, so the code point can't be finished
+		{
+			verdict = RangeValidator::InvalidUTF8;
+		}
+
+		else
+		{
+			pending[nPending++] = *p++;
+
+			if (nPending == nNeeded)
+			{
+				verdict = check(reinterpret_cast<const char*>(pending), nNeeded); // Still catches overlong sequences, surrogates, and code points outside the range
+				nPending = 0;
+			}
+		}
+	}
+
+	if (verdict != RangeValidator::Valid || p == end)
+	{
+		return verdict;
+	}
+
+	/* Check the whole code points where they are, and hold onto any that the chunk cuts off */
+	const unsigned char* split = wholeEnd(p, end);
+	verdict = check(reinterpret_cast<const char*>(p), split - p);
+
+	if (verdict == RangeValidator::Valid && split != end)
+	{
+		nNeeded = seqLen(*split);
+
+		for (nPending = 0; split < end; split++)
+		{
+			pending[nPending++] = *split;
+		}
+	}
+
+	return verdict;
+}
+
+/**
+* @desc Fetches the result for the whole string, if it ends where the last chunk did.
+* @return The result so far, or InvalidUTF8 if the string ends part-way through a code point.
+**/
+vuu::RangeValidator::Result vuu::StreamValidator::finish() const
+{
+	return (verdict == RangeValidator::Valid && nPending > 0 ? RangeValidator::InvalidUTF8 : verdict);
+}
+
+/**
+* @desc Forgets the string, ready for the start of another one.
+**/
+void vuu::StreamValidator::reset()
+{
+	verdict = RangeValidator::Valid;
+	nPending = 0;
+	nNeeded = 0;
+}
@@ -0,0 +1,155 @@
+#ifndef VUU_CODEPOINTS_HPP
+#define VUU_CODEPOINTS_HPP
+
+/* STL */
+#include <cstddef> // std::size_t, std::ptrdiff_t
+#include <iterator> // std::forward_iterator_tag
+
+namespace vuu
+{
+	/**
+	* @desc Decodes the code point at the start of some UTF-8 bytes, with shifts and masks.
+	* @param p The first byte.
+	* @param end The end of the bytes. Must be after p.
+	* @param cp Set to the code point, if it's valid.
+	* @return The # of bytes in the code point, or 0 if they aren't valid UTF-8 (a stray continuation byte, a truncated or overlong sequence, a surrogate, or past U+10FFFF).
+	**/
+	std::size_t decodeNext(const char* p, const char* end, char32_t& cp);
+
+	/**
+	* @desc What decode() did.
+	**/
+	struct DecodeResult
+	{
+		std::size_t nCodepoints; // # of code points written to the buffer
+		std::size_t nBytes; // # of bytes that they took up. Less than the input's length if the buffer filled up, or if the input is invalid.
+		bool valid; // False if decoding stopped at invalid UTF-8
+	};
+
+	/**
+	* @desc Decodes UTF-8 into a buffer that the caller owns. Nothing is allocated.
+	* @param data The bytes.
+	* @param len The # of bytes.
+	* @param out The buffer.
+	* @param cap The # of code points that the buffer holds. Decoding stops once it's full, and can be continued from data + nBytes.
+	* @return How many code points and bytes were decoded, and whether decoding stopped at invalid UTF-8.
+	**/
+	DecodeResult decode(const char* data, std::size_t len, char32_t* out, std::size_t cap);
+
+	/**
+	* @desc Counts the code points in some UTF-8 bytes, checking that they're valid as it goes.
+	* @param data The bytes.
+	* @param len The # of bytes.
+	* @param n Set to the # of code points, if the bytes are valid UTF-8.
+	* @return True if the bytes are valid UTF-8.
+	**/
+	bool countCodepoints(const char* data, std::size_t len, std::size_t& n);
+
+	/**
+	* @desc Walks through the code points in some UTF-8 bytes, decoding each one as it's reached. Nothing is allocated.
+	*	An invalid sequence is read as U+FFFD, one byte at a time, so that iteration always ends.
+	**/
+	class CodepointIterator
+	{
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef char32_t value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const char32_t* pointer;
+			typedef const char32_t& reference;
+
+			/**
+			* @desc Default constructor. Makes an iterator that's at the end of nothing.
+			**/
+			CodepointIterator();
+
+			/**
+			* @desc Constructor. Decodes the code point at a position.
+			* @param pos The position. Must be the start of a code point, or end.
+			* @param end The end of the bytes.
+			**/
+			CodepointIterator(const char* pos, const char* end);
+
+			/**
+			* @desc Fetches the current code point.
+			* @return The code point, or U+FFFD if the bytes at the current position aren't valid UTF-8.
+			**/
+			reference operator*() const;
+
+			/**
+			* @desc Moves to the next code point.
+			* @return This.
+			**/
+			CodepointIterator& operator++();
+
+			/**
+			* @desc Moves to the next code point.
+			* @return A copy of this from before it moved.
+			**/
+			CodepointIterator operator++(int);
+
+			/**
+			* @desc Compares two iterators over the same bytes.
+			* @param other The other iterator.
+			* @return True if they're at the same position.
+			**/
+			bool operator==(const CodepointIterator& other) const;
+
+			/**
+			* @desc Compares two iterators over the same bytes.
+			* @param other The other iterator.
+			* @return True if they're at different positions.
+			**/
+			bool operator!=(const CodepointIterator& other) const;
+
+			/**
+			* @desc Fetches the position of the current code point's first byte.
+			* @return The position.
+			**/
+			const char* position() const;
+
+		private:
+			/**
+			* @desc Decodes the code point at pos into cp and len.
+			**/
+			void load();
+
+			const char* pos; // The current code point's first byte
+			const char* end; // The end of the bytes
+			char32_t cp; // The current code point
+			std::size_t len; // # of bytes in the current code point
+	};
+
+	/**
+	* @desc The code points in some UTF-8 bytes, as a range that can be given to a range-based for or an algorithm. The bytes aren't copied.
+	* @usage bool allMalayalam = std::all_of(cps.begin(), cps.end(), vuu::CodepointsInRange(0x0D00, 0x0D7F));
+	**/
+	class Codepoints
+	{
+		public:
+			/**
+			* @desc Constructor.
+			* @param data The bytes. Must outlive this object and its iterators.
+			* @param len The # of bytes.
+			**/
+			Codepoints(const char* data, std::size_t len);
+
+			/**
+			* @desc Fetches an iterator at the first code point.
+			* @return The iterator.
+			**/
+			CodepointIterator begin() const;
+
+			/**
+			* @desc Fetches an iterator past the last code point.
+			* @return The iterator.
+			**/
+			CodepointIterator end() const;
+
+		private:
+			const char* first; // The first byte
+			const char* last; // Past the last byte
+	};
+}
+
+#endif // VUU_CODEPOINTS_HPP
@@ -0,0 +1,76 @@
+#ifndef VUU_RANGEVALIDATOR_HPP
+#define VUU_RANGEVALIDATOR_HPP
+
+/* STL */
+#include <cstddef> // std::size_t
+#include <array> // std::array
+
+// The # of bytes that the vector kernels check at once: 3 code points' worth of 32-byte registers, so that every register lines up with the same byte of a code point each time
+#define VUU_RANGEBLOCK 96
+
+namespace vuu
+{
+	/**
+	* @desc Checks, in one pass, that a string is valid UTF-8 and that every code point in it is in a range.
+	*	If the range is one whose code points are all 3 bytes long with the same first byte, e.g. a 128-code point block like Malayalam's, every valid string is the same 3-byte pattern repeated, so the string is checked 96 bytes at a time with AVX2 if the CPU has it, or 48 at a time with SSE2 otherwise.
+	*	Anything that the vector check doesn't pass, and every other range, is decoded with shifts and masks, one code point at a time.
+	* @usage vuu::RangeValidator::Result res = vuu::RangeValidator(0x0D00, 0x0D7F)(str.data(), str.size());
+	**/
+	class RangeValidator
+	{
+		public:
+			enum Result
+			{
+				Valid, // Valid UTF-8, and every code point is in the range
+				InvalidUTF8, // The first bad code point isn't valid UTF-8
+				OutOfRange // The first bad code point is valid UTF-8, but out of the range
+			};
+
+			/**
+			* @desc Constructor. Creates a validator for the range [minimum, maximum].
+			* @param minimum The minimum valid code point.
+			* @param maximum The maximum valid code point.
+			**/
+			RangeValidator(char32_t minimum, char32_t maximum);
+
+			/**
+			* @desc Checks a string.
+			* @param data The string's bytes.
+			* @param len The # of bytes.
+			* @return Whether the string is valid UTF-8 with every code point in the range, and if not, what's wrong with the first code point that isn't.
+			**/
+			Result operator()(const char* data, std::size_t len) const;
+
+		private:
+			/**
+			* @desc Decodes and checks a string one code point at a time.
+			* @param p The first byte to check. Must be the start of a code point.
+			* @param end The end of the string.
+			* @return Whether the bytes are valid UTF-8 with every code point in the range, and if not, what's wrong with the first code point that isn't.
+			**/
+			Result scalar(const unsigned char* p, const unsigned char* end) const;
+
+			/**
+			* @desc Checks as many whole blocks of VUU_RANGEBLOCK bytes as pass, 16 bytes at a time.
+			* @param p The first byte to check.
+			* @param end The end of the string.
+			* @return The first byte that wasn't checked.
+			**/
+			const unsigned char* blocksSSE2(const unsigned char* p, const unsigned char* end) const;
+
+			/**
+			* @desc Checks as many whole blocks of VUU_RANGEBLOCK bytes as pass, 32 bytes at a time. Only called if the CPU has AVX2.
+			* @param p The first byte to check.
+			* @param end The end of the string.
+			* @return The first byte that wasn't checked.
+			**/
+			const unsigned char* blocksAVX2(const unsigned char* p, const unsigned char* end) const;
+
+			char32_t min, max; // The range
+			bool blockable; // Whether or not every code point in the range is 3 bytes long, with the same first byte, so that the vector kernels apply
+			bool hasAVX2; // Whether or not the CPU has AVX2
+			std::array<unsigned char, VUU_RANGEBLOCK> lo, hi; // The smallest and largest valid value of each byte in a block. The block is whole code points, so these repeat every 3 bytes.
+	};
+}
+
+#endif // VUU_RANGEVALIDATOR_HPP
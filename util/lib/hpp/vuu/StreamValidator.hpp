@@ -0,0 +1,56 @@
+#ifndef VUU_STREAMVALIDATOR_HPP
+#define VUU_STREAMVALIDATOR_HPP
+
+/* STL */
+#include <cstddef> // std::size_t
+
+/* Our headers */
+#include "vuu/RangeValidator.hpp" // vuu::RangeValidator, which checks each chunk
+
+namespace vuu
+{
+	/**
+	* @desc Checks a string that arrives in chunks, as vuu::RangeValidator checks a whole one, without keeping the chunks.
+	*	A code point may be split across chunks. Its first bytes are held until the rest arrive, and every other byte is checked as soon as it's fed.
+	*	Once a code point is invalid or out of the range, the result sticks until reset() is called, so a caller can give up on the string straight away.
+	* @usage vuu::StreamValidator sv(0x0D00, 0x0D7F); sv.feed(first, nFirst); sv.feed(second, nSecond); bool ok = (sv.finish() == vuu::RangeValidator::Valid);
+	**/
+	class StreamValidator
+	{
+		public:
+			/**
+			* @desc Constructor. Creates a validator for the range [minimum, maximum], ready for the start of a string.
+			* @param minimum The minimum valid code point.
+			* @param maximum The maximum valid code point.
+			**/
+			StreamValidator(char32_t minimum, char32_t maximum);
+
+			/**
+			* @desc Checks the next chunk of the string.
+			* @param data The chunk's bytes. They needn't start or end on a code point boundary.
+			* @param len The # of bytes.
+			* @return InvalidUTF8 or OutOfRange if a code point that's been fed so far is, or Valid if they've all been fine.
+			**/
+			RangeValidator::Result feed(const char* data, std::size_t len);
+
+			/**
+			* @desc Fetches the result for the whole string, if it ends where the last chunk did.
+			* @return The result so far, or InvalidUTF8 if the string ends part-way through a code point.
+			**/
+			RangeValidator::Result finish() const;
+
+			/**
+			* @desc Forgets the string, ready for the start of another one.
+			**/
+			void reset();
+
+		private:
+			RangeValidator check; // Checks the whole code points
+			RangeValidator::Result verdict; // The result so far
+			unsigned char pending[4]; // The first bytes of a code point that was split across chunks
+			std::size_t nPending; // # of bytes in pending
+			std::size_t nNeeded; // # of bytes in the code point that pending starts
+	};
+}
+
+#endif // VUU_STREAMVALIDATOR_HPP